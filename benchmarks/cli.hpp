@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace qanneal::bench {
+
+// Splits a comma-separated option value, dropping empty parts.
+inline std::vector<std::string> split(const std::string &text) {
+    std::vector<std::string> parts;
+    std::stringstream in(text);
+    std::string part;
+    while (std::getline(in, part, ',')) {
+        if (!part.empty()) {
+            parts.push_back(part);
+        }
+    }
+    return parts;
+}
+
+inline std::vector<std::size_t> split_sizes(const std::string &text) {
+    std::vector<std::size_t> values;
+    for (const auto &part : split(text)) {
+        values.push_back(static_cast<std::size_t>(std::stoull(part)));
+    }
+    return values;
+}
+
+inline std::vector<double> split_doubles(const std::string &text) {
+    std::vector<double> values;
+    for (const auto &part : split(text)) {
+        values.push_back(std::stod(part));
+    }
+    return values;
+}
+
+} // namespace qanneal::bench
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace qanneal::bench {
+
+// Minimal streaming JSON writer for benchmark reports. Non-finite numbers
+// are written as null.
+class JsonWriter {
+public:
+    explicit JsonWriter(std::ostream &out) : out_(out) {
+        out_ << std::setprecision(10);
+    }
+
+    void begin_object() { open('{'); }
+    void end_object() { close('}'); }
+    void begin_array() { open('['); }
+    void end_array() { close(']'); }
+
+    void key(const std::string &name) {
+        separate();
+        write_string(name);
+        out_ << ':';
+        after_key_ = true;
+    }
+
+    void value(double v) {
+        separate();
+        if (std::isfinite(v)) {
+            out_ << v;
+        } else {
+            out_ << "null";
+        }
+    }
+    void value(std::size_t v) { separate(); out_ << v; }
+    void value(bool v) { separate(); out_ << (v ? "true" : "false"); }
+    void value(const std::string &v) { separate(); write_string(v); }
+    void value(const char *v) { value(std::string(v)); }
+
+    template <class T>
+    void field(const std::string &name, const T &v) {
+        key(name);
+        value(v);
+    }
+
+    void field(const std::string &name, const std::vector<double> &values) {
+        key(name);
+        begin_array();
+        for (double v : values) {
+            value(v);
+        }
+        end_array();
+    }
+
+    void finish() { out_ << '\n'; }
+
+private:
+    std::ostream &out_;
+    std::vector<bool> first_;
+    bool after_key_ = false;
+
+    void separate() {
+        if (after_key_) {
+            after_key_ = false;
+            return;
+        }
+        if (!first_.empty()) {
+            if (!first_.back()) {
+                out_ << ',';
+            }
+            first_.back() = false;
+        }
+    }
+
+    void open(char c) {
+        separate();
+        out_ << c;
+        first_.push_back(true);
+    }
+
+    void close(char c) {
+        first_.pop_back();
+        out_ << c;
+    }
+
+    void write_string(const std::string &s) {
+        out_ << '"';
+        for (char c : s) {
+            switch (c) {
+            case '"':
+                out_ << "\\\"";
+                break;
+            case '\\':
+                out_ << "\\\\";
+                break;
+            case '\n':
+                out_ << "\\n";
+                break;
+            default:
+                out_ << c;
+            }
+        }
+        out_ << '"';
+    }
+};
+
+} // namespace qanneal::bench
@@ -0,0 +1,399 @@
+// Microbenchmarks for the Hamiltonian kernels.
+//
+// For every size and coupling density the harness times DenseIsing and
+// SparseIsing delta_energy over all spins, energy, Metropolis sweeps (the
+// loop Annealer runs, on a prepared state), and QUBO::to_ising. Each kernel
+// reports ns per spin update, spin updates per second and GB/s. The byte
+// counts are the compulsory traffic of each kernel (every coefficient it
+// must read or write once), so GB/s is a lower bound on the memory
+// bandwidth it needs. With --perf, Linux hardware counters add cycles,
+// instructions, LLC misses and branch misses per spin update, which tell
+// memory-bound kernels from compute-bound ones. Output is JSON, meant to be diffed between commits.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "cli.hpp"
+#include "json_writer.hpp"
+#include "qanneal/dense_ising.hpp"
+#include "qanneal/perf_counters.hpp"
+#include "qanneal/qubo.hpp"
+#include "qanneal/schedule.hpp"
+#include "qanneal/sparse_ising.hpp"
+
+namespace {
+
+using qanneal::bench::JsonWriter;
+using qanneal::bench::split;
+using qanneal::bench::split_doubles;
+using qanneal::bench::split_sizes;
+
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+    std::vector<std::size_t> sizes = {64, 256, 1024, 2048};
+    std::vector<double> densities = {0.01, 0.1, 1.0};
+    std::vector<std::string> kernels = {"dense_delta_energy", "sparse_delta_energy", "dense_energy",
+                                        "sparse_energy", "dense_sweep", "sparse_sweep", "qubo_to_ising"};
+    double min_time = 0.1;
+    std::size_t repeats = 5;
+    std::size_t sweeps = 16;
+    std::uint64_t seed = 1;
+    bool perf = false;
+    std::string output;
+};
+
+struct Problem {
+    qanneal::DenseIsing dense;
+    qanneal::SparseIsing sparse;
+    qanneal::QUBO qubo;
+    std::size_t edges = 0;
+};
+
+// Per-call cost model of one kernel.
+struct Work {
+    double spin_updates = 0.0;
+    double bytes = 0.0;
+};
+
+struct Measurement {
+    std::size_t calls = 0;
+    double seconds_per_call = 0.0;      // median over repeats
+    double min_seconds_per_call = 0.0;
+    qanneal::PerfCounts events;         // summed over every timed call
+};
+
+void usage() {
+    std::cerr
+        << "usage: qanneal_bench [options]\n"
+        << "  --sizes 64,256,1024,2048  spin counts\n"
+        << "  --densities 0.01,0.1,1    fraction of non-zero couplings\n"
+        << "  --kernels LIST            subset of dense_delta_energy, sparse_delta_energy,\n"
+        << "                            dense_energy, sparse_energy, dense_sweep,\n"
+        << "                            sparse_sweep, qubo_to_ising\n"
+        << "  --min-time S              seconds per repeat (default 0.1)\n"
+        << "  --repeats N               timed repeats, the median is reported (default 5)\n"
+        << "  --sweeps N                sweeps per sweep-kernel call (default 16)\n"
+        << "  --seed N                  instance seed (default 1)\n"
+        << "  --perf                    record hardware counters (Linux perf_event_open)\n"
+        << "  --output FILE             write JSON here instead of stdout\n";
+}
+
+Options parse(int argc, char **argv) {
+    Options options;
+    for (int a = 1; a < argc; ++a) {
+        const std::string arg = argv[a];
+        auto next = [&]() -> std::string {
+            if (a + 1 >= argc) {
+                throw std::invalid_argument("Missing value for " + arg);
+            }
+            return argv[++a];
+        };
+        if (arg == "--sizes") {
+            options.sizes = split_sizes(next());
+        } else if (arg == "--densities") {
+            options.densities = split_doubles(next());
+        } else if (arg == "--kernels") {
+            options.kernels = split(next());
+        } else if (arg == "--min-time") {
+            options.min_time = std::stod(next());
+        } else if (arg == "--repeats") {
+            options.repeats = std::stoull(next());
+        } else if (arg == "--sweeps") {
+            options.sweeps = std::stoull(next());
+        } else if (arg == "--seed") {
+            options.seed = std::stoull(next());
+        } else if (arg == "--perf") {
+            options.perf = true;
+        } else if (arg == "--output") {
+            options.output = next();
+        } else if (arg == "--help" || arg == "-h") {
+            usage();
+            std::exit(0);
+        } else {
+            throw std::invalid_argument("Unknown option " + arg);
+        }
+    }
+    if (options.repeats == 0 || options.sweeps == 0) {
+        throw std::invalid_argument("--repeats and --sweeps must be > 0.");
+    }
+    for (double density : options.densities) {
+        if (!(density > 0.0 && density <= 1.0)) {
+            throw std::invalid_argument("Densities must be in (0, 1].");
+        }
+    }
+    return options;
+}
+
+// Gaussian couplings on a random subset of pairs; the dense, sparse and QUBO
+// forms hold the same coefficients.
+Problem generate(std::size_t n, double density, std::mt19937_64 &gen) {
+    std::normal_distribution<double> normal(0.0, 1.0);
+    std::bernoulli_distribution keep(density);
+    std::vector<double> h(n);
+    std::vector<double> J(n * n, 0.0);
+    std::vector<double> q(n * n, 0.0);
+    std::vector<qanneal::SparseEdge> edges;
+    for (std::size_t i = 0; i < n; ++i) {
+        h[i] = 0.1 * normal(gen);
+        q[i * n + i] = h[i];
+        for (std::size_t j = i + 1; j < n; ++j) {
+            if (!keep(gen)) {
+                continue;
+            }
+            const double value = normal(gen);
+            J[i * n + j] = J[j * n + i] = value;
+            q[i * n + j] = value;
+            edges.push_back({i, j, value});
+        }
+    }
+    const std::size_t count = edges.size();
+    return {qanneal::DenseIsing(h, std::move(J), n),
+            qanneal::SparseIsing(std::move(h), std::move(edges), n),
+            qanneal::QUBO(std::move(q), n),
+            count};
+}
+
+// Repeats `call` until min_time has passed, `repeats` times, and keeps the
+// median time per call.
+template <class Call>
+Measurement measure(Call &&call, const Options &options, const qanneal::PerfCounters *perf) {
+    call();  // warm caches and lazily grown buffers
+    std::vector<double> per_call;
+    std::size_t total_calls = 0;
+    const qanneal::PerfCounts before = perf ? perf->read() : qanneal::PerfCounts{};
+    for (std::size_t r = 0; r < options.repeats; ++r) {
+        std::size_t calls = 0;
+        const auto start = Clock::now();
+        double elapsed = 0.0;
+        do {
+            call();
+            ++calls;
+            elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+        } while (elapsed < options.min_time);
+        per_call.push_back(elapsed / static_cast<double>(calls));
+        total_calls += calls;
+    }
+    Measurement m;
+    if (perf) {
+        m.events = qanneal::PerfCounters::difference(perf->read(), before);
+    }
+    std::sort(per_call.begin(), per_call.end());
+    m.calls = total_calls;
+    m.seconds_per_call = per_call[per_call.size() / 2];
+    m.min_seconds_per_call = per_call.front();
+    return m;
+}
+
+double dense_row_bytes(std::size_t n) {
+    // One J row, the spins and the field.
+    return 8.0 * static_cast<double>(n) + static_cast<double>(n) + 8.0;
+}
+
+double sparse_delta_bytes(const Problem &p) {
+    // Every spin walks its adjacency list (index + weight) and reads the
+    // neighbours' spins; each edge appears in two lists.
+    const double n = static_cast<double>(p.dense.size());
+    return 2.0 * static_cast<double>(p.edges) * (16.0 + 1.0) + 9.0 * n;
+}
+
+volatile double sink = 0.0;
+
+void write_events(JsonWriter &json, const qanneal::PerfCounts &events, double spin_updates) {
+    auto per_update = [&](std::int64_t count) {
+        return count < 0 ? std::nan("") : static_cast<double>(count) / spin_updates;
+    };
+    json.key("hardware");
+    json.begin_object();
+    json.field("cycles_per_spin_update", per_update(events.cycles));
+    json.field("instructions_per_spin_update", per_update(events.instructions));
+    json.field("llc_misses_per_spin_update", per_update(events.llc_misses));
+    json.field("branch_misses_per_spin_update", per_update(events.branch_misses));
+    const bool ipc = events.cycles > 0 && events.instructions >= 0;
+    json.field("ipc", ipc ? static_cast<double>(events.instructions) / static_cast<double>(events.cycles)
+                          : std::nan(""));
+    json.end_object();
+}
+
+void run_kernel(const std::string &kernel,
+                const Problem &problem,
+                double density,
+                const Options &options,
+                const qanneal::PerfCounters *perf,
+                JsonWriter &json) {
+    const std::size_t n = problem.dense.size();
+    const double dn = static_cast<double>(n);
+    std::mt19937_64 gen(options.seed);
+    qanneal::State state(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        state[i] = (gen() & 1U) ? 1 : -1;
+    }
+    const int8_t *spins = state.spins.data();
+
+    Work work;
+    Measurement m;
+    double accepted_per_call = -1.0;
+
+    auto sweep = [&](const qanneal::Hamiltonian &ham) {
+        // A constant beta in the middle of the estimated range keeps the
+        // acceptance rate representative of the bulk of an anneal.
+        const auto range = qanneal::estimate_beta_range(ham);
+        const double beta = std::sqrt(range.beta_min * range.beta_max);
+        // Annealer's Metropolis loop on a prepared state, so that its setup
+        // (random start, full energy, result buffers) is not charged to
+        // the spin updates. The state carries over from call to call.
+        qanneal::State current = state;
+        std::uniform_real_distribution<double> uniform(0.0, 1.0);
+        double accepted = 0.0;
+        std::size_t runs = 0;
+        m = measure([&] {
+            std::size_t flips = 0;
+            for (std::size_t sweep = 0; sweep < options.sweeps; ++sweep) {
+                for (std::size_t i = 0; i < n; ++i) {
+                    const double delta = ham.delta_energy(current.spins.data(), n, i);
+                    if (delta <= 0.0 || uniform(gen) < std::exp(-beta * delta)) {
+                        current[i] = static_cast<int8_t>(-current[i]);
+                        ++flips;
+                    }
+                }
+            }
+            accepted += static_cast<double>(flips);
+            ++runs;
+        }, options, perf);
+        accepted_per_call = accepted / static_cast<double>(runs);
+        work.spin_updates = dn * static_cast<double>(options.sweeps);
+    };
+
+    if (kernel == "dense_delta_energy") {
+        m = measure([&] {
+            double acc = 0.0;
+            for (std::size_t i = 0; i < n; ++i) {
+                acc += problem.dense.delta_energy(spins, n, i);
+            }
+            sink = acc;
+        }, options, perf);
+        work = {dn, dn * dense_row_bytes(n)};
+    } else if (kernel == "sparse_delta_energy") {
+        m = measure([&] {
+            double acc = 0.0;
+            for (std::size_t i = 0; i < n; ++i) {
+                acc += problem.sparse.delta_energy(spins, n, i);
+            }
+            sink = acc;
+        }, options, perf);
+        work = {dn, sparse_delta_bytes(problem)};
+    } else if (kernel == "dense_energy") {
+        m = measure([&] { sink = problem.dense.energy(spins, n); }, options, perf);
+        // Fields, spins and the upper triangle of J.
+        work = {dn, 9.0 * dn + 4.0 * dn * (dn - 1.0)};
+    } else if (kernel == "sparse_energy") {
+        m = measure([&] { sink = problem.sparse.energy(spins, n); }, options, perf);
+        // Fields, spins and each edge (two indices and a weight) once.
+        work = {dn, 9.0 * dn + 24.0 * static_cast<double>(problem.edges)};
+    } else if (kernel == "dense_sweep") {
+        sweep(problem.dense);
+        work.bytes = work.spin_updates * dense_row_bytes(n);
+    } else if (kernel == "sparse_sweep") {
+        sweep(problem.sparse);
+        work.bytes = static_cast<double>(options.sweeps) * sparse_delta_bytes(problem);
+    } else if (kernel == "qubo_to_ising") {
+        m = measure([&] {
+            const auto ising = problem.qubo.to_ising();
+            sink = ising.constant();
+        }, options, perf);
+        // Read Q, write h and J.
+        work = {dn, 16.0 * dn * dn + 8.0 * dn};
+    } else {
+        throw std::invalid_argument("Unknown kernel " + kernel);
+    }
+
+    const double seconds = m.seconds_per_call;
+    json.begin_object();
+    json.field("kernel", kernel);
+    json.field("spins", n);
+    json.field("density", density);
+    json.field("couplings", problem.edges);
+    json.field("calls", m.calls);
+    json.field("seconds_per_call", seconds);
+    json.field("min_seconds_per_call", m.min_seconds_per_call);
+    json.field("ns_per_spin_update", seconds * 1e9 / work.spin_updates);
+    json.field("spin_updates_per_second", work.spin_updates / seconds);
+    json.field("gb_per_second", work.bytes / seconds * 1e-9);
+    if (accepted_per_call >= 0.0) {
+        json.field("acceptance", accepted_per_call / work.spin_updates);
+        json.field("spin_flips_per_second", accepted_per_call / seconds);
+    }
+    if (perf) {
+        write_events(json, m.events, work.spin_updates * static_cast<double>(m.calls));
+    }
+    json.end_object();
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    Options options;
+    try {
+        options = parse(argc, argv);
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << "\n";
+        usage();
+        return 2;
+    }
+
+    std::ofstream file;
+    if (!options.output.empty()) {
+        file.open(options.output);
+        if (!file) {
+            std::cerr << "Cannot open " << options.output << "\n";
+            return 1;
+        }
+    }
+    JsonWriter json(options.output.empty() ? std::cout : file);
+    json.begin_object();
+    json.field("benchmark", "qanneal_bench");
+    json.field("min_time", options.min_time);
+    json.field("repeats", options.repeats);
+    json.field("sweeps_per_call", options.sweeps);
+    json.field("seed", static_cast<std::size_t>(options.seed));
+    // Opened once on this thread; every kernel runs here.
+    std::unique_ptr<qanneal::PerfCounters> perf;
+    if (options.perf) {
+        perf = std::make_unique<qanneal::PerfCounters>();
+        json.field("perf_status", perf->status());
+        if (!perf->available()) {
+            perf.reset();
+        }
+    }
+
+    json.key("results");
+    json.begin_array();
+    std::mt19937_64 gen(options.seed);
+    try {
+        for (std::size_t n : options.sizes) {
+            for (double density : options.densities) {
+                const Problem problem = generate(n, density, gen);
+                for (const auto &kernel : options.kernels) {
+                    run_kernel(kernel, problem, density, options, perf.get(), json);
+                }
+            }
+        }
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+    json.end_array();
+    json.end_object();
+    json.finish();
+    return 0;
+}
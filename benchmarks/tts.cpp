@@ -0,0 +1,515 @@
+// Time-to-solution benchmark across the annealing engines.
+//
+// For every instance, engine and sweep budget, the harness runs many seeds,
+// counts how often the reference energy is reached, and reports the success
+// probability p, the mean wall time per run t (the anneal alone; building
+// the engine and its schedule is reported as setup time) and
+//     TTS99 = t * ln(0.01) / ln(1 - p)
+// with percentile bootstrap confidence intervals over seeds. A summary per
+// engine and budget reports the median TTS99 over instances, with intervals
+// bootstrapped over instances. Output is JSON.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "cli.hpp"
+#include "json_writer.hpp"
+#include "qanneal/annealer.hpp"
+#include "qanneal/dense_ising.hpp"
+#include "qanneal/parallel_tempering.hpp"
+#include "qanneal/replica_annealer.hpp"
+#include "qanneal/schedule.hpp"
+#include "qanneal/sqa_annealer.hpp"
+
+namespace {
+
+using qanneal::bench::JsonWriter;
+using qanneal::bench::split;
+using qanneal::bench::split_sizes;
+
+struct Options {
+    std::string family = "sk";
+    std::vector<std::size_t> sizes = {16, 24};
+    std::size_t instances = 4;
+    std::size_t seeds = 40;
+    std::vector<std::size_t> budgets = {10, 100};
+    std::vector<std::string> engines = {"sa", "replica", "pt", "sqa"};
+    std::vector<std::string> inputs;
+    std::size_t bootstrap = 1000;
+    std::uint64_t seed = 1;
+    double tolerance = 1e-6;
+    std::string output;
+};
+
+struct Instance {
+    std::string name;
+    std::shared_ptr<qanneal::DenseIsing> hamiltonian;
+    double reference = std::numeric_limits<double>::infinity();
+    bool exact = false;
+};
+
+struct RunSample {
+    double energy = 0.0;
+    double seconds = 0.0;
+    double setup_seconds = 0.0;
+};
+
+using Clock = std::chrono::steady_clock;
+
+void usage() {
+    std::cerr
+        << "usage: qanneal_tts [options]\n"
+        << "  --family sk|pm1|ferro     generated instance family (default sk)\n"
+        << "  --sizes 16,24             spin counts of generated instances\n"
+        << "  --instances N             generated instances per size (default 4)\n"
+        << "  --input FILE              load an instance instead (repeatable);\n"
+        << "                            lines 'n' then 'i j value', i == j is a field\n"
+        << "  --seeds N                 runs per instance, engine and budget (default 40)\n"
+        << "  --budgets 10,100          sweeps per replica per run\n"
+        << "  --engines sa,replica,pt,sqa\n"
+        << "  --bootstrap N             bootstrap resamples (default 1000)\n"
+        << "  --tolerance X             success if E <= reference + X (default 1e-6)\n"
+        << "  --seed N                  master seed (default 1)\n"
+        << "  --output FILE             write JSON here instead of stdout\n";
+}
+
+Options parse(int argc, char **argv) {
+    Options options;
+    for (int a = 1; a < argc; ++a) {
+        const std::string arg = argv[a];
+        auto next = [&]() -> std::string {
+            if (a + 1 >= argc) {
+                throw std::invalid_argument("Missing value for " + arg);
+            }
+            return argv[++a];
+        };
+        if (arg == "--family") {
+            options.family = next();
+        } else if (arg == "--sizes") {
+            options.sizes = split_sizes(next());
+        } else if (arg == "--instances") {
+            options.instances = std::stoull(next());
+        } else if (arg == "--input") {
+            options.inputs.push_back(next());
+        } else if (arg == "--seeds") {
+            options.seeds = std::stoull(next());
+        } else if (arg == "--budgets") {
+            options.budgets = split_sizes(next());
+        } else if (arg == "--engines") {
+            options.engines = split(next());
+        } else if (arg == "--bootstrap") {
+            options.bootstrap = std::stoull(next());
+        } else if (arg == "--tolerance") {
+            options.tolerance = std::stod(next());
+        } else if (arg == "--seed") {
+            options.seed = std::stoull(next());
+        } else if (arg == "--output") {
+            options.output = next();
+        } else if (arg == "--help" || arg == "-h") {
+            usage();
+            std::exit(0);
+        } else {
+            throw std::invalid_argument("Unknown option " + arg);
+        }
+    }
+    if (options.seeds == 0) {
+        throw std::invalid_argument("--seeds must be > 0.");
+    }
+    if (options.instances == 0) {
+        throw std::invalid_argument("--instances must be > 0.");
+    }
+    // Checked here rather than where they are used, so a typo ends in the
+    // usage message instead of an exception escaping main.
+    if (options.budgets.empty() ||
+        std::find(options.budgets.begin(), options.budgets.end(), 0) != options.budgets.end()) {
+        throw std::invalid_argument("--budgets must list sweeps > 0.");
+    }
+    if (options.engines.empty()) {
+        throw std::invalid_argument("--engines must list at least one engine.");
+    }
+    for (const auto &engine : options.engines) {
+        if (engine != "sa" && engine != "replica" && engine != "pt" && engine != "sqa") {
+            throw std::invalid_argument("Unknown engine " + engine);
+        }
+    }
+    if (options.inputs.empty()) {
+        if (options.family != "sk" && options.family != "pm1" && options.family != "ferro") {
+            throw std::invalid_argument("Unknown family " + options.family);
+        }
+        if (options.sizes.empty() ||
+            std::find(options.sizes.begin(), options.sizes.end(), 0) != options.sizes.end()) {
+            throw std::invalid_argument("--sizes must list spin counts > 0.");
+        }
+    }
+    return options;
+}
+
+std::shared_ptr<qanneal::DenseIsing> generate(const std::string &family,
+                                              std::size_t n,
+                                              std::mt19937_64 &gen) {
+    std::vector<double> h(n, 0.0);
+    std::vector<double> J(n * n, 0.0);
+    auto set = [&](std::size_t i, std::size_t j, double v) {
+        J[i * n + j] = v;
+        J[j * n + i] = v;
+    };
+    if (family == "sk") {
+        std::normal_distribution<double> normal(0.0, 1.0 / std::sqrt(static_cast<double>(n)));
+        for (std::size_t i = 0; i < n; ++i) {
+            for (std::size_t j = i + 1; j < n; ++j) {
+                set(i, j, normal(gen));
+            }
+        }
+    } else if (family == "pm1") {
+        std::bernoulli_distribution coin(0.5);
+        for (std::size_t i = 0; i < n; ++i) {
+            for (std::size_t j = i + 1; j < n; ++j) {
+                set(i, j, coin(gen) ? 1.0 : -1.0);
+            }
+        }
+    } else if (family == "ferro") {
+        // Periodic ring of ferromagnetic bonds with weak random fields.
+        std::uniform_real_distribution<double> field(-0.1, 0.1);
+        for (std::size_t i = 0; i < n; ++i) {
+            set(i, (i + 1) % n, -1.0);
+            h[i] = field(gen);
+        }
+    } else {
+        throw std::invalid_argument("Unknown family " + family);
+    }
+    return std::make_shared<qanneal::DenseIsing>(std::move(h), std::move(J), n);
+}
+
+std::shared_ptr<qanneal::DenseIsing> load(const std::string &path) {
+    std::ifstream in(path);
+    if (!in) {
+        throw std::runtime_error("Cannot open instance file " + path);
+    }
+    std::size_t n = 0;
+    if (!(in >> n) || n == 0) {
+        throw std::runtime_error("Instance file must start with the spin count: " + path);
+    }
+    std::vector<double> h(n, 0.0);
+    std::vector<double> J(n * n, 0.0);
+    std::size_t i = 0;
+    std::size_t j = 0;
+    double value = 0.0;
+    while (in >> i >> j >> value) {
+        if (i >= n || j >= n) {
+            throw std::runtime_error("Spin index out of range in " + path);
+        }
+        if (i == j) {
+            h[i] += value;
+        } else {
+            J[i * n + j] += value;
+            J[j * n + i] += value;
+        }
+    }
+    return std::make_shared<qanneal::DenseIsing>(std::move(h), std::move(J), n);
+}
+
+// Exhaustive search in Gray-code order, one flip per configuration.
+double exact_ground(const qanneal::DenseIsing &ham) {
+    const std::size_t n = ham.size();
+    qanneal::State state(n);
+    double energy = ham.energy(state);
+    double best = energy;
+    for (std::uint64_t k = 1; k < (std::uint64_t{1} << n); ++k) {
+        std::size_t flip = 0;
+        while (((k >> flip) & 1U) == 0) {
+            ++flip;
+        }
+        energy += ham.delta_energy(state, flip);
+        state[flip] = static_cast<int8_t>(-state[flip]);
+        best = std::min(best, energy);
+    }
+    return best;
+}
+
+// Times `anneal` alone; everything since `setup_start` (schedule
+// estimation, engine construction) is setup.
+template <typename Anneal>
+RunSample timed(Clock::time_point setup_start, Anneal &&anneal) {
+    const auto start = Clock::now();
+    const double energy = anneal();
+    const auto stop = Clock::now();
+    return {energy,
+            std::chrono::duration<double>(stop - start).count(),
+            std::chrono::duration<double>(start - setup_start).count()};
+}
+
+RunSample run_engine(const std::string &engine,
+                     const Instance &instance,
+                     std::size_t budget,
+                     std::uint64_t seed) {
+    const auto setup_start = Clock::now();
+    const auto &ham = *instance.hamiltonian;
+    if (engine == "sa") {
+        qanneal::Annealer annealer(ham, qanneal::auto_schedule(ham, budget));
+        annealer.set_seed(seed);
+        return timed(setup_start, [&] { return annealer.run(1).best_energy; });
+    }
+    if (engine == "replica") {
+        qanneal::ReplicaAnnealer annealer(ham, qanneal::auto_schedule(ham, budget), 4);
+        annealer.set_seed(seed);
+        return timed(setup_start, [&] { return annealer.run(1).global_best_energy; });
+    }
+    const auto range = qanneal::estimate_beta_range(ham);
+    if (engine == "pt") {
+        const auto ladder = qanneal::AnnealSchedule::geometric(range.beta_min, range.beta_max, 8);
+        qanneal::ParallelTemperingAnnealer annealer(ham, ladder.betas);
+        annealer.set_seed(seed);
+        return timed(setup_start, [&] { return annealer.run(1, budget).best_energy; });
+    }
+    if (engine == "sqa") {
+        // Constant temperature, transverse field ramped down from the scale
+        // of the largest local field.
+        const std::size_t slices = 8;
+        const double gamma_start = std::log(2.0) / range.beta_min;
+        std::vector<double> betas(budget, range.beta_max);
+        std::vector<double> gammas(budget);
+        for (std::size_t k = 0; k < budget; ++k) {
+            const double frac = (budget > 1) ? static_cast<double>(k) / static_cast<double>(budget - 1) : 1.0;
+            gammas[k] = gamma_start * (1.0 - frac) + 1e-3 * frac;
+        }
+        qanneal::SQAAnnealer annealer(ham, qanneal::SQASchedule::from_vectors(betas, gammas), slices);
+        annealer.set_seed(seed);
+        return timed(setup_start, [&] { return annealer.run(1, 1).best_energy; });
+    }
+    throw std::invalid_argument("Unknown engine " + engine);
+}
+
+double tts99(double p, double seconds) {
+    if (p <= 0.0) {
+        return std::numeric_limits<double>::infinity();
+    }
+    if (p >= 0.99) {
+        return seconds;
+    }
+    return seconds * std::log(0.01) / std::log(1.0 - p);
+}
+
+struct Estimate {
+    double value = 0.0;
+    double low = 0.0;
+    double high = 0.0;
+};
+
+double percentile(std::vector<double> values, double q) {
+    std::sort(values.begin(), values.end());
+    const double pos = q * static_cast<double>(values.size() - 1);
+    const auto lo = static_cast<std::size_t>(std::floor(pos));
+    const auto hi = static_cast<std::size_t>(std::ceil(pos));
+    if (!std::isfinite(values[lo]) || !std::isfinite(values[hi])) {
+        return values[hi];
+    }
+    return values[lo] + (values[hi] - values[lo]) * (pos - static_cast<double>(lo));
+}
+
+double median(std::vector<double> values) {
+    return percentile(std::move(values), 0.5);
+}
+
+// Percentile bootstrap of `statistic` over resamples of `count` indices.
+template <class Statistic>
+Estimate bootstrap(std::size_t count,
+                   std::size_t resamples,
+                   std::mt19937_64 &gen,
+                   Statistic statistic) {
+    std::vector<std::size_t> identity(count);
+    for (std::size_t k = 0; k < count; ++k) {
+        identity[k] = k;
+    }
+    Estimate estimate;
+    estimate.value = statistic(identity);
+    if (resamples == 0) {
+        estimate.low = estimate.high = estimate.value;
+        return estimate;
+    }
+    std::uniform_int_distribution<std::size_t> pick(0, count - 1);
+    std::vector<std::size_t> indices(count);
+    std::vector<double> stats(resamples);
+    for (std::size_t b = 0; b < resamples; ++b) {
+        for (auto &index : indices) {
+            index = pick(gen);
+        }
+        stats[b] = statistic(indices);
+    }
+    estimate.low = percentile(stats, 0.025);
+    estimate.high = percentile(stats, 0.975);
+    return estimate;
+}
+
+void write_estimate(JsonWriter &json, const std::string &name, const Estimate &estimate) {
+    json.key(name);
+    json.begin_object();
+    json.field("value", estimate.value);
+    json.field("ci_low", estimate.low);
+    json.field("ci_high", estimate.high);
+    json.end_object();
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    Options options;
+    try {
+        options = parse(argc, argv);
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << "\n";
+        usage();
+        return 2;
+    }
+
+    std::mt19937_64 gen(options.seed);
+    std::vector<Instance> instances;
+    for (const auto &path : options.inputs) {
+        instances.push_back({path, load(path)});
+    }
+    if (options.inputs.empty()) {
+        for (std::size_t n : options.sizes) {
+            for (std::size_t k = 0; k < options.instances; ++k) {
+                instances.push_back({options.family + "_n" + std::to_string(n) + "_" + std::to_string(k),
+                                     generate(options.family, n, gen)});
+            }
+        }
+    }
+    for (auto &instance : instances) {
+        if (instance.hamiltonian->size() <= 24) {
+            instance.reference = exact_ground(*instance.hamiltonian);
+            instance.exact = true;
+        }
+    }
+
+    // samples[e][b][i][s]
+    const std::size_t E = options.engines.size();
+    const std::size_t B = options.budgets.size();
+    const std::size_t I = instances.size();
+    const std::size_t S = options.seeds;
+    std::vector<RunSample> samples(E * B * I * S);
+    auto at = [&](std::size_t e, std::size_t b, std::size_t i, std::size_t s) -> RunSample & {
+        return samples[((e * B + b) * I + i) * S + s];
+    };
+
+    for (std::size_t e = 0; e < E; ++e) {
+        for (std::size_t b = 0; b < B; ++b) {
+            for (std::size_t i = 0; i < I; ++i) {
+                for (std::size_t s = 0; s < S; ++s) {
+                    const RunSample sample = run_engine(options.engines[e], instances[i], options.budgets[b],
+                                                        options.seed * 1000003ULL + s);
+                    at(e, b, i, s) = sample;
+                    if (!instances[i].exact) {
+                        instances[i].reference = std::min(instances[i].reference, sample.energy);
+                    }
+                }
+            }
+        }
+    }
+
+    std::ofstream file;
+    if (!options.output.empty()) {
+        file.open(options.output);
+        if (!file) {
+            std::cerr << "Cannot open " << options.output << "\n";
+            return 1;
+        }
+    }
+    JsonWriter json(options.output.empty() ? std::cout : file);
+    json.begin_object();
+    json.field("benchmark", "qanneal_tts");
+    json.field("family", options.inputs.empty() ? options.family : std::string("file"));
+    json.field("seeds", options.seeds);
+    json.field("bootstrap", options.bootstrap);
+    json.field("tolerance", options.tolerance);
+
+    json.key("instances");
+    json.begin_array();
+    for (const auto &instance : instances) {
+        json.begin_object();
+        json.field("name", instance.name);
+        json.field("spins", instance.hamiltonian->size());
+        json.field("reference_energy", instance.reference);
+        json.field("reference", instance.exact ? "exact" : "best_found");
+        json.end_object();
+    }
+    json.end_array();
+
+    json.key("results");
+    json.begin_array();
+    for (std::size_t e = 0; e < E; ++e) {
+        for (std::size_t b = 0; b < B; ++b) {
+            std::vector<double> instance_tts(I);
+            for (std::size_t i = 0; i < I; ++i) {
+                std::vector<double> success(S);
+                std::vector<double> seconds(S);
+                std::vector<double> setup_seconds(S);
+                for (std::size_t s = 0; s < S; ++s) {
+                    const auto &sample = at(e, b, i, s);
+                    success[s] = (sample.energy <= instances[i].reference + options.tolerance) ? 1.0 : 0.0;
+                    seconds[s] = sample.seconds;
+                    setup_seconds[s] = sample.setup_seconds;
+                }
+                auto mean_of = [](const std::vector<double> &values, const std::vector<std::size_t> &idx) {
+                    double sum = 0.0;
+                    for (std::size_t k : idx) {
+                        sum += values[k];
+                    }
+                    return sum / static_cast<double>(idx.size());
+                };
+                const Estimate p = bootstrap(S, options.bootstrap, gen, [&](const std::vector<std::size_t> &idx) {
+                    return mean_of(success, idx);
+                });
+                const Estimate t = bootstrap(S, options.bootstrap, gen, [&](const std::vector<std::size_t> &idx) {
+                    return mean_of(seconds, idx);
+                });
+                const Estimate setup = bootstrap(S, options.bootstrap, gen, [&](const std::vector<std::size_t> &idx) {
+                    return mean_of(setup_seconds, idx);
+                });
+                const Estimate tts = bootstrap(S, options.bootstrap, gen, [&](const std::vector<std::size_t> &idx) {
+                    return tts99(mean_of(success, idx), mean_of(seconds, idx));
+                });
+                instance_tts[i] = tts.value;
+
+                json.begin_object();
+                json.field("engine", options.engines[e]);
+                json.field("budget", options.budgets[b]);
+                json.field("instance", instances[i].name);
+                write_estimate(json, "success_probability", p);
+                write_estimate(json, "seconds_per_run", t);
+                write_estimate(json, "setup_seconds_per_run", setup);
+                write_estimate(json, "tts99_seconds", tts);
+                json.end_object();
+            }
+
+            const Estimate summary = bootstrap(I, options.bootstrap, gen, [&](const std::vector<std::size_t> &idx) {
+                std::vector<double> values;
+                values.reserve(idx.size());
+                for (std::size_t k : idx) {
+                    values.push_back(instance_tts[k]);
+                }
+                return median(std::move(values));
+            });
+            json.begin_object();
+            json.field("engine", options.engines[e]);
+            json.field("budget", options.budgets[b]);
+            json.field("instance", "median");
+            write_estimate(json, "tts99_seconds", summary);
+            json.end_object();
+        }
+    }
+    json.end_array();
+    json.end_object();
+    json.finish();
+    return 0;
+}
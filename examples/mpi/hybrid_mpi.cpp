@@ -0,0 +1,44 @@
+#include <cstdio>
+#include <vector>
+
+#include "qanneal/mpi/mpi_context.hpp"
+#include "qanneal/mpi/mpi_hybrid.hpp"
+#include "qanneal/schedule.hpp"
+#include "qanneal/sparse_ising.hpp"
+
+int main(int argc, char **argv) {
+    qanneal::mpi::MPIContext mpi(argc, argv);
+
+    // 64 x 64 periodic +-J spin glass with a fixed pattern of couplings.
+    const std::size_t side = 64;
+    const std::size_t n = side * side;
+    std::vector<double> h(n, 0.0);
+    std::vector<qanneal::SparseEdge> edges;
+    for (std::size_t r = 0; r < side; ++r) {
+        for (std::size_t c = 0; c < side; ++c) {
+            const std::size_t i = r * side + c;
+            const std::size_t right = r * side + (c + 1) % side;
+            const std::size_t down = ((r + 1) % side) * side + c;
+            edges.push_back({i, right, ((i * 7) % 5 < 2) ? 1.0 : -1.0});
+            edges.push_back({i, down, ((i * 11) % 7 < 3) ? 1.0 : -1.0});
+        }
+    }
+    qanneal::SparseIsing ham(h, edges, n);
+    auto schedule = qanneal::AnnealSchedule::linear(0.1, 3.0, 200);
+
+    // One rank per node or socket; threads from OMP_NUM_THREADS.
+    auto summary = qanneal::mpi::run_hybrid_replica_anneal(ham, schedule, 2, /*replicas_per_rank=*/16, /*seed=*/42);
+
+    const auto &layout = summary.layout;
+    std::printf("rank %d (node rank %d/%d): %zu threads on cores", layout.rank, layout.node_rank,
+                layout.node_size, layout.threads);
+    for (int core : layout.cores) {
+        std::printf(" %d", core);
+    }
+    std::printf(", local best %g\n", summary.local_best_energy);
+    if (summary.rank == 0) {
+        std::printf("Global best energy: %g\n", summary.global_best_energy);
+    }
+
+    return 0;
+}
@@ -0,0 +1,49 @@
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "qanneal/mpi/mpi_context.hpp"
+#include "qanneal/mpi/mpi_parallel_tempering.hpp"
+#include "qanneal/sparse_ising.hpp"
+
+int main(int argc, char **argv) {
+    qanneal::mpi::MPIContext mpi(argc, argv);
+
+    // 8 x 8 periodic +-J spin glass with a fixed pattern of couplings.
+    const std::size_t side = 8;
+    const std::size_t n = side * side;
+    std::vector<double> h(n, 0.0);
+    std::vector<qanneal::SparseEdge> edges;
+    for (std::size_t r = 0; r < side; ++r) {
+        for (std::size_t c = 0; c < side; ++c) {
+            const std::size_t i = r * side + c;
+            const std::size_t right = r * side + (c + 1) % side;
+            const std::size_t down = ((r + 1) % side) * side + c;
+            edges.push_back({i, right, ((i * 7) % 5 < 2) ? 1.0 : -1.0});
+            edges.push_back({i, down, ((i * 11) % 7 < 3) ? 1.0 : -1.0});
+        }
+    }
+    qanneal::SparseIsing ham(h, edges, n);
+
+    // Geometric ladder, split across the ranks.
+    const std::size_t temperatures = 16;
+    std::vector<double> betas(temperatures);
+    for (std::size_t t = 0; t < temperatures; ++t) {
+        betas[t] = 0.2 * std::pow(3.0 / 0.2, static_cast<double>(t) / (temperatures - 1));
+    }
+
+    auto summary = qanneal::mpi::run_parallel_tempering(
+        ham, betas, /*sweeps_per_step=*/2, /*steps=*/500, /*swap_interval=*/1, /*seed=*/42);
+
+    if (summary.rank == 0) {
+        std::printf("Global best energy: %g\n", summary.global_best_energy);
+        for (std::size_t t = 0; t + 1 < temperatures; ++t) {
+            const double rate = summary.swap_attempts[t] > 0
+                ? static_cast<double>(summary.swap_accepts[t]) / static_cast<double>(summary.swap_attempts[t])
+                : 0.0;
+            std::printf("beta %.3f <-> %.3f: swap acceptance %.2f\n", betas[t], betas[t + 1], rate);
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,48 @@
+#include <cstdio>
+#include <vector>
+
+#include "qanneal/mpi/mpi_context.hpp"
+#include "qanneal/mpi/mpi_restart_scheduler.hpp"
+#include "qanneal/schedule.hpp"
+#include "qanneal/sparse_ising.hpp"
+#include "qanneal/stop_criteria.hpp"
+
+int main(int argc, char **argv) {
+    qanneal::mpi::MPIContext mpi(argc, argv);
+
+    // 32 x 32 periodic +-J spin glass with a fixed pattern of couplings.
+    const std::size_t side = 32;
+    const std::size_t n = side * side;
+    std::vector<double> h(n, 0.0);
+    std::vector<qanneal::SparseEdge> edges;
+    for (std::size_t r = 0; r < side; ++r) {
+        for (std::size_t c = 0; c < side; ++c) {
+            const std::size_t i = r * side + c;
+            const std::size_t right = r * side + (c + 1) % side;
+            const std::size_t down = ((r + 1) % side) * side + c;
+            edges.push_back({i, right, ((i * 7) % 5 < 2) ? 1.0 : -1.0});
+            edges.push_back({i, down, ((i * 11) % 7 < 3) ? 1.0 : -1.0});
+        }
+    }
+    qanneal::SparseIsing ham(h, edges, n);
+    auto schedule = qanneal::AnnealSchedule::linear(0.1, 3.0, 100);
+
+    qanneal::mpi::RestartSchedulerOptions options;
+    options.restarts = 200;
+    options.batch = 2;
+    options.time_limit = 10.0;
+    options.seed = 42;
+    auto summary = qanneal::mpi::run_scheduled_restarts(ham, schedule, 2, options);
+
+    if (summary.rank == 0) {
+        std::printf("Global best energy: %g (restart %zu), %zu restarts in %.2f s, stop: %s\n",
+                    summary.global_best_energy, summary.best_restart, summary.restarts_completed,
+                    summary.elapsed_seconds, qanneal::stop_reason_to_string(summary.stop_reason));
+        for (int r = 0; r < summary.size; ++r) {
+            std::printf("rank %d: %zu restarts, busy %.0f%%\n", r, summary.restarts_per_rank[r],
+                        100.0 * summary.busy_seconds_per_rank[r] / summary.elapsed_seconds);
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,68 @@
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+#include "qanneal/energy_histogram.hpp"
+#include "qanneal/mpi/mpi_context.hpp"
+#include "qanneal/mpi/mpi_statistics.hpp"
+#include "qanneal/replica_annealer.hpp"
+#include "qanneal/sample_set.hpp"
+#include "qanneal/schedule.hpp"
+#include "qanneal/sparse_ising.hpp"
+
+int main(int argc, char **argv) {
+    qanneal::mpi::MPIContext mpi(argc, argv);
+    int rank = 0;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+    // 8 x 8 periodic +-J spin glass with a fixed pattern of couplings.
+    const std::size_t side = 8;
+    const std::size_t n = side * side;
+    std::vector<double> h(n, 0.0);
+    std::vector<qanneal::SparseEdge> edges;
+    for (std::size_t r = 0; r < side; ++r) {
+        for (std::size_t c = 0; c < side; ++c) {
+            const std::size_t i = r * side + c;
+            const std::size_t right = r * side + (c + 1) % side;
+            const std::size_t down = ((r + 1) % side) * side + c;
+            edges.push_back({i, right, ((i * 7) % 5 < 2) ? 1.0 : -1.0});
+            edges.push_back({i, down, ((i * 11) % 7 < 3) ? 1.0 : -1.0});
+        }
+    }
+    qanneal::SparseIsing ham(h, edges, n);
+    auto schedule = qanneal::AnnealSchedule::linear(0.1, 3.0, 50);
+
+    const std::size_t replicas = 16;
+    auto samples = std::make_shared<qanneal::SampleSet>(n, /*capacity=*/8);
+    qanneal::ReplicaAnnealer annealer(ham, schedule, replicas);
+    annealer.set_seed(42 + static_cast<std::uint64_t>(rank));
+    annealer.set_sample_set(samples);
+    auto result = annealer.run(2);
+
+    // Final energies of every replica on every rank, and the chance of
+    // finishing within 4 of the lowest energy found on rank 0.
+    double target = result.global_best_energy + 4.0;
+    MPI_Bcast(&target, 1, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+    qanneal::EnergyHistogram histogram(-140.0, 0.0, 35, target);
+    std::vector<std::vector<double>> traces;
+    for (const auto &replica : result.replicas) {
+        histogram.add(replica.energy_trace.back());
+        traces.push_back(replica.energy_trace);
+    }
+    qanneal::mpi::allreduce_histogram(histogram);
+    auto stats = qanneal::mpi::allreduce_traces(traces);
+    qanneal::mpi::allreduce_sample_set(*samples);
+
+    if (rank == 0) {
+        std::printf("%llu runs, P(E <= %g) = %.2f\n", static_cast<unsigned long long>(histogram.total()), target,
+                    histogram.success_probability());
+        const std::size_t last = stats.mean.size() - 1;
+        std::printf("final step: mean %.2f, stddev %.2f, min %g\n", stats.mean[last], stats.stddev[last],
+                    stats.min[last]);
+        for (const auto &sample : samples->samples()) {
+            std::printf("E = %g seen %llu times\n", sample.energy, static_cast<unsigned long long>(sample.count));
+        }
+    }
+
+    return 0;
+}
@@ -1,5 +1,5 @@
 import numpy as np
-from qanneal import DenseIsing, ParallelTemperingAnnealer
+from qanneal import ClusterMoveOptions, ClusterUpdate, DenseIsing, ParallelTemperingAnnealer
 
 n = 5
 h = np.zeros(n, dtype=float)
@@ -13,7 +13,16 @@ ham = DenseIsing(h, J)
 betas = [0.2, 0.4, 0.8, 1.2]
 
 annealer = ParallelTemperingAnnealer(ham, betas)
+
+# Optional cluster moves: Houdayer moves between two copies per beta plus
+# Wolff updates for ferromagnetic-dominated couplings.
+clusters = ClusterMoveOptions()
+clusters.houdayer = True
+clusters.update = ClusterUpdate.WOLFF
+annealer.set_cluster_moves(clusters)
+
 result = annealer.run(sweeps_per_step=5, steps=20, swap_interval=1)
 
 print("Best energy:", result.best_energy)
 print("Swap acceptance (last):", result.swap_acceptance_trace[-1])
+print("Cluster size (last):", result.cluster_size_trace[-1])
@@ -0,0 +1,18 @@
+import numpy as np
+from qanneal import DenseIsing, AnnealSchedule, PopulationAnnealer
+
+rng = np.random.default_rng(3)
+n = 12
+h = np.zeros(n, dtype=float)
+J = np.triu(rng.choice([-1.0, 1.0], size=(n, n)), k=1)
+J = J + J.T
+
+ham = DenseIsing(h, J)
+schedule = AnnealSchedule.linear(0.1, 3.0, 40)
+
+annealer = PopulationAnnealer(ham, schedule, population=500)
+result = annealer.run(5)
+
+print("Best energy:", result.best_energy)
+print("Free energy (final beta):", result.free_energy_trace[-1])
+print("Surviving families:", result.surviving_families)
@@ -0,0 +1,36 @@
+import os
+import time
+from concurrent.futures import ThreadPoolExecutor
+
+import numpy as np
+from qanneal import DenseIsingView, AnnealSchedule, Annealer, BatchedObserver
+
+n = 400
+rng = np.random.default_rng(7)
+J = rng.normal(size=(n, n))
+J = np.triu(J, 1)
+J = J + J.T
+h = rng.normal(size=n)
+
+ham = DenseIsingView(h, J)
+schedule = AnnealSchedule.linear(0.1, 3.0, 100)
+
+
+def solve(seed):
+    progress = []
+    obs = BatchedObserver(lambda steps, betas, gammas, energies, mags: progress.append(energies.min()), 25)
+    annealer = Annealer(ham, schedule)
+    annealer.set_seed(seed)
+    result = annealer.run(20, obs)
+    return result.best_energy, len(progress)
+
+
+seeds = range(8)
+for workers in (1, os.cpu_count() or 1):
+    start = time.perf_counter()
+    with ThreadPoolExecutor(max_workers=workers) as pool:
+        results = list(pool.map(solve, seeds))
+    elapsed = time.perf_counter() - start
+    print(f"{workers} thread(s): {elapsed:.2f} s, best energy {min(e for e, _ in results):.3f}")
+
+print("Observer callbacks per run:", results[0][1])
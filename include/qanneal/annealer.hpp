@@ -7,9 +7,15 @@
 #include <vector>
 
 #include "qanneal/backend.hpp"
+#include "qanneal/checkpoint.hpp"
+#include "qanneal/instrumentation.hpp"
+#include "qanneal/local_search.hpp"
 #include "qanneal/observer.hpp"
+#include "qanneal/rejection_free.hpp"
+#include "qanneal/sample_set.hpp"
 #include "qanneal/schedule.hpp"
 #include "qanneal/state.hpp"
+#include "qanneal/stop_criteria.hpp"
 
 namespace qanneal {
 
@@ -17,6 +23,15 @@ struct AnnealResult {
     State best_state;
     double best_energy = 0.0;
     std::vector<double> energy_trace;
+    // Accepted flips per attempted flip (per n x sweeps in rejection-free mode).
+    std::vector<double> acceptance_trace;
+    // First step run rejection-free; equals the schedule size if none was.
+    std::size_t rejection_free_step = 0;
+    // Hot-path counters, one entry per step; empty when built without
+    // instrumentation.
+    std::vector<StepCounters> step_counters;
+    StopReason stop_reason = StopReason::Completed;
+    std::size_t sweeps = 0;
 };
 
 class Annealer {
@@ -27,14 +42,36 @@ public:
                       AnnealSchedule schedule);
 
     void set_seed(std::uint64_t seed);
+    void set_update_mode(UpdateMode mode, double acceptance_threshold = 0.05);
+    void set_polish(PolishOptions options);
+    void set_stop_criteria(StopCriteria criteria);
+    void set_checkpoint(CheckpointOptions options);
+    // Offers the states visited during runs to `samples` (null to stop):
+    // the state after every sweep, hashed incrementally per flip.
+    void set_sample_set(std::shared_ptr<SampleSet> samples);
 
     AnnealResult run(std::size_t sweeps_per_beta,
                      Observer *observer = nullptr);
+    // Continues a run from the checkpoint at `path`; the annealer must be
+    // configured as it was when the checkpoint was written.
+    AnnealResult resume(const std::string &path,
+                        std::size_t sweeps_per_beta,
+                        Observer *observer = nullptr);
 
 private:
     std::shared_ptr<Backend> backend_;
     AnnealSchedule schedule_;
+    UpdateMode mode_ = UpdateMode::Metropolis;
+    double acceptance_threshold_ = 0.05;
+    PolishOptions polish_;
+    StopCriteria stop_;
+    CheckpointOptions checkpoint_;
+    std::shared_ptr<SampleSet> samples_;
     std::mt19937_64 rng_;
+
+    AnnealResult run_from(std::size_t sweeps_per_beta,
+                          Observer *observer,
+                          CheckpointReader *reader);
 };
 
 }
@@ -43,6 +43,9 @@ public:
     virtual std::size_t size() const = 0;
     virtual double energy(const int8_t *spins, std::size_t n) const = 0;
     virtual double delta_energy(const int8_t *spins, std::size_t n, std::size_t flip) const = 0;
+
+    // Host-side model, or nullptr when the backend keeps it elsewhere.
+    virtual const Hamiltonian *hamiltonian() const { return nullptr; }
 };
 
 class CPUBackend final : public Backend {
@@ -65,10 +68,23 @@ public:
         return ham_->delta_energy(spins, n, flip);
     }
 
+    const Hamiltonian *hamiltonian() const override { return ham_.get(); }
+
 private:
     std::shared_ptr<const Hamiltonian> ham_;
 };
 
+// Host-side model behind `backend`, for algorithms that need more than energy
+// and delta evaluations.
+inline const Hamiltonian &require_hamiltonian(const Backend &backend) {
+    const Hamiltonian *ham = backend.hamiltonian();
+    if (!ham) {
+        throw std::runtime_error(std::string("Backend '") + backend_to_string(backend.kind()) +
+                                 "' does not expose a host-side Hamiltonian.");
+    }
+    return *ham;
+}
+
 inline std::shared_ptr<Backend> make_backend(BackendKind kind,
                                              std::shared_ptr<const Hamiltonian> ham) {
     switch (kind) {
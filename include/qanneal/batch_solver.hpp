@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "qanneal/dense_ising.hpp"
+#include "qanneal/hamiltonian.hpp"
+#include "qanneal/schedule.hpp"
+#include "qanneal/state.hpp"
+#include "qanneal/thread_pool.hpp"
+
+namespace qanneal {
+
+// Many small dense problems packed into one arena. Instance k owns spins
+// [spin_offset(k), spin_offset(k + 1)) of the h buffer and a symmetric,
+// zero-diagonal n x n block of the J buffer.
+class IsingBatch {
+public:
+    IsingBatch() = default;
+    explicit IsingBatch(const std::vector<DenseIsing> &problems);
+    // Contiguous input: h holds sum(sizes) entries and J the row-major
+    // sizes[k] x sizes[k] blocks back to back. Only the upper triangle of
+    // each block is read, matching DenseIsing::energy.
+    IsingBatch(const std::vector<std::size_t> &sizes,
+               const std::vector<double> &h,
+               const std::vector<double> &J,
+               const std::vector<double> &constants = {});
+
+    void reserve(std::size_t instances, std::size_t total_spins, std::size_t total_couplings);
+    void add(const double *h, const double *J, std::size_t n, double c = 0.0);
+    void add(const DenseIsing &problem);
+    // Any model exposing a coupling graph; it is densified into the arena.
+    void add(const Hamiltonian &problem);
+
+    std::size_t size() const { return constants_.size(); }
+    std::size_t spins(std::size_t k) const { return spin_offsets_[k + 1] - spin_offsets_[k]; }
+    std::size_t spin_offset(std::size_t k) const { return spin_offsets_[k]; }
+    std::size_t total_spins() const { return spin_offsets_.back(); }
+    const double *h(std::size_t k) const { return h_.data() + spin_offsets_[k]; }
+    const double *J(std::size_t k) const { return J_.data() + coupling_offsets_[k]; }
+    double constant(std::size_t k) const { return constants_[k]; }
+
+    double energy(std::size_t k, const int8_t *spins) const;
+
+private:
+    std::vector<std::size_t> spin_offsets_{0};
+    std::vector<std::size_t> coupling_offsets_{0};
+    std::vector<double> h_;
+    std::vector<double> J_;
+    std::vector<double> constants_;
+};
+
+// Best states laid out like the IsingBatch they came from.
+struct BatchResult {
+    std::vector<std::size_t> offsets;
+    std::vector<int8_t> best_spins;
+    std::vector<double> best_energies;
+
+    std::size_t size() const { return best_energies.size(); }
+    State best_state(std::size_t k) const;
+};
+
+// Throughput-oriented simulated annealing over an IsingBatch. Each instance
+// runs on one worker of a work-stealing pool with incrementally updated local
+// fields and per-thread scratch, so no allocation happens per instance.
+// Results do not depend on the thread count: instance k always draws from a
+// generator derived from the run seed and k.
+class BatchAnnealer {
+public:
+    explicit BatchAnnealer(AnnealSchedule schedule);
+
+    void set_seed(std::uint64_t seed);
+    // 0 uses every hardware thread.
+    void set_threads(std::size_t threads);
+
+    BatchResult run(const IsingBatch &batch, std::size_t sweeps_per_beta);
+
+private:
+    AnnealSchedule schedule_;
+    std::size_t threads_ = 0;
+    std::unique_ptr<ThreadPool> pool_;
+    std::mt19937_64 rng_;
+};
+
+} // namespace qanneal
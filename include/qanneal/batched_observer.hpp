@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+#include "qanneal/observer.hpp"
+#include "qanneal/sqa_observer.hpp"
+
+namespace qanneal {
+
+// Consecutive recorded steps, one entry per step.
+struct ObserverBatch {
+    std::vector<std::size_t> steps;
+    std::vector<double> betas;
+    std::vector<double> gammas;  // NaN for classical engines
+    std::vector<double> energies;
+    std::vector<double> magnetizations;
+
+    std::size_t size() const { return steps.size(); }
+};
+
+// Observer that buffers per-step scalars and hands them to a callback
+// `interval` steps at a time, so a callback with a high fixed cost (a
+// Python function, which has to take the GIL) runs rarely. The callback
+// owns each batch it receives. flush() delivers a partial last batch.
+// Usable with the classical engines and SQAAnnealer; one producer thread
+// at a time.
+class BatchedObserver final : public Observer, public SQAObserver {
+public:
+    using Callback = std::function<void(ObserverBatch)>;
+
+    BatchedObserver(Callback callback, std::size_t interval);
+
+    void record(std::size_t step,
+                double beta,
+                double energy,
+                const State &state) override;
+    void record(std::size_t step,
+                double beta,
+                double gamma,
+                double avg_energy,
+                const SQAState &state) override;
+
+    // Hands over the buffered steps, if any.
+    void flush();
+
+    std::size_t interval() const { return interval_; }
+    std::size_t pending() const { return pending_.size(); }
+
+private:
+    Callback callback_;
+    std::size_t interval_;
+    ObserverBatch pending_;
+
+    void push(std::size_t step, double beta, double gamma, double energy, double magnetization);
+    void reserve();
+};
+
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "qanneal/sqa_state.hpp"
+#include "qanneal/state.hpp"
+#include "qanneal/stop_criteria.hpp"
+
+namespace qanneal {
+
+struct CheckpointOptions {
+    // File written at step boundaries; an empty path disables checkpointing.
+    std::string path;
+    // Write a checkpoint every `interval` schedule steps.
+    std::size_t interval = 1;
+};
+
+// Little-endian binary checkpoint: magic, format version, engine tag, then the
+// fields in the order the engine writes them. Spins are stored bit-packed.
+class CheckpointWriter {
+public:
+    explicit CheckpointWriter(const std::string &tag);
+
+    void write_u64(std::uint64_t value);
+    void write_f64(double value);
+    void write_size(std::size_t value) { write_u64(static_cast<std::uint64_t>(value)); }
+    void write_doubles(const std::vector<double> &values);
+    void write_sizes(const std::vector<std::size_t> &values);
+    void write_spins(const int8_t *spins, std::size_t n);
+    void write_state(const State &state);
+    void write_states(const std::vector<State> &states);
+    void write_sqa_state(const SQAState &state);
+    void write_rng(const std::mt19937_64 &rng);
+    void write_monitor(const StopMonitor &monitor);
+
+    // Writes to `path` through a temporary file and a rename, so a crash never
+    // leaves a truncated checkpoint behind.
+    void commit(const std::string &path) const;
+
+private:
+    std::string buffer_;
+
+    void append(const void *data, std::size_t bytes);
+};
+
+class CheckpointReader {
+public:
+    // Throws if the file is missing, corrupt, or was written by another engine.
+    CheckpointReader(const std::string &path, const std::string &tag);
+
+    std::uint64_t read_u64();
+    double read_f64();
+    std::size_t read_size() { return static_cast<std::size_t>(read_u64()); }
+    std::vector<double> read_doubles();
+    std::vector<std::size_t> read_sizes();
+    void read_spins(int8_t *spins, std::size_t n);
+    State read_state();
+    std::vector<State> read_states();
+    SQAState read_sqa_state();
+    void read_rng(std::mt19937_64 &rng);
+    void read_monitor(StopMonitor &monitor);
+
+    // Throws unless every byte has been consumed.
+    void finish() const;
+
+private:
+    std::string buffer_;
+    std::size_t pos_ = 0;
+
+    void take(void *data, std::size_t bytes);
+    std::size_t remaining() const { return buffer_.size() - pos_; }
+    // Length prefixes are checked against the bytes left before anything is
+    // allocated, so a corrupt file reads as truncated rather than asking
+    // for a huge buffer.
+    std::size_t read_count(std::size_t item_bytes);
+    void require_spins(std::size_t n) const;
+};
+
+} // namespace qanneal
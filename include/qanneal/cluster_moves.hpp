@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "qanneal/hamiltonian.hpp"
+#include "qanneal/state.hpp"
+
+namespace qanneal {
+
+enum class ClusterUpdate {
+    None,
+    Wolff,
+    SwendsenWang
+};
+
+struct ClusterMoveOptions {
+    // Houdayer isoenergetic moves between two copies at the same beta. Enabling
+    // them doubles the number of replicas parallel tempering keeps.
+    bool houdayer = false;
+    // Houdayer clusters percolate at high temperature, where a move is just a
+    // random rearrangement; only apply them for betas at or above this value.
+    double houdayer_beta_min = 0.0;
+    // Fortuin-Kasteleyn cluster update applied to every replica.
+    ClusterUpdate update = ClusterUpdate::None;
+    // Apply cluster moves every `interval` steps.
+    std::size_t interval = 1;
+};
+
+// Reusable buffers for cluster growth. All moves run on the preallocated queue
+// and mask, so they allocate nothing after construction.
+class ClusterWorkspace {
+public:
+    ClusterWorkspace() = default;
+    explicit ClusterWorkspace(CouplingGraph graph);
+
+    std::size_t size() const { return graph_.size(); }
+
+    // Flips a cluster of sites where `a` and `b` disagree in both states.
+    // Returns the cluster size (0 when the states are identical).
+    std::size_t houdayer_move(State &a,
+                              State &b,
+                              double &energy_a,
+                              double &energy_b,
+                              std::mt19937_64 &rng);
+
+    // Grows and flips a single Wolff cluster. Fields are handled by a
+    // Metropolis test on the field energy of the cluster. Returns the number
+    // of spins flipped.
+    std::size_t wolff_update(State &state,
+                             double beta,
+                             double &energy,
+                             std::mt19937_64 &rng);
+
+    // Decomposes the state into Fortuin-Kasteleyn clusters and flips each one
+    // with heat-bath probability. Returns the number of spins flipped.
+    std::size_t swendsen_wang_update(State &state,
+                                     double beta,
+                                     double &energy,
+                                     std::mt19937_64 &rng);
+
+private:
+    CouplingGraph graph_;
+    std::vector<std::size_t> queue_;
+    std::vector<std::uint8_t> mask_;
+
+    std::size_t grow_fk_cluster(const State &state,
+                                std::size_t seed,
+                                double beta,
+                                std::mt19937_64 &rng);
+    double cluster_flip_delta(const State &state,
+                              std::size_t count,
+                              double &field_delta) const;
+    void flip_cluster(State &state, std::size_t count) const;
+};
+
+} // namespace qanneal
@@ -2,19 +2,36 @@
 
 #include "qanneal/annealer.hpp"
 #include "qanneal/backend.hpp"
+#include "qanneal/batch_solver.hpp"
+#include "qanneal/batched_observer.hpp"
+#include "qanneal/checkpoint.hpp"
+#include "qanneal/cluster_moves.hpp"
 #include "qanneal/dense_ising.hpp"
+#include "qanneal/energy_histogram.hpp"
+#include "qanneal/flip_journal.hpp"
 #include "qanneal/hamiltonian.hpp"
+#include "qanneal/instrumentation.hpp"
+#include "qanneal/ising_view.hpp"
+#include "qanneal/local_search.hpp"
 #include "qanneal/metrics.hpp"
 #include "qanneal/metrics_observer.hpp"
 #include "qanneal/observer.hpp"
 #include "qanneal/parallel_tempering.hpp"
+#include "qanneal/perf_counters.hpp"
+#include "qanneal/population_annealer.hpp"
 #include "qanneal/qubo.hpp"
+#include "qanneal/rejection_free.hpp"
 #include "qanneal/replica_annealer.hpp"
+#include "qanneal/sample_set.hpp"
 #include "qanneal/schedule.hpp"
 #include "qanneal/sqa_annealer.hpp"
 #include "qanneal/sqa_observer.hpp"
 #include "qanneal/sqa_schedule.hpp"
 #include "qanneal/sqa_state.hpp"
+#include "qanneal/solver_pool.hpp"
 #include "qanneal/sparse_ising.hpp"
 #include "qanneal/state.hpp"
+#include "qanneal/stop_criteria.hpp"
+#include "qanneal/telemetry_observer.hpp"
+#include "qanneal/thread_pool.hpp"
 #include "qanneal/version.hpp"
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+namespace qanneal {
+
+// Energies counted in equal-width bins over [lower, upper), with the samples
+// outside that range in underflow / overflow. The bin edges are fixed up
+// front, so histograms of different runs (or ranks) add bin by bin. Samples
+// at or below `target` are also counted in `hits`, which gives the success
+// probability of reaching it. Non-finite energies are rejected.
+struct EnergyHistogram {
+    double lower = 0.0;
+    double upper = 1.0;
+    double target = -std::numeric_limits<double>::infinity();
+    std::vector<std::uint64_t> counts;
+    std::uint64_t underflow = 0;
+    std::uint64_t overflow = 0;
+    std::uint64_t hits = 0;
+    double min_energy = std::numeric_limits<double>::infinity();
+    double max_energy = -std::numeric_limits<double>::infinity();
+
+    EnergyHistogram() = default;
+    EnergyHistogram(double lower_, double upper_, std::size_t bins,
+                    double target_ = -std::numeric_limits<double>::infinity())
+        : lower(lower_), upper(upper_), target(target_), counts(bins, 0) {
+        if (bins == 0) {
+            throw std::invalid_argument("EnergyHistogram needs at least one bin.");
+        }
+        if (!std::isfinite(lower) || !std::isfinite(upper) || !(upper > lower)) {
+            throw std::invalid_argument("EnergyHistogram range must be finite with upper > lower.");
+        }
+    }
+
+    std::size_t bins() const { return counts.size(); }
+    double bin_width() const { return (upper - lower) / static_cast<double>(counts.size()); }
+    double bin_lower(std::size_t bin) const { return lower + static_cast<double>(bin) * bin_width(); }
+
+    std::uint64_t total() const {
+        std::uint64_t sum = underflow + overflow;
+        for (std::uint64_t count : counts) {
+            sum += count;
+        }
+        return sum;
+    }
+
+    double success_probability() const {
+        const std::uint64_t n = total();
+        return n > 0 ? static_cast<double>(hits) / static_cast<double>(n) : 0.0;
+    }
+
+    void add(double energy, std::uint64_t count = 1) {
+        if (!std::isfinite(energy)) {
+            throw std::invalid_argument("EnergyHistogram energy must be finite.");
+        }
+        if (energy < lower) {
+            underflow += count;
+        } else if (energy >= upper) {
+            overflow += count;
+        } else {
+            const auto bin = static_cast<std::size_t>((energy - lower) / bin_width());
+            counts[bin < counts.size() ? bin : counts.size() - 1] += count;
+        }
+        if (energy <= target) {
+            hits += count;
+        }
+        min_energy = energy < min_energy ? energy : min_energy;
+        max_energy = energy > max_energy ? energy : max_energy;
+    }
+
+    bool same_binning(const EnergyHistogram &other) const {
+        return lower == other.lower && upper == other.upper && target == other.target
+            && counts.size() == other.counts.size();
+    }
+
+    void merge(const EnergyHistogram &other) {
+        if (!same_binning(other)) {
+            throw std::invalid_argument("EnergyHistogram merge needs the same bins and target.");
+        }
+        for (std::size_t b = 0; b < counts.size(); ++b) {
+            counts[b] += other.counts[b];
+        }
+        underflow += other.underflow;
+        overflow += other.overflow;
+        hits += other.hits;
+        min_energy = other.min_energy < min_energy ? other.min_energy : min_energy;
+        max_energy = other.max_energy > max_energy ? other.max_energy : max_energy;
+    }
+};
+
+}
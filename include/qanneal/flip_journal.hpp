@@ -0,0 +1,46 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include "qanneal/state.hpp"
+
+namespace qanneal {
+
+// Accepted flips since the last sweep boundary. Engines mark the position of
+// each new best energy and rebuild the best state once at the end of the
+// sweep, instead of copying the whole State on every improvement.
+class FlipJournal {
+public:
+    void reserve(std::size_t flips) { flips_.reserve(flips); }
+
+    void record(std::size_t spin) { flips_.push_back(spin); }
+    // The configuration after the latest recorded flip is the best so far.
+    void mark_best() { best_mark_ = flips_.size(); }
+    bool has_best() const { return best_mark_ != kNoMark; }
+
+    // Writes the marked configuration into `best`: `current` with every flip
+    // recorded after the mark undone.
+    void rebuild_best(const State &current, State &best) const {
+        best.spins.resize(current.size());
+        std::copy(current.spins.begin(), current.spins.end(), best.spins.begin());
+        for (std::size_t k = flips_.size(); k > best_mark_; --k) {
+            auto &spin = best[flips_[k - 1]];
+            spin = static_cast<int8_t>(-spin);
+        }
+    }
+
+    void clear() {
+        flips_.clear();
+        best_mark_ = kNoMark;
+    }
+
+private:
+    static constexpr std::size_t kNoMark = static_cast<std::size_t>(-1);
+
+    std::vector<std::size_t> flips_;
+    std::size_t best_mark_ = kNoMark;
+};
+
+} // namespace qanneal
@@ -2,11 +2,25 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <stdexcept>
+#include <vector>
 
 #include "qanneal/state.hpp"
 
 namespace qanneal {
 
+// Compressed-row view of the Ising coefficients for algorithms that walk the
+// interaction graph (cluster moves, local search). Row i lists every j with
+// J_ij != 0, so each coupling appears once per endpoint.
+struct CouplingGraph {
+    std::vector<double> h;
+    std::vector<std::size_t> offsets;  // size() + 1 entries
+    std::vector<std::size_t> neighbors;
+    std::vector<double> weights;
+
+    std::size_t size() const { return h.size(); }
+};
+
 class Hamiltonian {
 public:
     virtual ~Hamiltonian() = default;
@@ -15,6 +29,10 @@ public:
     virtual double delta_energy(const int8_t *spins, std::size_t n, std::size_t flip) const = 0;
     virtual std::size_t size() const = 0;
 
+    virtual CouplingGraph coupling_graph() const {
+        throw std::runtime_error("Hamiltonian does not expose a coupling graph.");
+    }
+
     double energy(const State &state) const {
         return energy(state.spins.data(), state.size());
     }
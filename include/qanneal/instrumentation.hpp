@@ -0,0 +1,187 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "qanneal/perf_counters.hpp"
+
+#ifndef QANNEAL_ENABLE_INSTRUMENTATION
+#define QANNEAL_ENABLE_INSTRUMENTATION 1
+#endif
+
+namespace qanneal {
+
+// Hot-path counters for one schedule step (one PT step). Fields an engine
+// has no use for stay zero.
+struct StepCounters {
+    std::uint64_t attempted_flips = 0;
+    std::uint64_t accepted_flips = 0;
+    std::uint64_t swap_attempts = 0;
+    std::uint64_t swap_accepts = 0;
+    std::uint64_t worldline_attempts = 0;
+    std::uint64_t worldline_accepts = 0;
+    std::uint64_t sweep_ns = 0;
+    std::uint64_t observer_ns = 0;
+    // Recomputing energies after the sweeps, which only SQAAnnealer does;
+    // the classical engines update energies flip by flip.
+    std::uint64_t energy_ns = 0;
+    // Hardware events during the sweeps of the engine thread; zero unless
+    // hardware counters are switched on and permitted.
+    std::uint64_t cycles = 0;
+    std::uint64_t instructions = 0;
+    std::uint64_t llc_misses = 0;
+    std::uint64_t branch_misses = 0;
+
+    StepCounters &operator+=(const StepCounters &other) {
+        attempted_flips += other.attempted_flips;
+        accepted_flips += other.accepted_flips;
+        swap_attempts += other.swap_attempts;
+        swap_accepts += other.swap_accepts;
+        worldline_attempts += other.worldline_attempts;
+        worldline_accepts += other.worldline_accepts;
+        sweep_ns += other.sweep_ns;
+        observer_ns += other.observer_ns;
+        energy_ns += other.energy_ns;
+        cycles += other.cycles;
+        instructions += other.instructions;
+        llc_misses += other.llc_misses;
+        branch_misses += other.branch_misses;
+        return *this;
+    }
+};
+
+inline StepCounters sum_counters(const std::vector<StepCounters> &trace) {
+    StepCounters total;
+    for (const auto &counters : trace) {
+        total += counters;
+    }
+    return total;
+}
+
+namespace instrumentation {
+
+// Built with -DQANNEAL_ENABLE_INSTRUMENTATION=0 every helper below is an
+// empty inline function and results carry no step counters.
+inline constexpr bool enabled = QANNEAL_ENABLE_INSTRUMENTATION != 0;
+
+// Process-wide switch for hardware counters around engine sweeps; off by
+// default since each step then costs a few read() system calls.
+void set_hardware_counters(bool on);
+bool hardware_counters();
+// The calling thread's perf counters, opened on first use. Null while the
+// switch is off, when the kernel refuses them, or when instrumentation is
+// compiled out.
+const PerfCounters *thread_perf_counters();
+// Why thread_perf_counters() is null, or "ok".
+std::string hardware_counter_status();
+
+// Counters of the calling thread since the last finish_step().
+inline StepCounters &local() {
+    thread_local StepCounters counters;
+    return counters;
+}
+
+inline std::uint64_t now_ns() {
+    if constexpr (enabled) {
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    } else {
+        return 0;
+    }
+}
+
+inline void add(std::uint64_t StepCounters::*field, std::uint64_t amount) {
+    if constexpr (enabled) {
+        local().*field += amount;
+    }
+}
+
+inline void add(const StepCounters &counters) {
+    if constexpr (enabled) {
+        local() += counters;
+    }
+}
+
+inline void reset() {
+    if constexpr (enabled) {
+        local() = StepCounters{};
+    }
+}
+
+// Moves the calling thread's counters into `target`. Worker threads call
+// this at the end of a parallel region; calls may run concurrently.
+inline void merge_local(StepCounters &target) {
+    if constexpr (enabled) {
+        static std::mutex mutex;
+        std::lock_guard<std::mutex> lock(mutex);
+        target += local();
+        local() = StepCounters{};
+    }
+}
+
+// Appends the calling thread's counters as the next step and resets them.
+inline void finish_step(std::vector<StepCounters> &trace) {
+    if constexpr (enabled) {
+        trace.push_back(local());
+        local() = StepCounters{};
+    }
+}
+
+// Steps restored from a checkpoint ran in another process; they get zeroed
+// entries so the trace stays aligned with the schedule.
+inline void skip_steps(std::vector<StepCounters> &trace, std::size_t steps) {
+    if constexpr (enabled) {
+        trace.assign(steps, StepCounters{});
+    }
+}
+
+// Splits wall time between the StepCounters *_ns fields.
+class PhaseTimer {
+public:
+    PhaseTimer() : mark_(now_ns()) {
+        if constexpr (enabled) {
+            perf_ = thread_perf_counters();
+            if (perf_) {
+                perf_mark_ = perf_->read();
+            }
+        }
+    }
+
+    // Charges the time since the previous lap (or construction) to `field`.
+    void lap(std::uint64_t StepCounters::*field) {
+        if constexpr (enabled) {
+            const std::uint64_t now = now_ns();
+            local().*field += now - mark_;
+            mark_ = now;
+        }
+    }
+
+    // Laps into sweep_ns and, with hardware counters on, charges the events
+    // since construction to the hardware fields. Engines sweep first in
+    // every step, so that is the sweep phase.
+    void end_sweeps() {
+        lap(&StepCounters::sweep_ns);
+        if constexpr (enabled) {
+            if (perf_) {
+                const PerfCounts d = PerfCounters::difference(perf_->read(), perf_mark_);
+                auto &counters = local();
+                counters.cycles += d.cycles > 0 ? static_cast<std::uint64_t>(d.cycles) : 0;
+                counters.instructions += d.instructions > 0 ? static_cast<std::uint64_t>(d.instructions) : 0;
+                counters.llc_misses += d.llc_misses > 0 ? static_cast<std::uint64_t>(d.llc_misses) : 0;
+                counters.branch_misses += d.branch_misses > 0 ? static_cast<std::uint64_t>(d.branch_misses) : 0;
+            }
+        }
+    }
+
+private:
+    std::uint64_t mark_;
+    const PerfCounters *perf_ = nullptr;
+    PerfCounts perf_mark_;
+};
+
+} // namespace instrumentation
+
+} // namespace qanneal
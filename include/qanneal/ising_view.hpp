@@ -0,0 +1,147 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+#include "qanneal/hamiltonian.hpp"
+#include "qanneal/state.hpp"
+
+namespace qanneal {
+
+// DenseIsing over coefficient arrays it does not own (a numpy buffer, a
+// memory-mapped file): h has n entries, J is row-major n x n and symmetric.
+// The arrays must outlive the view and must not change during a run.
+class DenseIsingView final : public Hamiltonian {
+public:
+    DenseIsingView(const double *h, const double *J, std::size_t n, double c = 0.0);
+
+    using Hamiltonian::energy;
+    using Hamiltonian::delta_energy;
+
+    std::size_t size() const override { return n_; }
+    double energy(const int8_t *spins, std::size_t n) const override;
+    double delta_energy(const int8_t *spins, std::size_t n, std::size_t flip) const override;
+    CouplingGraph coupling_graph() const override;
+
+    const double *h() const { return h_; }
+    const double *J() const { return J_; }
+    double constant() const { return c_; }
+
+private:
+    const double *h_;
+    const double *J_;
+    std::size_t n_;
+    double c_;
+};
+
+// Ising model over a symmetric coupling matrix in compressed sparse row
+// form (the scipy.sparse.csr_matrix layout), not owned: row i holds J_ij
+// at data[k], j = indices[k], for k in [indptr[i], indptr[i + 1]). As with
+// DenseIsing's J, each coupling is stored in both rows and diagonal
+// entries are ignored. Index is the integer type of indptr and indices.
+template <typename Index>
+class CsrIsingView final : public Hamiltonian {
+public:
+    CsrIsingView(const double *h,
+                 const Index *indptr,
+                 const Index *indices,
+                 const double *data,
+                 std::size_t n,
+                 double c = 0.0)
+        : h_(h), indptr_(indptr), indices_(indices), data_(data), n_(n), c_(c) {
+        if (n_ == 0) {
+            throw std::invalid_argument("CsrIsingView size must be > 0.");
+        }
+        if (indptr_[0] != 0) {
+            throw std::invalid_argument("CSR indptr must start at 0.");
+        }
+        for (std::size_t i = 0; i < n_; ++i) {
+            if (indptr_[i + 1] < indptr_[i]) {
+                throw std::invalid_argument("CSR indptr must be non-decreasing.");
+            }
+        }
+        for (Index k = 0; k < indptr_[n_]; ++k) {
+            if (indices_[k] < 0 || static_cast<std::size_t>(indices_[k]) >= n_) {
+                throw std::invalid_argument("CSR column index out of range.");
+            }
+        }
+    }
+
+    using Hamiltonian::energy;
+    using Hamiltonian::delta_energy;
+
+    std::size_t size() const override { return n_; }
+
+    double energy(const int8_t *spins, std::size_t n) const override {
+        if (n != n_) {
+            throw std::invalid_argument("State size mismatch.");
+        }
+        validate_spins(spins, n_);
+        double E = c_;
+        for (std::size_t i = 0; i < n_; ++i) {
+            const double s = static_cast<double>(spins[i]);
+            E += h_[i] * s;
+            for (Index k = indptr_[i]; k < indptr_[i + 1]; ++k) {
+                const auto j = static_cast<std::size_t>(indices_[k]);
+                if (j > i) {
+                    E += data_[k] * s * static_cast<double>(spins[j]);
+                }
+            }
+        }
+        return E;
+    }
+
+    double delta_energy(const int8_t *spins, std::size_t n, std::size_t flip) const override {
+        if (n != n_) {
+            throw std::invalid_argument("State size mismatch.");
+        }
+        if (flip >= n_) {
+            throw std::invalid_argument("Flip index out of range.");
+        }
+        double local = h_[flip];
+        for (Index k = indptr_[flip]; k < indptr_[flip + 1]; ++k) {
+            const auto j = static_cast<std::size_t>(indices_[k]);
+            if (j != flip) {
+                local += data_[k] * static_cast<double>(spins[j]);
+            }
+        }
+        return -2.0 * static_cast<double>(spins[flip]) * local;
+    }
+
+    CouplingGraph coupling_graph() const override {
+        CouplingGraph graph;
+        graph.h.assign(h_, h_ + n_);
+        graph.offsets.reserve(n_ + 1);
+        graph.offsets.push_back(0);
+        for (std::size_t i = 0; i < n_; ++i) {
+            for (Index k = indptr_[i]; k < indptr_[i + 1]; ++k) {
+                const auto j = static_cast<std::size_t>(indices_[k]);
+                if (j == i || data_[k] == 0.0) {
+                    continue;
+                }
+                graph.neighbors.push_back(j);
+                graph.weights.push_back(data_[k]);
+            }
+            graph.offsets.push_back(graph.neighbors.size());
+        }
+        return graph;
+    }
+
+    const double *h() const { return h_; }
+    double constant() const { return c_; }
+
+private:
+    const double *h_;
+    const Index *indptr_;
+    const Index *indices_;
+    const double *data_;
+    std::size_t n_;
+    double c_;
+};
+
+// scipy uses 32-bit indices unless the matrix needs 64.
+extern template class CsrIsingView<std::int32_t>;
+extern template class CsrIsingView<std::int64_t>;
+
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "qanneal/hamiltonian.hpp"
+#include "qanneal/state.hpp"
+
+namespace qanneal {
+
+enum class PolishMode {
+    None,
+    SteepestDescent,
+    // Tabu search followed by steepest descent on the best state it visited.
+    Tabu
+};
+
+struct PolishOptions {
+    PolishMode mode = PolishMode::None;
+    std::size_t tabu_iterations = 1000;
+    // Iterations a flipped spin stays tabu; clamped to n - 1.
+    std::size_t tabu_tenure = 10;
+    // Polish independent states (replicas) on separate threads.
+    bool parallel = false;
+};
+
+// Single-flip local search on maintained local fields: every flip delta is an
+// O(1) lookup and a flip updates only the neighbours of the flipped spin.
+class LocalSearch {
+public:
+    explicit LocalSearch(CouplingGraph graph);
+
+    std::size_t size() const { return graph_.size(); }
+
+    // Each function takes the current energy of `state` and returns the
+    // energy after the search.
+    double steepest_descent(State &state, double energy) const;
+    double tabu_search(State &state,
+                       double energy,
+                       std::size_t iterations,
+                       std::size_t tenure) const;
+    double polish(State &state, double energy, const PolishOptions &options) const;
+
+    // Polishes every state in place, across threads if options.parallel.
+    void polish_all(std::vector<State> &states,
+                    std::vector<double> &energies,
+                    const PolishOptions &options) const;
+
+private:
+    CouplingGraph graph_;
+
+    void compute_fields(const State &state, std::vector<double> &fields) const;
+    void flip(State &state, std::vector<double> &fields, std::size_t idx) const;
+};
+
+} // namespace qanneal
@@ -12,6 +12,7 @@ class MetricsObserver : public Observer {
 public:
     std::vector<double> energy_trace;
     std::vector<double> magnetization_trace;
+    std::vector<StepCounters> counter_trace;
 
     void record(std::size_t step,
                 double beta,
@@ -23,9 +24,15 @@ public:
         magnetization_trace.push_back(magnetization(state));
     }
 
+    void record_counters(std::size_t step, const StepCounters &counters) override {
+        (void)step;
+        counter_trace.push_back(counters);
+    }
+
     void clear() {
         energy_trace.clear();
         magnetization_trace.clear();
+        counter_trace.clear();
     }
 };
 
@@ -33,6 +40,7 @@ class SQAMetricsObserver : public SQAObserver {
 public:
     std::vector<double> energy_trace;
     std::vector<double> magnetization_trace;
+    std::vector<StepCounters> counter_trace;
 
     void record(std::size_t step,
                 double beta,
@@ -60,9 +68,15 @@ public:
         magnetization_trace.push_back(denom > 0.0 ? sum / denom : 0.0);
     }
 
+    void record_counters(std::size_t step, const StepCounters &counters) override {
+        (void)step;
+        counter_trace.push_back(counters);
+    }
+
     void clear() {
         energy_trace.clear();
         magnetization_trace.clear();
+        counter_trace.clear();
     }
 };
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <stdexcept>
+#include <string>
 
 #include <mpi.h>
 
@@ -12,10 +13,12 @@ public:
         int initialized = 0;
         MPI_Initialized(&initialized);
         if (!initialized) {
-            if (MPI_Init(&argc, &argv) != MPI_SUCCESS) {
+            if (MPI_Init_thread(&argc, &argv, MPI_THREAD_FUNNELED, &provided_) != MPI_SUCCESS) {
                 throw std::runtime_error("MPI_Init failed.");
             }
             owns_ = true;
+        } else {
+            MPI_Query_thread(&provided_);
         }
     }
 
@@ -23,10 +26,12 @@ public:
         int initialized = 0;
         MPI_Initialized(&initialized);
         if (!initialized) {
-            if (MPI_Init(nullptr, nullptr) != MPI_SUCCESS) {
+            if (MPI_Init_thread(nullptr, nullptr, MPI_THREAD_FUNNELED, &provided_) != MPI_SUCCESS) {
                 throw std::runtime_error("MPI_Init failed.");
             }
             owns_ = true;
+        } else {
+            MPI_Query_thread(&provided_);
         }
     }
 
@@ -52,8 +57,24 @@ public:
 
     void barrier() const { MPI_Barrier(MPI_COMM_WORLD); }
 
+    // Thread support MPI was initialized with; worker threads that never
+    // call MPI need MPI_THREAD_FUNNELED (see require_funneled).
+    int thread_level() const { return provided_; }
+
 private:
     bool owns_ = false;
+    int provided_ = MPI_THREAD_SINGLE;
 };
 
+// Throws unless MPI runs with at least MPI_THREAD_FUNNELED, which the
+// drivers that anneal on threads beside the MPI thread need. An MPI that
+// grants only MPI_THREAD_SINGLE may not tolerate those threads at all.
+inline void require_funneled(const char *what) {
+    int provided = MPI_THREAD_SINGLE;
+    MPI_Query_thread(&provided);
+    if (provided < MPI_THREAD_FUNNELED) {
+        throw std::runtime_error(std::string(what) + " needs MPI_THREAD_FUNNELED; MPI was initialized with less.");
+    }
+}
+
 } // namespace qanneal::mpi
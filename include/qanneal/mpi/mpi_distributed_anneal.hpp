@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "qanneal/mpi/mpi_distributed_ising.hpp"
+#include "qanneal/schedule.hpp"
+
+namespace qanneal::mpi {
+
+struct DistributedAnnealSummary {
+    int rank = 0;
+    int size = 1;
+    // Total energy after each schedule step, the same on every rank.
+    std::vector<double> energy_trace;
+    double best_energy = 0.0;
+    // This rank's owned spins at the best step; assemble the full state
+    // with DistributedSparseIsing::gather_state.
+    std::vector<int8_t> best_local_spins;
+    std::size_t sweeps = 0;
+};
+
+// Simulated annealing of one distributed Hamiltonian, every rank working
+// on its own spins. A sweep visits the colors in turn; for each color the
+// rank updates its interior spins while the previous color's boundary
+// spins are still in flight to the neighboring ranks, then waits for the
+// ghosts and updates its boundary spins. The energy is tracked per rank
+// from the accepted deltas and summed once per step.
+DistributedAnnealSummary run_distributed_anneal(DistributedSparseIsing &hamiltonian,
+                                                const AnnealSchedule &schedule,
+                                                std::size_t sweeps_per_beta,
+                                                std::uint64_t seed = 0);
+
+} // namespace qanneal::mpi
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <mpi.h>
+
+#include "qanneal/sparse_ising.hpp"
+#include "qanneal/state.hpp"
+
+namespace qanneal::mpi {
+
+// A relabeling of the spins into `parts` contiguous blocks: new index k is
+// original spin order[k], and part p holds new indices
+// [offsets[p], offsets[p + 1]).
+struct SpinPartition {
+    std::vector<std::size_t> order;
+    std::vector<std::size_t> offsets;
+};
+
+// Breadth-first (Cuthill-McKee) ordering of the coupling graph cut into
+// balanced blocks, so that neighbors mostly land in the same block and the
+// boundary between blocks stays small on mesh-like graphs. Deterministic.
+SpinPartition partition_spins(const SparseIsing &hamiltonian, std::size_t parts);
+
+// One rank's share of a SparseIsing distributed over `comm`. Each rank owns
+// a contiguous range of (partitioned) spin indices and stores only their
+// fields, their couplings and a ghost copy of every spin of another rank
+// they couple to, so memory per rank scales as 1/P.
+//
+// Local spin arrays hold the owned spins first, then the ghosts
+// (local_size() entries). Spins are colored so that no two coupled spins
+// share a color, on any rank: spins of one color can all be updated at
+// once, and after each color only that color's boundary spins need to be
+// sent to the neighboring ranks.
+class DistributedSparseIsing {
+public:
+    // Partitions `global` with partition_spins and keeps this rank's part.
+    // Every rank must pass the same Hamiltonian, so the whole problem has to
+    // fit on each of them; see the next constructor when it does not.
+    DistributedSparseIsing(const SparseIsing &global, MPI_Comm comm = MPI_COMM_WORLD);
+    // Partitions `global` on `root` only and scatters each rank its fields
+    // and couplings; `global` is only read on `root`, the other ranks may
+    // pass nullptr. Collective over `comm`.
+    DistributedSparseIsing(const SparseIsing *global, MPI_Comm comm = MPI_COMM_WORLD, int root = 0);
+
+    // From an already partitioned problem: this rank owns global spins
+    // [offsets[rank], offsets[rank + 1]), `h` holds their fields and `edges`
+    // every coupling with at least one owned end (in global indices; a
+    // coupling between two ranks is passed to both). `original_ids` maps
+    // owned spins back to the caller's labels for gather_state() (defaults
+    // to the global indices). `c` is added once, on rank 0.
+    DistributedSparseIsing(std::vector<std::size_t> offsets,
+                           std::vector<double> h,
+                           const std::vector<SparseEdge> &edges,
+                           MPI_Comm comm = MPI_COMM_WORLD,
+                           double c = 0.0,
+                           std::vector<std::size_t> original_ids = {});
+
+    MPI_Comm comm() const { return comm_; }
+    int rank() const { return rank_; }
+    std::size_t global_size() const { return offsets_.back(); }
+    std::size_t num_owned() const { return h_.size(); }
+    std::size_t num_ghosts() const { return ghost_global_.size(); }
+    std::size_t local_size() const { return num_owned() + num_ghosts(); }
+    std::size_t num_colors() const { return static_cast<std::size_t>(colors_); }
+    // Original label of owned spin i.
+    std::size_t original_id(std::size_t i) const { return original_ids_[i]; }
+
+    // Owned spins of one color, without and with a coupling to a ghost.
+    const std::vector<std::size_t> &interior(std::size_t color) const { return interior_[color]; }
+    const std::vector<std::size_t> &boundary(std::size_t color) const { return boundary_[color]; }
+
+    double delta_energy(const int8_t *local_spins, std::size_t i) const {
+        double field = h_[i];
+        for (std::size_t k = row_[i]; k < row_[i + 1]; ++k) {
+            field += weight_[k] * static_cast<double>(local_spins[col_[k]]);
+        }
+        return -2.0 * static_cast<double>(local_spins[i]) * field;
+    }
+    // This rank's share of the energy; the shares sum to the total.
+    double partial_energy(const int8_t *local_spins) const;
+    // Total energy, summed over ranks (collective).
+    double energy(const int8_t *local_spins) const;
+
+    // Non-blocking halo exchange of one color's boundary spins: post_halo
+    // sends them and posts the matching ghost receives, wait_halo completes
+    // them. One exchange may be in flight at a time.
+    void post_halo(int8_t *local_spins, std::size_t color);
+    void wait_halo();
+    // Refreshes every ghost (blocking).
+    void exchange_all(int8_t *local_spins);
+
+    // Assembles the full state in original labels on `root`; other ranks
+    // get an empty State (collective).
+    State gather_state(const int8_t *local_spins, int root = 0) const;
+
+private:
+    struct Neighbor {
+        int rank = 0;
+        // Owned spins the neighbor needs / ghost slots it fills, both
+        // ordered by global index, per color.
+        std::vector<std::vector<std::size_t>> send;
+        std::vector<std::vector<std::size_t>> recv;
+    };
+
+    MPI_Comm comm_;
+    int rank_ = 0;
+    int size_ = 1;
+    std::vector<std::size_t> offsets_;
+    std::vector<std::size_t> original_ids_;
+    std::vector<double> h_;
+    double c_ = 0.0;
+    // CSR over owned spins, columns in local indices.
+    std::vector<std::size_t> row_;
+    std::vector<std::size_t> col_;
+    std::vector<double> weight_;
+    std::vector<std::size_t> ghost_global_;
+    std::vector<Neighbor> neighbors_;
+    int colors_ = 0;
+    std::vector<int> color_;  // per local spin
+    std::vector<std::vector<std::size_t>> interior_;
+    std::vector<std::vector<std::size_t>> boundary_;
+
+    // In-flight halo exchange.
+    std::vector<std::vector<int8_t>> send_buffers_;
+    std::vector<std::vector<int8_t>> recv_buffers_;
+    std::vector<MPI_Request> requests_;
+    int8_t *pending_spins_ = nullptr;
+    std::size_t pending_color_ = 0;
+
+    void build(const std::vector<SparseEdge> &edges);
+    void color_spins();
+    std::size_t global_id(std::size_t local) const;
+};
+
+} // namespace qanneal::mpi
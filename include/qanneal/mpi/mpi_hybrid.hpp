@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <mpi.h>
+
+#include "qanneal/mpi/mpi_replica.hpp"
+
+namespace qanneal::mpi {
+
+struct HybridOptions {
+    // Worker threads per rank; 0 takes the OpenMP thread count when
+    // OMP_NUM_THREADS is set, and otherwise every core this rank may run on.
+    std::size_t threads = 0;
+    // Pin worker t to the t-th core of the rank's share.
+    bool pin_threads = true;
+};
+
+// Where this rank and its workers run. Ranks sharing a node split the
+// cores the process may use into contiguous slices, so one rank per NUMA
+// domain gets that domain's cores on the usual core numbering. A launcher
+// that already bound the rank to a subset of the node (srun --cpu-bind,
+// mpirun --bind-to) is respected as is.
+struct HybridLayout {
+    int rank = 0;
+    int size = 1;
+    int node_rank = 0;
+    int node_size = 1;
+    std::size_t threads = 1;
+    // Core of each worker, or -1 when not pinned.
+    std::vector<int> cores;
+};
+
+HybridLayout discover_layout(const HybridOptions &options = {}, MPI_Comm comm = MPI_COMM_WORLD);
+
+struct MPIHybridSummary : MPIReplicaSummary {
+    HybridLayout layout;
+};
+
+// run_replica_anneal with one rank per node (or NUMA domain) instead of
+// one per core: the rank's replicas are split over pinned worker threads
+// that share a single copy of the Hamiltonian. Each worker allocates its
+// own replica states after pinning, so first touch places them on the
+// worker's NUMA node. Workers do not call MPI, so MPI_THREAD_FUNNELED is
+// enough (MPIContext asks for it); with less this throws.
+MPIHybridSummary run_hybrid_replica_anneal(const Hamiltonian &hamiltonian,
+                                           AnnealSchedule schedule,
+                                           std::size_t sweeps_per_beta,
+                                           std::size_t replicas_per_rank,
+                                           std::uint64_t seed = 0,
+                                           MPI_Comm comm = MPI_COMM_WORLD,
+                                           HybridOptions options = {});
+
+} // namespace qanneal::mpi
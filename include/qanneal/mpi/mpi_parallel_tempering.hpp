@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <mpi.h>
+
+#include "qanneal/hamiltonian.hpp"
+#include "qanneal/state.hpp"
+
+namespace qanneal::mpi {
+
+struct MPIParallelTemperingSummary {
+    int rank = 0;
+    int size = 1;
+    // Temperature index and energy of each replica this rank holds at the
+    // end; the replicas never leave their rank, only their labels move.
+    std::vector<std::size_t> local_temperatures;
+    std::vector<double> local_energies;
+    // Energy of the replica holding each temperature at the end, on every
+    // rank.
+    std::vector<double> temperature_energies;
+    // Swaps between temperatures t and t + 1, summed over ranks.
+    std::vector<std::uint64_t> swap_attempts;
+    std::vector<std::uint64_t> swap_accepts;
+    double global_best_energy = 0.0;
+    State global_best_state;
+};
+
+// Parallel tempering over the ranks of `comm`. The ladder `betas` (the same
+// on every rank) starts split into contiguous blocks, one per rank, so
+// there must be at least as many temperatures as ranks. Each rank sweeps
+// the replicas it owns; a swap between neighboring temperatures exchanges
+// only the two energies and then the beta labels, so spin vectors never
+// cross the network. Every message goes to the rank holding a neighboring
+// temperature and is non-blocking: energies are sent as soon as a replica
+// finishes its sweeps, and the bookkeeping that tells ladder neighbors
+// where a label went completes while the next sweep runs.
+//
+// The energy exchange itself does not overlap the next sweep: a swap step
+// ends by waiting for the partners' energies and deciding, because a
+// replica that swept on at its old temperature first would swap on stale
+// energies, which breaks detailed balance. Each swap step therefore costs
+// one energy round trip to the slowest partner, less whatever the rank's
+// later replicas' sweeps already hid; a larger swap_interval amortizes it.
+//
+// Both sides of a swap draw the same acceptance number from `seed`, so
+// they agree without a further message. seed == 0 picks one at random.
+MPIParallelTemperingSummary run_parallel_tempering(const Hamiltonian &hamiltonian,
+                                                   std::vector<double> betas,
+                                                   std::size_t sweeps_per_step,
+                                                   std::size_t steps,
+                                                   std::size_t swap_interval = 1,
+                                                   std::uint64_t seed = 0,
+                                                   MPI_Comm comm = MPI_COMM_WORLD);
+
+} // namespace qanneal::mpi
@@ -10,6 +10,21 @@
 
 namespace qanneal::mpi {
 
+enum class IslandTopology {
+    Ring,    // rank r sends to r + 1
+    Random,  // rank r sends to r + k, k drawn afresh for every migration
+};
+
+// Island model: every `interval` schedule steps each rank sends its
+// `migrants` lowest-energy replicas to a neighbor rank, which reseeds its
+// worst replicas with them where that lowers their energy. The spins
+// travel bit-packed and the transfer overlaps the next step's sweeps.
+struct IslandOptions {
+    std::size_t interval = 0;  // 0 keeps the ranks isolated
+    std::size_t migrants = 1;
+    IslandTopology topology = IslandTopology::Ring;
+};
+
 struct MPIReplicaSummary {
     int rank = 0;
     int size = 1;
@@ -17,13 +32,21 @@ struct MPIReplicaSummary {
     State local_best_state;
     double global_best_energy = 0.0;
     State global_best_state;
+    // Migrants this rank received and kept (island mode only).
+    std::size_t migrants_received = 0;
+    std::size_t migrants_accepted = 0;
 };
 
+// Fills the global best of every rank's summary from the local bests: the
+// lowest energy, and its state broadcast from the rank that found it.
+void reduce_global_best(MPIReplicaSummary &summary, std::size_t n, MPI_Comm comm);
+
 MPIReplicaSummary run_replica_anneal(const Hamiltonian &hamiltonian,
                                      AnnealSchedule schedule,
                                      std::size_t sweeps_per_beta,
                                      std::size_t replicas_per_rank,
                                      std::uint64_t seed = 0,
-                                     MPI_Comm comm = MPI_COMM_WORLD);
+                                     MPI_Comm comm = MPI_COMM_WORLD,
+                                     IslandOptions island = {});
 
 } // namespace qanneal::mpi
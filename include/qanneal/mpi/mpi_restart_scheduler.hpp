@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include <mpi.h>
+
+#include "qanneal/hamiltonian.hpp"
+#include "qanneal/schedule.hpp"
+#include "qanneal/state.hpp"
+#include "qanneal/stop_criteria.hpp"
+
+namespace qanneal::mpi {
+
+struct RestartSchedulerOptions {
+    // Independent Annealer restarts in total; restart r is seeded with
+    // seed + r, so results do not depend on which rank ran it.
+    std::size_t restarts = 1;
+    // Restarts handed out per request. Larger batches mean fewer messages,
+    // smaller ones a tighter finish.
+    std::size_t batch = 1;
+    // Wall-clock budget in seconds for the whole job, measured from the
+    // start of the call; <= 0 disables it. Running restarts stop at the
+    // deadline and no new ones start.
+    double time_limit = 0.0;
+    // Stop handing out restarts once any restart reaches this energy.
+    double target_energy = -std::numeric_limits<double>::infinity();
+    // 0 picks one at random.
+    std::uint64_t seed = 0;
+};
+
+struct MPIRestartSummary {
+    int rank = 0;
+    int size = 1;
+    // Work done by this rank.
+    std::size_t local_restarts = 0;
+    std::size_t local_batches = 0;
+    std::size_t local_sweeps = 0;
+    double local_busy_seconds = 0.0;
+    // Per rank, on every rank.
+    std::vector<std::size_t> restarts_per_rank;
+    std::vector<double> busy_seconds_per_rank;
+    std::size_t restarts_completed = 0;
+    double elapsed_seconds = 0.0;
+    double global_best_energy = 0.0;
+    State global_best_state;
+    // Restart that found the global best.
+    std::size_t best_restart = 0;
+    // Completed, TimeLimit or TargetEnergy.
+    StopReason stop_reason = StopReason::Completed;
+};
+
+// Load-balanced restarts over the ranks of `comm`. Rank 0 hands out
+// batches of restarts on demand and every other rank asks for its next
+// batch as soon as it starts the current one, so a fast rank simply runs
+// more batches and no rank waits for the slowest at the end. Each batch's
+// best is streamed back to rank 0 as soon as the batch finishes. Rank 0
+// anneals too: its main thread serves requests (only that thread calls MPI,
+// so MPI_THREAD_FUNNELED suffices; with less this throws) while a second
+// thread runs batches. If a batch throws on any rank, no further batches
+// are handed out and every rank throws.
+MPIRestartSummary run_scheduled_restarts(const Hamiltonian &hamiltonian,
+                                         AnnealSchedule schedule,
+                                         std::size_t sweeps_per_beta,
+                                         RestartSchedulerOptions options,
+                                         MPI_Comm comm = MPI_COMM_WORLD);
+
+} // namespace qanneal::mpi
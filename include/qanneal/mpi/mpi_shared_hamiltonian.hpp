@@ -0,0 +1,134 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+#include <mpi.h>
+
+#include "qanneal/dense_ising.hpp"
+#include "qanneal/hamiltonian.hpp"
+#include "qanneal/sparse_ising.hpp"
+
+namespace qanneal::mpi {
+
+// One block of memory per node, in an MPI_Win_allocate_shared window over
+// the ranks of `comm` that share the node. The node leader (the lowest rank
+// of `comm` on the node) owns the storage; every rank on the node maps it.
+// Creating and destroying a window are collective over `comm`, so a window
+// must be destroyed before MPI_Finalize, on every rank.
+class NodeSharedWindow {
+public:
+    NodeSharedWindow(std::size_t bytes, MPI_Comm comm);
+    ~NodeSharedWindow();
+
+    NodeSharedWindow(const NodeSharedWindow &) = delete;
+    NodeSharedWindow &operator=(const NodeSharedWindow &) = delete;
+
+    bool leader() const { return node_rank_ == 0; }
+    MPI_Comm node_comm() const { return node_; }
+    void *data() const { return data_; }
+    std::size_t bytes() const { return bytes_; }
+
+    // Publishes the leader's writes to the other ranks on the node
+    // (collective over the node). Returns the leader's `ok` on every rank,
+    // so a failed fill can be reported everywhere instead of deadlocking.
+    bool publish(bool ok = true);
+
+private:
+    MPI_Comm node_ = MPI_COMM_NULL;
+    MPI_Win win_ = MPI_WIN_NULL;
+    int node_rank_ = 0;
+    void *data_ = nullptr;
+    std::size_t bytes_ = 0;
+};
+
+// DenseIsing whose h and J live once per node instead of once per rank, so
+// a node of R ranks holds one n x n matrix rather than R. Every rank gets a
+// read-only view; pass it to any engine or to run_replica_anneal.
+class SharedDenseIsing final : public Hamiltonian {
+public:
+    // Writes h (n entries) and the row-major n x n J; runs on the node
+    // leaders only, so the coefficients can be generated or read from disk
+    // without ever materializing a second copy. If it throws on any node
+    // leader, the constructor throws on every rank of `comm`.
+    using Fill = std::function<void(double *h, double *J)>;
+
+    // Collective over `comm`; n and c must agree on every rank.
+    SharedDenseIsing(std::size_t n, const Fill &fill, double c = 0.0, MPI_Comm comm = MPI_COMM_WORLD);
+    // Copies `source`, which is only read on the node leaders; the other
+    // ranks may pass nullptr.
+    SharedDenseIsing(const DenseIsing *source, MPI_Comm comm = MPI_COMM_WORLD);
+
+    using Hamiltonian::energy;
+    using Hamiltonian::delta_energy;
+
+    std::size_t size() const override { return n_; }
+    double energy(const int8_t *spins, std::size_t n) const override;
+    double delta_energy(const int8_t *spins, std::size_t n, std::size_t flip) const override;
+    CouplingGraph coupling_graph() const override;
+
+    const double *h() const { return h_; }
+    const double *J() const { return J_; }
+    double constant() const { return c_; }
+
+private:
+    std::size_t n_ = 0;
+    double c_ = 0.0;
+    NodeSharedWindow window_;
+    const double *h_ = nullptr;
+    const double *J_ = nullptr;
+
+    struct Shape {
+        std::uint64_t n;
+        double c;
+    };
+    static Shape shape(const DenseIsing *source, MPI_Comm comm);
+    SharedDenseIsing(const DenseIsing *source, const Shape &shape, MPI_Comm comm);
+    void validate(std::size_t n, std::size_t flip) const;
+};
+
+// SparseIsing stored once per node as a compressed-row coupling graph.
+class SharedSparseIsing final : public Hamiltonian {
+public:
+    // Copies `source`, which is only read on the node leaders; the other
+    // ranks may pass nullptr. Collective over `comm`.
+    SharedSparseIsing(const SparseIsing *source, MPI_Comm comm = MPI_COMM_WORLD);
+
+    using Hamiltonian::energy;
+    using Hamiltonian::delta_energy;
+
+    std::size_t size() const override { return n_; }
+    double energy(const int8_t *spins, std::size_t n) const override;
+    double delta_energy(const int8_t *spins, std::size_t n, std::size_t flip) const override;
+    CouplingGraph coupling_graph() const override;
+
+    const double *h() const { return h_; }
+    double constant() const { return c_; }
+    // Row i of the graph is [offsets()[i], offsets()[i + 1]) of neighbors()
+    // and weights(); every coupling appears once per endpoint.
+    const std::uint64_t *offsets() const { return offsets_; }
+    const std::uint64_t *neighbors() const { return neighbors_; }
+    const double *weights() const { return weights_; }
+
+private:
+    std::size_t n_ = 0;
+    std::size_t entries_ = 0;
+    double c_ = 0.0;
+    NodeSharedWindow window_;
+    const double *h_ = nullptr;
+    const double *weights_ = nullptr;
+    const std::uint64_t *offsets_ = nullptr;
+    const std::uint64_t *neighbors_ = nullptr;
+
+    struct Shape {
+        std::uint64_t n;
+        std::uint64_t entries;
+        double c;
+    };
+    static Shape shape(const SparseIsing *source, MPI_Comm comm);
+    SharedSparseIsing(const SparseIsing *source, const Shape &shape, MPI_Comm comm);
+    void validate(std::size_t n, std::size_t flip) const;
+};
+
+} // namespace qanneal::mpi
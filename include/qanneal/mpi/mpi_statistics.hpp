@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <mpi.h>
+
+#include "qanneal/energy_histogram.hpp"
+#include "qanneal/sample_set.hpp"
+
+namespace qanneal::mpi {
+
+// Reductions of per-rank run statistics. Each is a tree reduction (with a
+// custom MPI_Op where summing is not enough), so the cost grows with log P
+// rather than P and no rank ever holds every rank's data. All are
+// collective over `comm` and leave the merged result on every rank.
+
+// Adds the histograms of every rank, which must share the same bins and
+// target.
+void allreduce_histogram(EnergyHistogram &histogram, MPI_Comm comm = MPI_COMM_WORLD);
+
+// Statistics across every trace of every rank, per step. Traces may have
+// different lengths (runs that stopped early); counts[t] says how many
+// reached step t.
+struct TraceStatistics {
+    std::vector<std::uint64_t> counts;
+    std::vector<double> mean;
+    std::vector<double> stddev;
+    std::vector<double> min;
+    std::vector<double> max;
+};
+
+TraceStatistics allreduce_traces(const std::vector<std::vector<double>> &traces,
+                                 MPI_Comm comm = MPI_COMM_WORLD);
+
+// Merges the sample sets of every rank, as SampleSet::merge would: the
+// `capacity` lowest distinct states overall, with counts summed over ranks
+// and offered() the total. Every rank must use the same spin count,
+// capacity and Zobrist seed. Each step of the reduction tree moves at most
+// `capacity` bit-packed states.
+void allreduce_sample_set(SampleSet &samples, MPI_Comm comm = MPI_COMM_WORLD);
+
+} // namespace qanneal::mpi
@@ -2,6 +2,7 @@
 
 #include <cstddef>
 
+#include "qanneal/instrumentation.hpp"
 #include "qanneal/state.hpp"
 
 namespace qanneal {
@@ -13,6 +14,12 @@ public:
                         double beta,
                         double energy,
                         const State &state) = 0;
+    // Called after record() with the step's counters when the library is
+    // built with instrumentation.
+    virtual void record_counters(std::size_t step, const StepCounters &counters) {
+        (void)step;
+        (void)counters;
+    }
 };
 
 }
@@ -7,17 +7,31 @@
 #include <vector>
 
 #include "qanneal/backend.hpp"
+#include "qanneal/checkpoint.hpp"
+#include "qanneal/local_search.hpp"
+#include "qanneal/cluster_moves.hpp"
+#include "qanneal/instrumentation.hpp"
+#include "qanneal/sample_set.hpp"
 #include "qanneal/state.hpp"
+#include "qanneal/stop_criteria.hpp"
 
 namespace qanneal {
 
 struct ParallelTemperingResult {
+    // One state per beta, or two per beta (copy-major) with Houdayer moves.
     std::vector<State> final_states;
     std::vector<double> final_energies;
     State best_state;
     double best_energy = 0.0;
     std::vector<double> average_energy_trace;
     std::vector<double> swap_acceptance_trace;
+    // Mean number of spins flipped per cluster move, 0 on steps without one.
+    std::vector<double> cluster_size_trace;
+    // Hot-path counters, one entry per step; empty when built without
+    // instrumentation.
+    std::vector<StepCounters> step_counters;
+    StopReason stop_reason = StopReason::Completed;
+    std::size_t sweeps = 0;
 };
 
 class ParallelTemperingAnnealer {
@@ -28,15 +42,36 @@ public:
                               std::vector<double> betas);
 
     void set_seed(std::uint64_t seed);
+    void set_cluster_moves(ClusterMoveOptions options);
+    void set_polish(PolishOptions options);
+    void set_stop_criteria(StopCriteria criteria);
+    void set_checkpoint(CheckpointOptions options);
+    // Offers the states visited during runs to `samples` (null to stop):
+    // every replica after every sweep, hashed incrementally per flip.
+    void set_sample_set(std::shared_ptr<SampleSet> samples);
 
     ParallelTemperingResult run(std::size_t sweeps_per_step,
                                 std::size_t steps,
                                 std::size_t swap_interval = 1);
+    ParallelTemperingResult resume(const std::string &path,
+                                   std::size_t sweeps_per_step,
+                                   std::size_t steps,
+                                   std::size_t swap_interval = 1);
 
 private:
     std::shared_ptr<Backend> backend_;
     std::vector<double> betas_;
+    ClusterMoveOptions cluster_;
+    PolishOptions polish_;
+    StopCriteria stop_;
+    CheckpointOptions checkpoint_;
+    std::shared_ptr<SampleSet> samples_;
     std::mt19937_64 rng_;
+
+    ParallelTemperingResult run_from(std::size_t sweeps_per_step,
+                                     std::size_t steps,
+                                     std::size_t swap_interval,
+                                     CheckpointReader *reader);
 };
 
 } // namespace qanneal
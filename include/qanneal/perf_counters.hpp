@@ -0,0 +1,50 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+namespace qanneal {
+
+// Hardware event totals; -1 marks an event that could not be opened.
+struct PerfCounts {
+    std::int64_t cycles = -1;
+    std::int64_t instructions = -1;
+    std::int64_t llc_misses = -1;
+    std::int64_t branch_misses = -1;
+};
+
+// Per-thread hardware counters via Linux perf_event_open, counting user
+// space of the calling thread only. The events form one group led by
+// cycles, so they are multiplexed onto the PMU together (ratios such as
+// IPC compare the same intervals) and read() is a single syscall. The
+// events start counting on construction; callers take differences of
+// read(). When the kernel refuses (perf_event_paranoid, containers,
+// non-Linux builds) available() is false, status() says why and read()
+// returns all -1.
+class PerfCounters {
+public:
+    PerfCounters();
+    ~PerfCounters();
+
+    PerfCounters(const PerfCounters &) = delete;
+    PerfCounters &operator=(const PerfCounters &) = delete;
+
+    bool available() const;
+    const std::string &status() const { return status_; }
+
+    PerfCounts read() const;
+
+    // Event-wise a - b, keeping -1 for events missing from either.
+    static PerfCounts difference(const PerfCounts &a, const PerfCounts &b);
+
+private:
+    static constexpr std::size_t kEvents = 4;
+    std::array<int, kEvents> fds_;
+    // Position of each event in the group read, -1 when it is missing.
+    std::array<int, kEvents> slots_;
+    int leader_ = -1;  // event whose fd leads the group
+    std::string status_;
+};
+
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "qanneal/backend.hpp"
+#include "qanneal/instrumentation.hpp"
+#include "qanneal/local_search.hpp"
+#include "qanneal/sample_set.hpp"
+#include "qanneal/schedule.hpp"
+#include "qanneal/state.hpp"
+#include "qanneal/stop_criteria.hpp"
+
+namespace qanneal {
+
+struct PopulationAnnealResult {
+    std::vector<State> final_states;
+    std::vector<double> final_energies;
+    State best_state;
+    double best_energy = 0.0;
+    std::vector<double> average_energy_trace;
+    // Free energy F(beta) = -ln Z(beta) / beta estimated from the reweighting
+    // factors, one entry per schedule step.
+    std::vector<double> free_energy_trace;
+    double log_partition = 0.0;
+    // Family statistics: a family is the set of replicas descending from the
+    // same initial replica.
+    std::vector<std::size_t> family_count_trace;
+    std::size_t surviving_families = 0;
+    double mean_square_family_size = 0.0;  // rho_t
+    double entropic_family_size = 0.0;     // rho_s
+    // Hot-path counters, one entry per step; empty when built without
+    // instrumentation.
+    std::vector<StepCounters> step_counters;
+    StopReason stop_reason = StopReason::Completed;
+    std::size_t sweeps = 0;
+};
+
+class PopulationAnnealer {
+public:
+    PopulationAnnealer(const Hamiltonian &hamiltonian,
+                       AnnealSchedule schedule,
+                       std::size_t population);
+    PopulationAnnealer(std::shared_ptr<Backend> backend,
+                       AnnealSchedule schedule,
+                       std::size_t population);
+
+    void set_seed(std::uint64_t seed);
+    void set_polish(PolishOptions options);
+    void set_stop_criteria(StopCriteria criteria);
+    // Offers the states visited during runs to `samples` (null to stop):
+    // every replica at the end of every step, hashed incrementally per flip.
+    void set_sample_set(std::shared_ptr<SampleSet> samples);
+
+    PopulationAnnealResult run(std::size_t sweeps_per_beta);
+
+private:
+    std::shared_ptr<Backend> backend_;
+    AnnealSchedule schedule_;
+    std::size_t population_ = 0;
+    PolishOptions polish_;
+    StopCriteria stop_;
+    std::shared_ptr<SampleSet> samples_;
+    std::mt19937_64 rng_;
+};
+
+} // namespace qanneal
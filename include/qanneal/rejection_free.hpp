@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "qanneal/hamiltonian.hpp"
+#include "qanneal/state.hpp"
+
+namespace qanneal {
+
+enum class UpdateMode {
+    Metropolis,
+    RejectionFree,
+    // Metropolis until the measured acceptance rate of a step drops below the
+    // threshold, rejection-free for the rest of the schedule.
+    Adaptive
+};
+
+// Fenwick tree over non-negative rates: O(log n) updates and sampling.
+class RateTree {
+public:
+    RateTree() = default;
+    explicit RateTree(std::size_t n);
+
+    std::size_t size() const { return rates_.size(); }
+    double total() const { return total_; }
+    double rate(std::size_t idx) const { return rates_[idx]; }
+
+    void set(std::size_t idx, double rate);
+    // Bulk updates: assign() only stores the rate, rebuild() refreshes the tree.
+    void assign(std::size_t idx, double rate) { rates_[idx] = rate; }
+    void rebuild();
+
+    // Index i such that the prefix sum of rates before i is <= u and the
+    // prefix sum through i is > u, for u in [0, total()).
+    std::size_t sample(double u) const;
+
+private:
+    std::vector<double> rates_;
+    std::vector<double> tree_;  // 1-based
+    std::size_t top_bit_ = 0;
+    double total_ = 0.0;
+};
+
+// Rejection-free (n-fold way / BKL) single-spin dynamics. Every move flips a
+// spin chosen in proportion to its Metropolis rate and advances simulated time
+// by the waiting time the rejected proposals would have taken.
+class RejectionFreeSampler {
+public:
+    RejectionFreeSampler() = default;
+    explicit RejectionFreeSampler(CouplingGraph graph);
+
+    std::size_t size() const { return graph_.size(); }
+
+    // Recomputes local fields and rates for `state` at `beta`.
+    void reset(const State &state, double beta);
+
+    // Performs one move. Returns the waiting time in sweeps; if it exceeds
+    // `time_left` the move is not applied and `flipped` is set to size().
+    double step(State &state,
+                double &energy,
+                double time_left,
+                std::mt19937_64 &rng,
+                std::size_t &flipped);
+
+private:
+    CouplingGraph graph_;
+    std::vector<double> fields_;
+    RateTree tree_;
+    double beta_ = 0.0;
+
+    double rate_of(std::size_t idx, int8_t spin) const;
+};
+
+} // namespace qanneal
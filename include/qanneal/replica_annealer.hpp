@@ -2,14 +2,20 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <memory>
 #include <random>
 #include <vector>
 
 #include "qanneal/backend.hpp"
+#include "qanneal/checkpoint.hpp"
+#include "qanneal/instrumentation.hpp"
+#include "qanneal/local_search.hpp"
 #include "qanneal/metrics.hpp"
+#include "qanneal/sample_set.hpp"
 #include "qanneal/schedule.hpp"
 #include "qanneal/state.hpp"
+#include "qanneal/stop_criteria.hpp"
 
 namespace qanneal {
 
@@ -26,8 +32,19 @@ struct MultiAnnealResult {
     double global_best_energy = 0.0;
     std::vector<double> average_energy_trace;
     std::vector<double> average_magnetization_trace;
+    // Hot-path counters, one entry per step; empty when built without
+    // instrumentation.
+    std::vector<StepCounters> step_counters;
+    StopReason stop_reason = StopReason::Completed;
+    std::size_t sweeps = 0;
 };
 
+// Called between schedule steps with the live replicas. It may replace
+// states, keeping energies[r] the energy of states[r].
+using MigrationHook = std::function<void(std::size_t step,
+                                         std::vector<State> &states,
+                                         std::vector<double> &energies)>;
+
 class ReplicaAnnealer {
 public:
     ReplicaAnnealer(const Hamiltonian &hamiltonian,
@@ -38,14 +55,32 @@ public:
                     std::size_t replicas);
 
     void set_seed(std::uint64_t seed);
+    void set_polish(PolishOptions options);
+    void set_stop_criteria(StopCriteria criteria);
+    void set_checkpoint(CheckpointOptions options);
+    // Offers the states visited during runs to `samples` (null to stop):
+    // every replica after every sweep, hashed incrementally per flip.
+    void set_sample_set(std::shared_ptr<SampleSet> samples);
+    // Runs `hook` after every `interval` steps except the last (null to
+    // stop). Replaced states count toward the bests.
+    void set_migration(std::size_t interval, MigrationHook hook);
 
     MultiAnnealResult run(std::size_t sweeps_per_beta);
+    MultiAnnealResult resume(const std::string &path, std::size_t sweeps_per_beta);
 
 private:
     std::shared_ptr<Backend> backend_;
     AnnealSchedule schedule_;
     std::size_t replicas_ = 0;
+    PolishOptions polish_;
+    StopCriteria stop_;
+    CheckpointOptions checkpoint_;
+    std::shared_ptr<SampleSet> samples_;
+    std::size_t migration_interval_ = 1;
+    MigrationHook migration_;
     std::mt19937_64 rng_;
+
+    MultiAnnealResult run_from(std::size_t sweeps_per_beta, CheckpointReader *reader);
 };
 
 }
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "qanneal/state.hpp"
+
+namespace qanneal {
+
+// Random 64-bit key per spin. The hash of a configuration is the XOR of the
+// keys of its down spins, so flipping spin i changes it by key(i) and
+// engines can keep it current at O(1) per flip.
+class ZobristTable {
+public:
+    ZobristTable() = default;
+    ZobristTable(std::size_t n, std::uint64_t seed);
+
+    std::size_t size() const { return keys_.size(); }
+    std::uint64_t seed() const { return seed_; }
+    std::uint64_t key(std::size_t i) const { return keys_[i]; }
+    const std::uint64_t *keys() const { return keys_.data(); }
+
+    std::uint64_t hash(const int8_t *spins, std::size_t n) const;
+    std::uint64_t hash(const State &state) const { return hash(state.spins.data(), state.size()); }
+
+private:
+    std::vector<std::uint64_t> keys_;
+    std::uint64_t seed_ = 0;
+};
+
+struct Sample {
+    State state;
+    double energy = 0.0;
+    std::uint64_t count = 0;
+};
+
+// Distinct low-energy states, each stored once with its energy and the
+// number of times it was offered. Holds at most `capacity` states: when
+// full, a new state replaces the highest-energy one if it is lower (or
+// equal with a lower hash), and is only counted in offered() otherwise.
+// A state evicted and later offered again starts a new count. States are
+// identified by their Zobrist hash alone; two configurations colliding in
+// 64 bits are merged.
+class SampleSet {
+public:
+    SampleSet(std::size_t n, std::size_t capacity, std::uint64_t seed = 0x5eed5eedULL);
+
+    std::size_t num_spins() const { return n_; }
+    std::size_t capacity() const { return capacity_; }
+    std::size_t size() const { return index_.size(); }
+    // Occurrences offered so far, kept or not.
+    std::uint64_t offered() const { return offered_; }
+    const ZobristTable &zobrist() const { return zobrist_; }
+
+    // Offers `count` occurrences of a state whose hash the caller already
+    // maintains; the spins are only read when the state is new and kept.
+    void add(const int8_t *spins, double energy, std::uint64_t hash, std::uint64_t count = 1);
+    void add(const State &state, double energy);
+
+    // Adds every state and count of `other`, which must use the same spin
+    // count and Zobrist seed.
+    void merge(const SampleSet &other);
+    // Counts occurrences seen elsewhere whose states were not kept (such as
+    // a set rebuilt from its kept samples), so offered() stays exact.
+    void add_offered(std::uint64_t count) { offered_ += count; }
+    void clear();
+
+    // Kept states by increasing energy (ties by hash).
+    std::vector<Sample> samples() const;
+    // The same order as flat arrays: spins is size() x num_spins().
+    void export_sorted(std::vector<int8_t> &spins,
+                       std::vector<double> &energies,
+                       std::vector<std::uint64_t> &counts) const;
+
+private:
+    std::size_t n_;
+    std::size_t capacity_;
+    ZobristTable zobrist_;
+    // Slot storage; an evicted state's slot is reused by its replacement.
+    std::vector<int8_t> spins_;
+    std::vector<double> energies_;
+    std::vector<std::uint64_t> counts_;
+    std::vector<std::uint64_t> hashes_;
+    std::unordered_map<std::uint64_t, std::size_t> index_;  // hash -> slot
+    std::vector<std::size_t> heap_;  // live slots, max-heap by energy
+    std::uint64_t offered_ = 0;
+
+    bool heap_less(std::size_t a, std::size_t b) const;
+    std::vector<std::size_t> sorted_slots() const;
+};
+
+}
@@ -1,16 +1,45 @@
 #pragma once
 
+#include <algorithm>
+#include <cmath>
 #include <cstddef>
+#include <cstdint>
 #include <stdexcept>
 #include <vector>
 
 namespace qanneal {
 
+class Hamiltonian;
+
 struct AnnealSchedule {
     std::vector<double> betas;
+    // Optional per-step multiplier of sweeps_per_beta; empty means 1 for
+    // every step and 0 skips a step.
+    std::vector<double> sweep_scale;
 
     std::size_t size() const { return betas.size(); }
 
+    std::size_t sweeps_at(std::size_t step, std::size_t sweeps_per_beta) const {
+        if (sweep_scale.empty()) {
+            return sweeps_per_beta;
+        }
+        const double scale = sweep_scale[step];
+        if (scale <= 0.0) {
+            return 0;
+        }
+        const double sweeps = std::round(scale * static_cast<double>(sweeps_per_beta));
+        return std::max<std::size_t>(1, static_cast<std::size_t>(sweeps));
+    }
+
+    void validate() const {
+        if (betas.empty()) {
+            throw std::invalid_argument("Schedule must contain at least one beta.");
+        }
+        if (!sweep_scale.empty() && sweep_scale.size() != betas.size()) {
+            throw std::invalid_argument("Schedule sweep_scale length mismatch.");
+        }
+    }
+
     static AnnealSchedule linear(double beta_start, double beta_end, std::size_t steps) {
         if (steps == 0) {
             throw std::invalid_argument("Schedule steps must be > 0.");
@@ -27,6 +56,60 @@ struct AnnealSchedule {
         }
         return schedule;
     }
+
+    // Betas spaced by a constant ratio; both ends must be > 0.
+    static AnnealSchedule geometric(double beta_start, double beta_end, std::size_t steps) {
+        if (steps == 0) {
+            throw std::invalid_argument("Schedule steps must be > 0.");
+        }
+        if (beta_start <= 0.0 || beta_end <= 0.0) {
+            throw std::invalid_argument("Geometric schedule betas must be > 0.");
+        }
+        AnnealSchedule schedule;
+        schedule.betas.reserve(steps);
+        if (steps == 1) {
+            schedule.betas.push_back(beta_end);
+            return schedule;
+        }
+        const double ratio = std::pow(beta_end / beta_start, 1.0 / static_cast<double>(steps - 1));
+        double beta = beta_start;
+        for (std::size_t i = 0; i < steps; ++i) {
+            schedule.betas.push_back(beta);
+            beta *= ratio;
+        }
+        schedule.betas.back() = beta_end;
+        return schedule;
+    }
 };
 
+struct BetaRange {
+    double beta_min = 0.0;
+    double beta_max = 0.0;
+};
+
+// Hot end: the largest single-flip energy increase is accepted with
+// probability 1/2. Cold end: the smallest non-zero increase is accepted with
+// probability 1/100. Both come from the coupling graph.
+BetaRange estimate_beta_range(const Hamiltonian &hamiltonian);
+
+// Geometric schedule over estimate_beta_range().
+AnnealSchedule auto_schedule(const Hamiltonian &hamiltonian, std::size_t steps);
+
+struct AdaptiveScheduleOptions {
+    // Sweeps per step of the pilot run that measures acceptance.
+    std::size_t pilot_sweeps = 1;
+    // Steps whose pilot acceptance falls below this are skipped.
+    double collapse_threshold = 1e-3;
+    // Smallest share a live step keeps, relative to the mean.
+    double min_scale = 0.25;
+    std::uint64_t seed = 0;
+};
+
+// Reallocates sweeps of `base` from a short pilot anneal: steps where the
+// acceptance rate changes fastest get more sweeps, collapsed steps get none,
+// and the total sweep budget is unchanged.
+AnnealSchedule adaptive_schedule(const Hamiltonian &hamiltonian,
+                                 AnnealSchedule base,
+                                 AdaptiveScheduleOptions options = {});
+
 }
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <vector>
+
+#include "qanneal/backend.hpp"
+#include "qanneal/hamiltonian.hpp"
+#include "qanneal/schedule.hpp"
+#include "qanneal/state.hpp"
+#include "qanneal/stop_criteria.hpp"
+#include "qanneal/thread_pool.hpp"
+
+namespace qanneal {
+
+enum class SolverEngine {
+    Annealer,
+    ParallelTempering,
+    Population
+};
+
+struct SolverJob {
+    std::shared_ptr<const Hamiltonian> hamiltonian;
+    SolverEngine engine = SolverEngine::Annealer;
+    // Annealer and Population.
+    AnnealSchedule schedule;
+    // ParallelTempering ladder and step count.
+    std::vector<double> betas;
+    std::size_t steps = 0;
+    // Population size.
+    std::size_t population = 0;
+    // sweeps_per_beta, or sweeps_per_step for parallel tempering.
+    std::size_t sweeps = 1;
+    // Independent runs, each scheduled as its own pool task; restart r is
+    // seeded with seed + r.
+    std::size_t restarts = 1;
+    std::uint64_t seed = 0;
+    // Higher runs first among waiting work; ties run in submission order.
+    int priority = 0;
+    // Cancelling stop.cancel skips restarts that have not started and stops
+    // running ones at their next sweep.
+    StopCriteria stop;
+};
+
+struct SolverJobResult {
+    State best_state;
+    double best_energy = 0.0;
+    // Per restart; skipped restarts report +infinity and Cancelled.
+    std::vector<double> restart_energies;
+    std::vector<StopReason> restart_stop_reasons;
+    // First early stop in restart order, or Completed.
+    StopReason stop_reason = StopReason::Completed;
+    std::size_t sweeps = 0;
+};
+
+// In-process asynchronous solver. Jobs are split into restarts that run on a
+// shared work-stealing pool; submit() returns immediately with a future.
+// Destroying the pool waits for every submitted job.
+class SolverPool {
+public:
+    // threads == 0 uses every hardware thread.
+    explicit SolverPool(std::size_t threads = 0);
+
+    std::size_t threads() const { return pool_.size(); }
+
+    std::future<SolverJobResult> submit(SolverJob job);
+
+private:
+    struct JobState;
+    struct PendingRun {
+        int priority = 0;
+        std::uint64_t sequence = 0;
+        std::shared_ptr<JobState> job;
+        std::size_t restart = 0;
+    };
+    struct PendingOrder {
+        bool operator()(const PendingRun &a, const PendingRun &b) const;
+    };
+
+    std::mutex pending_mutex_;
+    std::priority_queue<PendingRun, std::vector<PendingRun>, PendingOrder> pending_;
+    std::uint64_t sequence_ = 0;
+    // Declared last so its workers are joined before the queue goes away.
+    ThreadPool pool_;
+
+    void run_next();
+};
+
+} // namespace qanneal
@@ -30,6 +30,7 @@ public:
     std::size_t size() const override { return n_; }
     double energy(const int8_t *spins, std::size_t n) const override;
     double delta_energy(const int8_t *spins, std::size_t n, std::size_t flip) const override;
+    CouplingGraph coupling_graph() const override;
 
     const std::vector<double> &h() const { return h_; }
     const std::vector<SparseEdge> &edges() const { return edges_; }
@@ -7,10 +7,15 @@
 #include <vector>
 
 #include "qanneal/backend.hpp"
+#include "qanneal/checkpoint.hpp"
+#include "qanneal/instrumentation.hpp"
+#include "qanneal/local_search.hpp"
+#include "qanneal/sample_set.hpp"
 #include "qanneal/sqa_observer.hpp"
 #include "qanneal/sqa_schedule.hpp"
 #include "qanneal/sqa_state.hpp"
 #include "qanneal/state.hpp"
+#include "qanneal/stop_criteria.hpp"
 
 namespace qanneal {
 
@@ -18,6 +23,11 @@ struct SQAResult {
     State best_state;
     double best_energy = 0.0;
     std::vector<double> energy_trace;
+    // Hot-path counters, one entry per step; empty when built without
+    // instrumentation.
+    std::vector<StepCounters> step_counters;
+    StopReason stop_reason = StopReason::Completed;
+    std::size_t sweeps = 0;
 };
 
 class SQAAnnealer {
@@ -32,18 +42,37 @@ public:
                 std::size_t replicas = 1);
 
     void set_seed(std::uint64_t seed);
+    void set_polish(PolishOptions options);
+    void set_stop_criteria(StopCriteria criteria);
+    void set_checkpoint(CheckpointOptions options);
+    // Offers the states visited during runs to `samples` (null to stop):
+    // every Trotter slice at the end of every step, with its classical energy.
+    void set_sample_set(std::shared_ptr<SampleSet> samples);
 
     SQAResult run(std::size_t sweeps_per_beta,
                   std::size_t worldline_sweeps,
                   SQAObserver *observer = nullptr);
+    SQAResult resume(const std::string &path,
+                     std::size_t sweeps_per_beta,
+                     std::size_t worldline_sweeps,
+                     SQAObserver *observer = nullptr);
 
 private:
     std::shared_ptr<Backend> backend_;
     SQASchedule schedule_;
     std::size_t slices_ = 0;
     std::size_t replicas_ = 0;
+    PolishOptions polish_;
+    StopCriteria stop_;
+    CheckpointOptions checkpoint_;
+    std::shared_ptr<SampleSet> samples_;
     std::mt19937_64 rng_;
 
+    SQAResult run_from(std::size_t sweeps_per_beta,
+                       std::size_t worldline_sweeps,
+                       SQAObserver *observer,
+                       CheckpointReader *reader);
+
     double trotter_coupling(double beta, double gamma) const;
     double delta_trotter(const SQAState &state,
                          std::size_t replica,
@@ -2,6 +2,7 @@
 
 #include <cstddef>
 
+#include "qanneal/instrumentation.hpp"
 #include "qanneal/sqa_state.hpp"
 
 namespace qanneal {
@@ -14,6 +15,12 @@ public:
                         double gamma,
                         double avg_energy,
                         const SQAState &state) = 0;
+    // Called after record() with the step's counters when the library is
+    // built with instrumentation.
+    virtual void record_counters(std::size_t step, const StepCounters &counters) {
+        (void)step;
+        (void)counters;
+    }
 };
 
 }
@@ -26,6 +26,11 @@ public:
     std::size_t slices() const { return slices_; }
     std::size_t spins() const { return spins_; }
 
+    // Contiguous replica-major, slice-major buffer of replicas * slices * spins.
+    int8_t *data() { return data_.data(); }
+    const int8_t *data() const { return data_.data(); }
+    std::size_t size() const { return data_.size(); }
+
     int8_t &at(std::size_t replica, std::size_t slice, std::size_t spin) {
         return data_[index(replica, slice, spin)];
     }
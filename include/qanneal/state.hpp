@@ -47,4 +47,26 @@ inline void validate_spins(const int8_t *spins, std::size_t n) {
     }
 }
 
+// Bit-packed spins: bit i is set for +1, eight spins per byte.
+inline std::size_t packed_spin_bytes(std::size_t n) {
+    return (n + 7) / 8;
+}
+
+inline void pack_spins(const int8_t *spins, std::size_t n, uint8_t *out) {
+    for (std::size_t b = 0; b < packed_spin_bytes(n); ++b) {
+        out[b] = 0;
+    }
+    for (std::size_t i = 0; i < n; ++i) {
+        if (spins[i] > 0) {
+            out[i / 8] = static_cast<uint8_t>(out[i / 8] | (1u << (i % 8)));
+        }
+    }
+}
+
+inline void unpack_spins(const uint8_t *packed, std::size_t n, int8_t *spins) {
+    for (std::size_t i = 0; i < n; ++i) {
+        spins[i] = ((packed[i / 8] >> (i % 8)) & 1u) ? 1 : -1;
+    }
+}
+
 }
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <limits>
+#include <memory>
+
+namespace qanneal {
+
+enum class StopReason {
+    Completed,
+    TimeLimit,
+    TargetEnergy,
+    Stagnation,
+    Cancelled
+};
+
+const char *stop_reason_to_string(StopReason reason);
+
+// Shared flag that lets another thread stop a run. Copies refer to the same
+// flag.
+class CancellationToken {
+public:
+    CancellationToken() : flag_(std::make_shared<std::atomic<bool>>(false)) {}
+
+    void cancel() const { flag_->store(true, std::memory_order_relaxed); }
+    void reset() const { flag_->store(false, std::memory_order_relaxed); }
+    bool cancelled() const { return flag_->load(std::memory_order_relaxed); }
+
+private:
+    std::shared_ptr<std::atomic<bool>> flag_;
+};
+
+struct StopCriteria {
+    // Wall-clock budget in seconds; <= 0 disables it.
+    double time_limit = 0.0;
+    // Stop once an energy at or below this value has been seen.
+    double target_energy = -std::numeric_limits<double>::infinity();
+    // Stop after this many sweeps without a new best energy; 0 disables it.
+    std::size_t stagnation_sweeps = 0;
+    CancellationToken cancel;
+};
+
+// Evaluates StopCriteria for one run. Engines report progress after every
+// sweep (or batch of sweeps) and stop as soon as record() returns true.
+class StopMonitor {
+public:
+    explicit StopMonitor(const StopCriteria &criteria);
+
+    // Counts `sweeps` more sweeps ending at `energy` (infinity if the engine
+    // has no energy at hand) and returns true once the run should stop.
+    bool record(std::size_t sweeps,
+                double energy = std::numeric_limits<double>::infinity());
+
+    bool stopped() const { return reason_ != StopReason::Completed; }
+    StopReason reason() const { return reason_; }
+    std::size_t sweeps() const { return sweeps_; }
+    std::size_t last_improvement() const { return last_improvement_; }
+    double best_energy() const { return best_energy_; }
+    double elapsed() const;
+
+    // Continues the bookkeeping of an interrupted run; `elapsed` seconds
+    // count against the time limit.
+    void restore(std::size_t sweeps,
+                 std::size_t last_improvement,
+                 double best_energy,
+                 double elapsed);
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    const StopCriteria &criteria_;
+    Clock::time_point start_;
+    StopReason reason_ = StopReason::Completed;
+    std::size_t sweeps_ = 0;
+    std::size_t last_improvement_ = 0;
+    double best_energy_ = std::numeric_limits<double>::infinity();
+};
+
+} // namespace qanneal
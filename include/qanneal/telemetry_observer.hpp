@@ -0,0 +1,114 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "qanneal/observer.hpp"
+#include "qanneal/sqa_observer.hpp"
+
+namespace qanneal {
+
+struct TelemetryOptions {
+    std::string path;
+    // Keep one step in `decimation`; steps where step % decimation != 0 are
+    // not copied at all.
+    std::size_t decimation = 1;
+    // Ring slots between the annealing thread and the writer. A snapshot
+    // that finds the ring full is dropped rather than waited for.
+    std::size_t capacity = 64;
+    // Also write the bit-packed spins of every kept snapshot.
+    bool store_spins = false;
+};
+
+// Observer that streams decimated snapshots to a binary trace file without
+// ever blocking the annealing thread. record() copies the spins into a
+// preallocated slot of a single-producer/single-consumer ring; a background
+// thread reduces each snapshot (magnetization over every spin of the
+// snapshot) and appends one fixed-size record to the file. Memory stays at
+// `capacity` snapshots however long the run.
+//
+// Usable with the classical engines and, through SQAObserver, with
+// SQAAnnealer (the snapshot is then the whole replica x slice x spin state).
+// One producer thread at a time.
+class TelemetryObserver final : public Observer, public SQAObserver {
+public:
+    explicit TelemetryObserver(TelemetryOptions options);
+    ~TelemetryObserver() override;
+
+    TelemetryObserver(const TelemetryObserver &) = delete;
+    TelemetryObserver &operator=(const TelemetryObserver &) = delete;
+
+    void record(std::size_t step,
+                double beta,
+                double energy,
+                const State &state) override;
+    void record(std::size_t step,
+                double beta,
+                double gamma,
+                double avg_energy,
+                const SQAState &state) override;
+
+    // Drains the ring, flushes and closes the file and joins the writer.
+    // Rethrows a write failure from the background thread. Later records are
+    // ignored.
+    void close();
+
+    std::size_t written() const { return written_.load(std::memory_order_acquire); }
+    std::size_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    struct Slot {
+        std::uint64_t step = 0;
+        double beta = 0.0;
+        double gamma = 0.0;
+        double energy = 0.0;
+        std::vector<int8_t> spins;
+    };
+
+    TelemetryOptions options_;
+    std::vector<Slot> ring_;
+    std::size_t snapshot_spins_ = 0;  // fixed by the first snapshot
+    std::atomic<std::size_t> head_{0};
+    std::atomic<std::size_t> tail_{0};
+    std::atomic<std::size_t> written_{0};
+    std::atomic<std::size_t> dropped_{0};
+    std::atomic<bool> closing_{false};
+    std::atomic<bool> failed_{false};
+    std::exception_ptr error_;
+    std::ofstream out_;
+    bool closed_ = false;
+    std::mutex wake_mutex_;
+    std::condition_variable wake_;
+    std::thread writer_;
+
+    void push(std::size_t step, double beta, double gamma, double energy,
+              const int8_t *spins, std::size_t count);
+    void run_writer();
+};
+
+// A telemetry file read back into columns, one entry per record.
+struct TelemetryTrace {
+    std::size_t snapshot_spins = 0;
+    bool has_spins = false;
+    std::vector<std::size_t> steps;
+    std::vector<double> betas;
+    std::vector<double> gammas;  // NaN for classical engines
+    std::vector<double> energies;
+    std::vector<double> magnetizations;
+    // snapshot_spins entries per record when has_spins.
+    std::vector<int8_t> spins;
+
+    std::size_t size() const { return steps.size(); }
+};
+
+TelemetryTrace read_telemetry(const std::string &path);
+
+}
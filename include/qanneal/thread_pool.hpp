@@ -0,0 +1,62 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace qanneal {
+
+// Fixed-size pool with one task deque per worker. A worker pops its own deque
+// from the back (newest first) and steals from the front of the others when
+// it runs dry, so uneven task costs balance out without a central queue.
+class ThreadPool {
+public:
+    // threads == 0 uses std::thread::hardware_concurrency().
+    explicit ThreadPool(std::size_t threads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    std::size_t size() const { return threads_.size(); }
+
+    // Index of the calling worker, or size() when called from outside.
+    std::size_t worker_index() const;
+
+    // Tasks submitted from a worker go to its own deque, others are spread
+    // round-robin. Exceptions escaping a task are discarded.
+    void submit(std::function<void()> task);
+
+    // Runs fn(i) for every i in [0, count) in chunks of `grain` indices and
+    // blocks until all have finished. The calling thread helps execute
+    // queued tasks while it waits. The first exception thrown by fn is
+    // rethrown here.
+    void parallel_for(std::size_t count,
+                      std::size_t grain,
+                      const std::function<void(std::size_t)> &fn);
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues_;
+    std::vector<std::thread> threads_;
+    std::mutex sleep_mutex_;
+    std::condition_variable wake_;
+    std::atomic<std::size_t> pending_{0};
+    std::atomic<std::size_t> next_queue_{0};
+    bool stopping_ = false;
+
+    bool try_pop(std::size_t self, std::function<void()> &task);
+    void worker_loop(std::size_t self);
+};
+
+} // namespace qanneal
@@ -1,4 +1,10 @@
+#include <algorithm>
+#include <chrono>
+#include <future>
+#include <limits>
+#include <memory>
 #include <stdexcept>
+#include <string>
 
 #include <pybind11/pybind11.h>
 #include <pybind11/numpy.h>
@@ -6,27 +12,46 @@
 
 #include "qanneal/annealer.hpp"
 #include "qanneal/backend.hpp"
+#include "qanneal/batch_solver.hpp"
+#include "qanneal/batched_observer.hpp"
+#include "qanneal/checkpoint.hpp"
+#include "qanneal/cluster_moves.hpp"
 #include "qanneal/dense_ising.hpp"
+#include "qanneal/energy_histogram.hpp"
 #include "qanneal/hamiltonian.hpp"
+#include "qanneal/instrumentation.hpp"
+#include "qanneal/ising_view.hpp"
+#include "qanneal/local_search.hpp"
 #include "qanneal/metrics.hpp"
 #include "qanneal/metrics_observer.hpp"
 #include "qanneal/parallel_tempering.hpp"
+#include "qanneal/population_annealer.hpp"
 #include "qanneal/qubo.hpp"
+#include "qanneal/rejection_free.hpp"
 #include "qanneal/replica_annealer.hpp"
+#include "qanneal/sample_set.hpp"
 #include "qanneal/schedule.hpp"
+#include "qanneal/solver_pool.hpp"
 #include "qanneal/sparse_ising.hpp"
 #include "qanneal/sqa_annealer.hpp"
 #include "qanneal/sqa_observer.hpp"
 #include "qanneal/sqa_schedule.hpp"
 #include "qanneal/sqa_state.hpp"
 #include "qanneal/state.hpp"
+#include "qanneal/stop_criteria.hpp"
+#include "qanneal/telemetry_observer.hpp"
 #include "qanneal/version.hpp"
 
 namespace py = pybind11;
 
 namespace {
 
-std::vector<double> array_to_vector_1d(const py::array_t<double, py::array::c_style | py::array::forcecast> &arr) {
+// Contiguous arrays pass through without a copy; anything else (strided,
+// another dtype, a list) is converted once on the way in.
+using DoubleArray = py::array_t<double, py::array::c_style | py::array::forcecast>;
+using SpinArray = py::array_t<int8_t, py::array::c_style | py::array::forcecast>;
+
+std::vector<double> array_to_vector_1d(const DoubleArray &arr) {
     auto buf = arr.request();
     if (buf.ndim != 1) {
         throw std::invalid_argument("Expected 1D array.");
@@ -35,8 +60,7 @@ std::vector<double> array_to_vector_1d(const py::array_t<double, py::array::c_st
     return std::vector<double>(ptr, ptr + buf.shape[0]);
 }
 
-std::vector<double> array_to_vector_2d(const py::array_t<double, py::array::c_style | py::array::forcecast> &arr,
-                                       std::size_t &n) {
+std::vector<double> array_to_vector_2d(const DoubleArray &arr, std::size_t &n) {
     auto buf = arr.request();
     if (buf.ndim != 2) {
         throw std::invalid_argument("Expected 2D array.");
@@ -49,15 +73,107 @@ std::vector<double> array_to_vector_2d(const py::array_t<double, py::array::c_st
     return std::vector<double>(ptr, ptr + buf.shape[0] * buf.shape[1]);
 }
 
-std::vector<int8_t> seq_to_spins(const py::sequence &seq) {
-    std::vector<int8_t> spins;
-    spins.reserve(seq.size());
-    for (auto item : seq) {
-        spins.push_back(static_cast<int8_t>(py::cast<int>(item)));
+std::size_t vector_length(const py::array &arr, const char *what) {
+    if (arr.ndim() != 1) {
+        throw std::invalid_argument(std::string(what) + " must be a 1D array.");
+    }
+    return static_cast<std::size_t>(arr.shape(0));
+}
+
+std::size_t square_size(const DoubleArray &arr) {
+    if (arr.ndim() != 2 || arr.shape(0) != arr.shape(1)) {
+        throw std::invalid_argument("Expected square matrix.");
+    }
+    return static_cast<std::size_t>(arr.shape(0));
+}
+
+// Wraps a view over numpy buffers so that the buffers live as long as the
+// view, however many engines share it. The last owner may be a solver
+// thread, hence the GIL around dropping the references.
+template <typename View>
+std::shared_ptr<View> hold_buffers(std::unique_ptr<View> view, std::vector<py::object> buffers) {
+    auto keep = std::make_shared<std::vector<py::object>>(std::move(buffers));
+    return std::shared_ptr<View>(view.release(), [keep](View *v) mutable {
+        delete v;
+        py::gil_scoped_acquire gil;
+        keep.reset();
+    });
+}
+
+// Read-only numpy view of a vector owned by the Python object `owner`,
+// which the array keeps alive.
+template <typename T>
+py::array_t<T> vector_view(const std::vector<T> &values, py::handle owner,
+                           std::vector<py::ssize_t> shape = {}) {
+    if (shape.empty()) {
+        shape.push_back(static_cast<py::ssize_t>(values.size()));
+    }
+    py::array_t<T> arr(shape, values.data(), owner);
+    arr.attr("setflags")(py::arg("write") = false);
+    return arr;
+}
+
+// Property getter returning vector_view of a member.
+template <typename Class, typename T>
+auto view_of(std::vector<T> Class::*member) {
+    return [member](py::object self) { return vector_view(self.cast<const Class &>().*member, self); };
+}
+
+// Moves `values` into a numpy array without copying the elements.
+template <typename T>
+py::array_t<T> adopt(std::vector<T> &&values, std::vector<py::ssize_t> shape) {
+    auto *owned = new std::vector<T>(std::move(values));
+    py::capsule release(owned, [](void *p) { delete static_cast<std::vector<T> *>(p); });
+    return py::array_t<T>(shape, owned->data(), release);
+}
+
+template <typename Index>
+using IndexArray = py::array_t<Index, py::array::c_style | py::array::forcecast>;
+
+template <typename Index>
+std::shared_ptr<qanneal::CsrIsingView<Index>> make_csr_view(DoubleArray h,
+                                                            IndexArray<Index> indptr,
+                                                            IndexArray<Index> indices,
+                                                            DoubleArray data,
+                                                            double c) {
+    const std::size_t n = vector_length(h, "h");
+    if (vector_length(indptr, "indptr") != n + 1) {
+        throw std::invalid_argument("indptr length must be len(h) + 1.");
+    }
+    const std::size_t nnz = vector_length(indices, "indices");
+    if (vector_length(data, "data") != nnz) {
+        throw std::invalid_argument("indices and data length mismatch.");
+    }
+    if (static_cast<std::size_t>(indptr.data()[n]) != nnz) {
+        throw std::invalid_argument("indptr[-1] must equal the number of stored entries.");
+    }
+    auto view = std::make_unique<qanneal::CsrIsingView<Index>>(
+        h.data(), indptr.data(), indices.data(), data.data(), n, c);
+    return hold_buffers(std::move(view), {h, indptr, indices, data});
+}
+
+template <typename Index>
+void bind_csr_view(py::module_ &m, const char *name) {
+    using View = qanneal::CsrIsingView<Index>;
+    py::class_<View, qanneal::Hamiltonian, std::shared_ptr<View>>(m, name)
+        .def(py::init(&make_csr_view<Index>),
+             py::arg("h"), py::arg("indptr"), py::arg("indices"), py::arg("data"), py::arg("c") = 0.0);
+}
+
+// The run bindings release the GIL; a BatchedObserver takes it back to call
+// into Python, including for the partial batch left at the end of a run.
+template <typename ObserverType>
+void flush_batches(ObserverType *observer) {
+    if (auto *batched = dynamic_cast<qanneal::BatchedObserver *>(observer)) {
+        batched->flush();
     }
-    return spins;
 }
 
+// std::future is move-only; Python handles share one result.
+struct SolverFuture {
+    std::shared_future<qanneal::SolverJobResult> future;
+};
+
 } // namespace
 
 PYBIND11_MODULE(_qanneal, m) {
@@ -67,20 +183,36 @@ PYBIND11_MODULE(_qanneal, m) {
     m.attr("version_major") = qanneal::version_major;
     m.attr("version_minor") = qanneal::version_minor;
     m.attr("version_patch") = qanneal::version_patch;
+    m.attr("instrumentation_enabled") = qanneal::instrumentation::enabled;
 
     py::class_<qanneal::State>(m, "State")
         .def(py::init<std::size_t>())
+        // A writable view of the spins. Assignment copies into place and must
+        // keep the length, so views handed out earlier never dangle.
         .def_property("spins",
-                      [](const qanneal::State &s) { return s.spins; },
-                      [](qanneal::State &s, const std::vector<int8_t> &spins) { s.spins = spins; })
+                      [](py::object self) {
+                          auto &s = self.cast<qanneal::State &>();
+                          return py::array_t<int8_t>(static_cast<py::ssize_t>(s.spins.size()), s.spins.data(), self);
+                      },
+                      [](qanneal::State &s, SpinArray spins) {
+                          if (vector_length(spins, "spins") != s.spins.size()) {
+                              throw py::value_error("spins length must match the state size.");
+                          }
+                          std::copy(spins.data(), spins.data() + s.spins.size(), s.spins.begin());
+                      })
         .def("size", &qanneal::State::size);
 
-    py::class_<qanneal::Hamiltonian, std::shared_ptr<qanneal::Hamiltonian>>(m, "Hamiltonian");
+    py::class_<qanneal::Hamiltonian, std::shared_ptr<qanneal::Hamiltonian>>(m, "Hamiltonian")
+        .def("size", &qanneal::Hamiltonian::size)
+        .def("energy", [](const qanneal::Hamiltonian &ham, SpinArray spins) {
+            return ham.energy(spins.data(), vector_length(spins, "spins"));
+        }, py::arg("spins"))
+        .def("delta_energy", [](const qanneal::Hamiltonian &ham, SpinArray spins, std::size_t flip) {
+            return ham.delta_energy(spins.data(), vector_length(spins, "spins"), flip);
+        }, py::arg("spins"), py::arg("flip"));
 
     py::class_<qanneal::DenseIsing, qanneal::Hamiltonian, std::shared_ptr<qanneal::DenseIsing>>(m, "DenseIsing")
-        .def(py::init([](py::array_t<double, py::array::c_style | py::array::forcecast> h,
-                         py::array_t<double, py::array::c_style | py::array::forcecast> J,
-                         double c) {
+        .def(py::init([](DoubleArray h, DoubleArray J, double c) {
             std::vector<double> hv = array_to_vector_1d(h);
             std::size_t n = 0;
             std::vector<double> Jv = array_to_vector_2d(J, n);
@@ -88,16 +220,33 @@ PYBIND11_MODULE(_qanneal, m) {
                 throw std::invalid_argument("h vector length mismatch.");
             }
             return qanneal::DenseIsing(std::move(hv), std::move(Jv), n, c);
-        }), py::arg("h"), py::arg("J"), py::arg("c") = 0.0)
-        .def("size", &qanneal::DenseIsing::size)
-        .def("energy", [](const qanneal::DenseIsing &ham, const py::sequence &spins) {
-            auto data = seq_to_spins(spins);
-            return ham.energy(data.data(), data.size());
-        })
-        .def("delta_energy", [](const qanneal::DenseIsing &ham, const py::sequence &spins, std::size_t flip) {
-            auto data = seq_to_spins(spins);
-            return ham.delta_energy(data.data(), data.size(), flip);
-        });
+        }), py::arg("h"), py::arg("J"), py::arg("c") = 0.0);
+
+    // Reads h and J in place; the arrays must not be modified during a run.
+    py::class_<qanneal::DenseIsingView, qanneal::Hamiltonian, std::shared_ptr<qanneal::DenseIsingView>>(m, "DenseIsingView")
+        .def(py::init([](DoubleArray h, DoubleArray J, double c) {
+            const std::size_t n = square_size(J);
+            if (vector_length(h, "h") != n) {
+                throw std::invalid_argument("h vector length mismatch.");
+            }
+            auto view = std::make_unique<qanneal::DenseIsingView>(h.data(), J.data(), n, c);
+            return hold_buffers(std::move(view), {h, J});
+        }), py::arg("h"), py::arg("J"), py::arg("c") = 0.0);
+
+    // scipy.sparse CSR buffers read in place, by index width; csr_ising and
+    // from_scipy pick the class.
+    bind_csr_view<std::int32_t>(m, "CsrIsingView32");
+    bind_csr_view<std::int64_t>(m, "CsrIsingView64");
+    m.def("csr_ising", [](DoubleArray h, py::array indptr, py::array indices, DoubleArray data, double c) {
+        const bool narrow = py::isinstance<py::array_t<std::int32_t>>(indptr) &&
+                            py::isinstance<py::array_t<std::int32_t>>(indices);
+        if (narrow) {
+            return py::cast(make_csr_view<std::int32_t>(h, py::cast<IndexArray<std::int32_t>>(indptr),
+                                                        py::cast<IndexArray<std::int32_t>>(indices), data, c));
+        }
+        return py::cast(make_csr_view<std::int64_t>(h, py::cast<IndexArray<std::int64_t>>(indptr),
+                                                    py::cast<IndexArray<std::int64_t>>(indices), data, c));
+    }, py::arg("h"), py::arg("indptr"), py::arg("indices"), py::arg("data"), py::arg("c") = 0.0);
 
     py::class_<qanneal::SparseEdge>(m, "SparseEdge")
         .def(py::init<std::size_t, std::size_t, double>())
@@ -106,7 +255,7 @@ PYBIND11_MODULE(_qanneal, m) {
         .def_readwrite("value", &qanneal::SparseEdge::value);
 
     py::class_<qanneal::SparseIsing, qanneal::Hamiltonian, std::shared_ptr<qanneal::SparseIsing>>(m, "SparseIsing")
-        .def(py::init([](py::array_t<double, py::array::c_style | py::array::forcecast> h,
+        .def(py::init([](DoubleArray h,
                          const std::vector<qanneal::SparseEdge> &edges,
                          std::size_t n,
                          double c) {
@@ -115,19 +264,10 @@ PYBIND11_MODULE(_qanneal, m) {
                 throw std::invalid_argument("h vector length mismatch.");
             }
             return qanneal::SparseIsing(std::move(hv), edges, n, c);
-        }), py::arg("h"), py::arg("edges"), py::arg("n"), py::arg("c") = 0.0)
-        .def("size", &qanneal::SparseIsing::size)
-        .def("energy", [](const qanneal::SparseIsing &ham, const py::sequence &spins) {
-            auto data = seq_to_spins(spins);
-            return ham.energy(data.data(), data.size());
-        })
-        .def("delta_energy", [](const qanneal::SparseIsing &ham, const py::sequence &spins, std::size_t flip) {
-            auto data = seq_to_spins(spins);
-            return ham.delta_energy(data.data(), data.size(), flip);
-        });
+        }), py::arg("h"), py::arg("edges"), py::arg("n"), py::arg("c") = 0.0);
 
     py::class_<qanneal::QUBO>(m, "QUBO")
-        .def(py::init([](py::array_t<double, py::array::c_style | py::array::forcecast> Q) {
+        .def(py::init([](DoubleArray Q) {
             std::size_t n = 0;
             std::vector<double> qv = array_to_vector_2d(Q, n);
             return qanneal::QUBO(std::move(qv), n);
@@ -138,8 +278,12 @@ PYBIND11_MODULE(_qanneal, m) {
     py::class_<qanneal::AnnealSchedule>(m, "AnnealSchedule")
         .def(py::init<>())
         .def_readwrite("betas", &qanneal::AnnealSchedule::betas)
+        .def_readwrite("sweep_scale", &qanneal::AnnealSchedule::sweep_scale)
+        .def("sweeps_at", &qanneal::AnnealSchedule::sweeps_at, py::arg("step"), py::arg("sweeps_per_beta"))
         .def_static("linear", &qanneal::AnnealSchedule::linear,
                     py::arg("beta_start"), py::arg("beta_end"), py::arg("steps"))
+        .def_static("geometric", &qanneal::AnnealSchedule::geometric,
+                    py::arg("beta_start"), py::arg("beta_end"), py::arg("steps"))
         .def_static("from_betas", [](const std::vector<double> &betas) {
             qanneal::AnnealSchedule sched;
             sched.betas = betas;
@@ -149,17 +293,150 @@ PYBIND11_MODULE(_qanneal, m) {
             return sched;
         });
 
+    py::class_<qanneal::BetaRange>(m, "BetaRange")
+        .def_readonly("beta_min", &qanneal::BetaRange::beta_min)
+        .def_readonly("beta_max", &qanneal::BetaRange::beta_max);
+
+    py::class_<qanneal::AdaptiveScheduleOptions>(m, "AdaptiveScheduleOptions")
+        .def(py::init<>())
+        .def_readwrite("pilot_sweeps", &qanneal::AdaptiveScheduleOptions::pilot_sweeps)
+        .def_readwrite("collapse_threshold", &qanneal::AdaptiveScheduleOptions::collapse_threshold)
+        .def_readwrite("min_scale", &qanneal::AdaptiveScheduleOptions::min_scale)
+        .def_readwrite("seed", &qanneal::AdaptiveScheduleOptions::seed);
+
+    m.def("estimate_beta_range", &qanneal::estimate_beta_range, py::arg("hamiltonian"));
+    m.def("auto_schedule", &qanneal::auto_schedule, py::arg("hamiltonian"), py::arg("steps"));
+    m.def("adaptive_schedule", &qanneal::adaptive_schedule,
+          py::arg("hamiltonian"), py::arg("base"),
+          py::arg("options") = qanneal::AdaptiveScheduleOptions{});
+
+    py::enum_<qanneal::StopReason>(m, "StopReason")
+        .value("COMPLETED", qanneal::StopReason::Completed)
+        .value("TIME_LIMIT", qanneal::StopReason::TimeLimit)
+        .value("TARGET_ENERGY", qanneal::StopReason::TargetEnergy)
+        .value("STAGNATION", qanneal::StopReason::Stagnation)
+        .value("CANCELLED", qanneal::StopReason::Cancelled);
+
+    py::class_<qanneal::CancellationToken>(m, "CancellationToken")
+        .def(py::init<>())
+        .def("cancel", &qanneal::CancellationToken::cancel)
+        .def("reset", &qanneal::CancellationToken::reset)
+        .def("cancelled", &qanneal::CancellationToken::cancelled);
+
+    py::class_<qanneal::StopCriteria>(m, "StopCriteria")
+        .def(py::init<>())
+        .def_readwrite("time_limit", &qanneal::StopCriteria::time_limit)
+        .def_readwrite("target_energy", &qanneal::StopCriteria::target_energy)
+        .def_readwrite("stagnation_sweeps", &qanneal::StopCriteria::stagnation_sweeps)
+        .def_readwrite("cancel", &qanneal::StopCriteria::cancel);
+
+    py::class_<qanneal::CheckpointOptions>(m, "CheckpointOptions")
+        .def(py::init<>())
+        .def_readwrite("path", &qanneal::CheckpointOptions::path)
+        .def_readwrite("interval", &qanneal::CheckpointOptions::interval);
+
+    py::enum_<qanneal::PolishMode>(m, "PolishMode")
+        .value("NONE", qanneal::PolishMode::None)
+        .value("STEEPEST_DESCENT", qanneal::PolishMode::SteepestDescent)
+        .value("TABU", qanneal::PolishMode::Tabu);
+
+    py::class_<qanneal::PolishOptions>(m, "PolishOptions")
+        .def(py::init<>())
+        .def_readwrite("mode", &qanneal::PolishOptions::mode)
+        .def_readwrite("tabu_iterations", &qanneal::PolishOptions::tabu_iterations)
+        .def_readwrite("tabu_tenure", &qanneal::PolishOptions::tabu_tenure)
+        .def_readwrite("parallel", &qanneal::PolishOptions::parallel);
+
+    py::class_<qanneal::StepCounters>(m, "StepCounters")
+        .def(py::init<>())
+        .def_readonly("attempted_flips", &qanneal::StepCounters::attempted_flips)
+        .def_readonly("accepted_flips", &qanneal::StepCounters::accepted_flips)
+        .def_readonly("swap_attempts", &qanneal::StepCounters::swap_attempts)
+        .def_readonly("swap_accepts", &qanneal::StepCounters::swap_accepts)
+        .def_readonly("worldline_attempts", &qanneal::StepCounters::worldline_attempts)
+        .def_readonly("worldline_accepts", &qanneal::StepCounters::worldline_accepts)
+        .def_readonly("sweep_ns", &qanneal::StepCounters::sweep_ns)
+        .def_readonly("observer_ns", &qanneal::StepCounters::observer_ns)
+        .def_readonly("energy_ns", &qanneal::StepCounters::energy_ns)
+        .def_readonly("cycles", &qanneal::StepCounters::cycles)
+        .def_readonly("instructions", &qanneal::StepCounters::instructions)
+        .def_readonly("llc_misses", &qanneal::StepCounters::llc_misses)
+        .def_readonly("branch_misses", &qanneal::StepCounters::branch_misses);
+    m.def("sum_counters", &qanneal::sum_counters, py::arg("trace"));
+    m.def("set_hardware_counters", &qanneal::instrumentation::set_hardware_counters, py::arg("on"));
+    m.def("hardware_counters", &qanneal::instrumentation::hardware_counters);
+    m.def("hardware_counter_status", &qanneal::instrumentation::hardware_counter_status);
+
+    py::class_<qanneal::Sample>(m, "Sample")
+        .def_readonly("state", &qanneal::Sample::state)
+        .def_readonly("energy", &qanneal::Sample::energy)
+        .def_readonly("count", &qanneal::Sample::count);
+
+    py::class_<qanneal::SampleSet, std::shared_ptr<qanneal::SampleSet>>(m, "SampleSet")
+        .def(py::init<std::size_t, std::size_t, std::uint64_t>(),
+             py::arg("num_spins"), py::arg("capacity"), py::arg("seed") = 0x5eed5eedULL)
+        .def("add", py::overload_cast<const qanneal::State &, double>(&qanneal::SampleSet::add),
+             py::arg("state"), py::arg("energy"))
+        .def("merge", &qanneal::SampleSet::merge, py::arg("other"))
+        .def("clear", &qanneal::SampleSet::clear)
+        .def("samples", &qanneal::SampleSet::samples)
+        .def("to_arrays", [](const qanneal::SampleSet &self) {
+            // (spins [k, n] int8, energies [k], counts [k]) by increasing energy.
+            std::vector<int8_t> spins;
+            std::vector<double> energies;
+            std::vector<std::uint64_t> counts;
+            self.export_sorted(spins, energies, counts);
+            const auto k = static_cast<py::ssize_t>(energies.size());
+            const auto n = static_cast<py::ssize_t>(self.num_spins());
+            return py::make_tuple(adopt(std::move(spins), {k, n}),
+                                  adopt(std::move(energies), {k}),
+                                  adopt(std::move(counts), {k}));
+        })
+        .def_property_readonly("num_spins", &qanneal::SampleSet::num_spins)
+        .def_property_readonly("capacity", &qanneal::SampleSet::capacity)
+        .def_property_readonly("offered", &qanneal::SampleSet::offered)
+        .def("__len__", &qanneal::SampleSet::size);
+
+    py::class_<qanneal::EnergyHistogram>(m, "EnergyHistogram")
+        .def(py::init<double, double, std::size_t, double>(),
+             py::arg("lower"), py::arg("upper"), py::arg("bins"),
+             py::arg("target") = -std::numeric_limits<double>::infinity())
+        .def("add", &qanneal::EnergyHistogram::add, py::arg("energy"), py::arg("count") = 1)
+        .def("merge", &qanneal::EnergyHistogram::merge, py::arg("other"))
+        .def("total", &qanneal::EnergyHistogram::total)
+        .def("success_probability", &qanneal::EnergyHistogram::success_probability)
+        .def_readonly("lower", &qanneal::EnergyHistogram::lower)
+        .def_readonly("upper", &qanneal::EnergyHistogram::upper)
+        .def_readonly("target", &qanneal::EnergyHistogram::target)
+        .def_readonly("counts", &qanneal::EnergyHistogram::counts)
+        .def_readonly("underflow", &qanneal::EnergyHistogram::underflow)
+        .def_readonly("overflow", &qanneal::EnergyHistogram::overflow)
+        .def_readonly("hits", &qanneal::EnergyHistogram::hits)
+        .def_readonly("min_energy", &qanneal::EnergyHistogram::min_energy)
+        .def_readonly("max_energy", &qanneal::EnergyHistogram::max_energy);
+
     py::class_<qanneal::Observer, std::shared_ptr<qanneal::Observer>>(m, "Observer");
     py::class_<qanneal::MetricsObserver, qanneal::Observer, std::shared_ptr<qanneal::MetricsObserver>>(m, "MetricsObserver")
         .def(py::init<>())
         .def_readonly("energy_trace", &qanneal::MetricsObserver::energy_trace)
         .def_readonly("magnetization_trace", &qanneal::MetricsObserver::magnetization_trace)
+        .def_readonly("counter_trace", &qanneal::MetricsObserver::counter_trace)
         .def("clear", &qanneal::MetricsObserver::clear);
 
     py::class_<qanneal::AnnealResult>(m, "AnnealResult")
         .def_readonly("best_state", &qanneal::AnnealResult::best_state)
         .def_readonly("best_energy", &qanneal::AnnealResult::best_energy)
-        .def_readonly("energy_trace", &qanneal::AnnealResult::energy_trace);
+        .def_property_readonly("energy_trace", view_of(&qanneal::AnnealResult::energy_trace))
+        .def_property_readonly("acceptance_trace", view_of(&qanneal::AnnealResult::acceptance_trace))
+        .def_readonly("rejection_free_step", &qanneal::AnnealResult::rejection_free_step)
+        .def_readonly("step_counters", &qanneal::AnnealResult::step_counters)
+        .def_readonly("stop_reason", &qanneal::AnnealResult::stop_reason)
+        .def_readonly("sweeps", &qanneal::AnnealResult::sweeps);
+
+    py::enum_<qanneal::UpdateMode>(m, "UpdateMode")
+        .value("METROPOLIS", qanneal::UpdateMode::Metropolis)
+        .value("REJECTION_FREE", qanneal::UpdateMode::RejectionFree)
+        .value("ADAPTIVE", qanneal::UpdateMode::Adaptive);
 
     py::class_<qanneal::Annealer>(m, "Annealer")
         .def(py::init([](std::shared_ptr<qanneal::Hamiltonian> ham,
@@ -174,24 +451,45 @@ PYBIND11_MODULE(_qanneal, m) {
         py::arg("backend") = "cpu",
         py::keep_alive<1, 2>())
         .def("set_seed", &qanneal::Annealer::set_seed)
+        .def("set_polish", &qanneal::Annealer::set_polish, py::arg("options"))
+        .def("set_stop_criteria", &qanneal::Annealer::set_stop_criteria, py::arg("criteria"))
+        .def("set_sample_set", &qanneal::Annealer::set_sample_set, py::arg("samples"))
+        .def("set_checkpoint", &qanneal::Annealer::set_checkpoint, py::arg("options"))
+        .def("set_update_mode", &qanneal::Annealer::set_update_mode,
+             py::arg("mode"), py::arg("acceptance_threshold") = 0.05)
         .def("run", [](qanneal::Annealer &self,
                        std::size_t sweeps_per_beta,
                        std::shared_ptr<qanneal::Observer> obs) {
-            return self.run(sweeps_per_beta, obs.get());
-        }, py::arg("sweeps_per_beta"), py::arg("observer") = nullptr);
+            auto result = self.run(sweeps_per_beta, obs.get());
+            flush_batches(obs.get());
+            return result;
+        }, py::arg("sweeps_per_beta"), py::arg("observer") = nullptr,
+           py::call_guard<py::gil_scoped_release>())
+        .def("resume", [](qanneal::Annealer &self,
+                          const std::string &path,
+                          std::size_t sweeps_per_beta,
+                          std::shared_ptr<qanneal::Observer> obs) {
+            auto result = self.resume(path, sweeps_per_beta, obs.get());
+            flush_batches(obs.get());
+            return result;
+        }, py::arg("path"), py::arg("sweeps_per_beta"), py::arg("observer") = nullptr,
+           py::call_guard<py::gil_scoped_release>());
 
     py::class_<qanneal::ReplicaResult>(m, "ReplicaResult")
         .def_readonly("best_state", &qanneal::ReplicaResult::best_state)
         .def_readonly("best_energy", &qanneal::ReplicaResult::best_energy)
-        .def_readonly("energy_trace", &qanneal::ReplicaResult::energy_trace)
-        .def_readonly("magnetization_trace", &qanneal::ReplicaResult::magnetization_trace);
+        .def_property_readonly("energy_trace", view_of(&qanneal::ReplicaResult::energy_trace))
+        .def_property_readonly("magnetization_trace", view_of(&qanneal::ReplicaResult::magnetization_trace));
 
     py::class_<qanneal::MultiAnnealResult>(m, "MultiAnnealResult")
         .def_readonly("replicas", &qanneal::MultiAnnealResult::replicas)
         .def_readonly("global_best_state", &qanneal::MultiAnnealResult::global_best_state)
         .def_readonly("global_best_energy", &qanneal::MultiAnnealResult::global_best_energy)
-        .def_readonly("average_energy_trace", &qanneal::MultiAnnealResult::average_energy_trace)
-        .def_readonly("average_magnetization_trace", &qanneal::MultiAnnealResult::average_magnetization_trace);
+        .def_property_readonly("average_energy_trace", view_of(&qanneal::MultiAnnealResult::average_energy_trace))
+        .def_property_readonly("average_magnetization_trace", view_of(&qanneal::MultiAnnealResult::average_magnetization_trace))
+        .def_readonly("step_counters", &qanneal::MultiAnnealResult::step_counters)
+        .def_readonly("stop_reason", &qanneal::MultiAnnealResult::stop_reason)
+        .def_readonly("sweeps", &qanneal::MultiAnnealResult::sweeps);
 
     py::class_<qanneal::ReplicaAnnealer>(m, "ReplicaAnnealer")
         .def(py::init([](std::shared_ptr<qanneal::Hamiltonian> ham,
@@ -208,15 +506,38 @@ PYBIND11_MODULE(_qanneal, m) {
         py::arg("backend") = "cpu",
         py::keep_alive<1, 2>())
         .def("set_seed", &qanneal::ReplicaAnnealer::set_seed)
-        .def("run", &qanneal::ReplicaAnnealer::run, py::arg("sweeps_per_beta"));
+        .def("set_polish", &qanneal::ReplicaAnnealer::set_polish, py::arg("options"))
+        .def("set_stop_criteria", &qanneal::ReplicaAnnealer::set_stop_criteria, py::arg("criteria"))
+        .def("set_sample_set", &qanneal::ReplicaAnnealer::set_sample_set, py::arg("samples"))
+        .def("set_checkpoint", &qanneal::ReplicaAnnealer::set_checkpoint, py::arg("options"))
+        .def("run", &qanneal::ReplicaAnnealer::run, py::arg("sweeps_per_beta"),
+             py::call_guard<py::gil_scoped_release>())
+        .def("resume", &qanneal::ReplicaAnnealer::resume, py::arg("path"), py::arg("sweeps_per_beta"),
+             py::call_guard<py::gil_scoped_release>());
 
     py::class_<qanneal::ParallelTemperingResult>(m, "ParallelTemperingResult")
         .def_readonly("final_states", &qanneal::ParallelTemperingResult::final_states)
-        .def_readonly("final_energies", &qanneal::ParallelTemperingResult::final_energies)
+        .def_property_readonly("final_energies", view_of(&qanneal::ParallelTemperingResult::final_energies))
         .def_readonly("best_state", &qanneal::ParallelTemperingResult::best_state)
         .def_readonly("best_energy", &qanneal::ParallelTemperingResult::best_energy)
-        .def_readonly("average_energy_trace", &qanneal::ParallelTemperingResult::average_energy_trace)
-        .def_readonly("swap_acceptance_trace", &qanneal::ParallelTemperingResult::swap_acceptance_trace);
+        .def_property_readonly("average_energy_trace", view_of(&qanneal::ParallelTemperingResult::average_energy_trace))
+        .def_property_readonly("swap_acceptance_trace", view_of(&qanneal::ParallelTemperingResult::swap_acceptance_trace))
+        .def_property_readonly("cluster_size_trace", view_of(&qanneal::ParallelTemperingResult::cluster_size_trace))
+        .def_readonly("step_counters", &qanneal::ParallelTemperingResult::step_counters)
+        .def_readonly("stop_reason", &qanneal::ParallelTemperingResult::stop_reason)
+        .def_readonly("sweeps", &qanneal::ParallelTemperingResult::sweeps);
+
+    py::enum_<qanneal::ClusterUpdate>(m, "ClusterUpdate")
+        .value("NONE", qanneal::ClusterUpdate::None)
+        .value("WOLFF", qanneal::ClusterUpdate::Wolff)
+        .value("SWENDSEN_WANG", qanneal::ClusterUpdate::SwendsenWang);
+
+    py::class_<qanneal::ClusterMoveOptions>(m, "ClusterMoveOptions")
+        .def(py::init<>())
+        .def_readwrite("houdayer", &qanneal::ClusterMoveOptions::houdayer)
+        .def_readwrite("houdayer_beta_min", &qanneal::ClusterMoveOptions::houdayer_beta_min)
+        .def_readwrite("update", &qanneal::ClusterMoveOptions::update)
+        .def_readwrite("interval", &qanneal::ClusterMoveOptions::interval);
 
     py::class_<qanneal::ParallelTemperingAnnealer>(m, "ParallelTemperingAnnealer")
         .def(py::init([](std::shared_ptr<qanneal::Hamiltonian> ham,
@@ -231,10 +552,162 @@ PYBIND11_MODULE(_qanneal, m) {
         py::arg("backend") = "cpu",
         py::keep_alive<1, 2>())
         .def("set_seed", &qanneal::ParallelTemperingAnnealer::set_seed)
+        .def("set_polish", &qanneal::ParallelTemperingAnnealer::set_polish, py::arg("options"))
+        .def("set_stop_criteria", &qanneal::ParallelTemperingAnnealer::set_stop_criteria, py::arg("criteria"))
+        .def("set_sample_set", &qanneal::ParallelTemperingAnnealer::set_sample_set, py::arg("samples"))
+        .def("set_cluster_moves", &qanneal::ParallelTemperingAnnealer::set_cluster_moves, py::arg("options"))
+        .def("set_checkpoint", &qanneal::ParallelTemperingAnnealer::set_checkpoint, py::arg("options"))
         .def("run", &qanneal::ParallelTemperingAnnealer::run,
              py::arg("sweeps_per_step"),
              py::arg("steps"),
-             py::arg("swap_interval") = 1);
+             py::arg("swap_interval") = 1,
+             py::call_guard<py::gil_scoped_release>())
+        .def("resume", &qanneal::ParallelTemperingAnnealer::resume,
+             py::arg("path"),
+             py::arg("sweeps_per_step"),
+             py::arg("steps"),
+             py::arg("swap_interval") = 1,
+             py::call_guard<py::gil_scoped_release>());
+
+    py::class_<qanneal::PopulationAnnealResult>(m, "PopulationAnnealResult")
+        .def_readonly("final_states", &qanneal::PopulationAnnealResult::final_states)
+        .def_property_readonly("final_energies", view_of(&qanneal::PopulationAnnealResult::final_energies))
+        .def_readonly("best_state", &qanneal::PopulationAnnealResult::best_state)
+        .def_readonly("best_energy", &qanneal::PopulationAnnealResult::best_energy)
+        .def_property_readonly("average_energy_trace", view_of(&qanneal::PopulationAnnealResult::average_energy_trace))
+        .def_property_readonly("free_energy_trace", view_of(&qanneal::PopulationAnnealResult::free_energy_trace))
+        .def_readonly("log_partition", &qanneal::PopulationAnnealResult::log_partition)
+        .def_property_readonly("family_count_trace", view_of(&qanneal::PopulationAnnealResult::family_count_trace))
+        .def_readonly("surviving_families", &qanneal::PopulationAnnealResult::surviving_families)
+        .def_readonly("mean_square_family_size", &qanneal::PopulationAnnealResult::mean_square_family_size)
+        .def_readonly("entropic_family_size", &qanneal::PopulationAnnealResult::entropic_family_size)
+        .def_readonly("step_counters", &qanneal::PopulationAnnealResult::step_counters)
+        .def_readonly("stop_reason", &qanneal::PopulationAnnealResult::stop_reason)
+        .def_readonly("sweeps", &qanneal::PopulationAnnealResult::sweeps);
+
+    py::class_<qanneal::PopulationAnnealer>(m, "PopulationAnnealer")
+        .def(py::init([](std::shared_ptr<qanneal::Hamiltonian> ham,
+                         qanneal::AnnealSchedule schedule,
+                         std::size_t population,
+                         const std::string &backend) {
+            auto kind = qanneal::backend_from_string(backend);
+            auto be = qanneal::make_backend(kind, std::move(ham));
+            return qanneal::PopulationAnnealer(std::move(be), std::move(schedule), population);
+        }),
+        py::arg("hamiltonian"),
+        py::arg("schedule"),
+        py::arg("population"),
+        py::arg("backend") = "cpu",
+        py::keep_alive<1, 2>())
+        .def("set_seed", &qanneal::PopulationAnnealer::set_seed)
+        .def("set_polish", &qanneal::PopulationAnnealer::set_polish, py::arg("options"))
+        .def("set_stop_criteria", &qanneal::PopulationAnnealer::set_stop_criteria, py::arg("criteria"))
+        .def("set_sample_set", &qanneal::PopulationAnnealer::set_sample_set, py::arg("samples"))
+        .def("run", &qanneal::PopulationAnnealer::run, py::arg("sweeps_per_beta"),
+             py::call_guard<py::gil_scoped_release>());
+
+    py::class_<qanneal::IsingBatch>(m, "IsingBatch")
+        .def(py::init<>())
+        .def(py::init([](const std::vector<std::shared_ptr<qanneal::Hamiltonian>> &problems) {
+            qanneal::IsingBatch batch;
+            for (const auto &problem : problems) {
+                batch.add(*problem);
+            }
+            return batch;
+        }), py::arg("problems"))
+        .def(py::init([](const std::vector<std::size_t> &sizes,
+                         DoubleArray h,
+                         DoubleArray J,
+                         const std::vector<double> &constants) {
+            return qanneal::IsingBatch(sizes, array_to_vector_1d(h), array_to_vector_1d(J), constants);
+        }), py::arg("sizes"), py::arg("h"), py::arg("J"), py::arg("constants") = std::vector<double>{})
+        .def("add", [](qanneal::IsingBatch &batch, const qanneal::Hamiltonian &problem) {
+            batch.add(problem);
+        }, py::arg("problem"))
+        .def("__len__", &qanneal::IsingBatch::size)
+        .def("spins", &qanneal::IsingBatch::spins, py::arg("index"));
+
+    py::class_<qanneal::BatchResult>(m, "BatchResult")
+        .def_property_readonly("best_energies", view_of(&qanneal::BatchResult::best_energies))
+        .def_property_readonly("offsets", view_of(&qanneal::BatchResult::offsets))
+        .def_property_readonly("best_spins", view_of(&qanneal::BatchResult::best_spins))
+        .def("best_state", &qanneal::BatchResult::best_state, py::arg("index"))
+        .def("__len__", &qanneal::BatchResult::size);
+
+    py::class_<qanneal::BatchAnnealer>(m, "BatchAnnealer")
+        .def(py::init<qanneal::AnnealSchedule>(), py::arg("schedule"))
+        .def("set_seed", &qanneal::BatchAnnealer::set_seed)
+        .def("set_threads", &qanneal::BatchAnnealer::set_threads, py::arg("threads"))
+        .def("run", &qanneal::BatchAnnealer::run,
+             py::arg("batch"), py::arg("sweeps_per_beta"),
+             py::call_guard<py::gil_scoped_release>());
+
+    py::enum_<qanneal::SolverEngine>(m, "SolverEngine")
+        .value("ANNEALER", qanneal::SolverEngine::Annealer)
+        .value("PARALLEL_TEMPERING", qanneal::SolverEngine::ParallelTempering)
+        .value("POPULATION", qanneal::SolverEngine::Population);
+
+    py::class_<qanneal::SolverJob>(m, "SolverJob")
+        .def(py::init<>())
+        .def_property("hamiltonian",
+                      [](const qanneal::SolverJob &job) {
+                          return std::const_pointer_cast<qanneal::Hamiltonian>(job.hamiltonian);
+                      },
+                      [](qanneal::SolverJob &job, std::shared_ptr<qanneal::Hamiltonian> ham) {
+                          job.hamiltonian = std::move(ham);
+                      })
+        .def_readwrite("engine", &qanneal::SolverJob::engine)
+        .def_readwrite("schedule", &qanneal::SolverJob::schedule)
+        .def_readwrite("betas", &qanneal::SolverJob::betas)
+        .def_readwrite("steps", &qanneal::SolverJob::steps)
+        .def_readwrite("population", &qanneal::SolverJob::population)
+        .def_readwrite("sweeps", &qanneal::SolverJob::sweeps)
+        .def_readwrite("restarts", &qanneal::SolverJob::restarts)
+        .def_readwrite("seed", &qanneal::SolverJob::seed)
+        .def_readwrite("priority", &qanneal::SolverJob::priority)
+        .def_readwrite("stop", &qanneal::SolverJob::stop);
+
+    py::class_<qanneal::SolverJobResult>(m, "SolverJobResult")
+        .def_readonly("best_state", &qanneal::SolverJobResult::best_state)
+        .def_readonly("best_energy", &qanneal::SolverJobResult::best_energy)
+        .def_property_readonly("restart_energies", view_of(&qanneal::SolverJobResult::restart_energies))
+        .def_readonly("restart_stop_reasons", &qanneal::SolverJobResult::restart_stop_reasons)
+        .def_readonly("stop_reason", &qanneal::SolverJobResult::stop_reason)
+        .def_readonly("sweeps", &qanneal::SolverJobResult::sweeps);
+
+    py::class_<SolverFuture>(m, "SolverFuture")
+        .def("done", [](const SolverFuture &f) {
+            return f.future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+        })
+        .def("result", [](const SolverFuture &f, py::object timeout) {
+            {
+                py::gil_scoped_release release;
+                if (timeout.is_none()) {
+                    f.future.wait();
+                } else {
+                    const auto wait = std::chrono::duration<double>(timeout.cast<double>());
+                    if (f.future.wait_for(wait) != std::future_status::ready) {
+                        throw std::runtime_error("SolverFuture.result() timed out.");
+                    }
+                }
+            }
+            return f.future.get();
+        }, py::arg("timeout") = py::none());
+
+    // Destroying the pool waits for every submitted job, so it drops the
+    // GIL: the jobs may need it to release the buffers of a view.
+    py::class_<qanneal::SolverPool, std::shared_ptr<qanneal::SolverPool>>(m, "SolverPool")
+        .def(py::init([](std::size_t threads) {
+            return std::shared_ptr<qanneal::SolverPool>(new qanneal::SolverPool(threads),
+                                                        [](qanneal::SolverPool *pool) {
+                                                            py::gil_scoped_release release;
+                                                            delete pool;
+                                                        });
+        }), py::arg("threads") = 0)
+        .def("threads", &qanneal::SolverPool::threads)
+        .def("submit", [](qanneal::SolverPool &pool, qanneal::SolverJob job) {
+            return SolverFuture{pool.submit(std::move(job)).share()};
+        }, py::arg("job"));
 
     py::class_<qanneal::SQASchedule>(m, "SQASchedule")
         .def(py::init<>())
@@ -248,12 +721,83 @@ PYBIND11_MODULE(_qanneal, m) {
         .def(py::init<>())
         .def_readonly("energy_trace", &qanneal::SQAMetricsObserver::energy_trace)
         .def_readonly("magnetization_trace", &qanneal::SQAMetricsObserver::magnetization_trace)
+        .def_readonly("counter_trace", &qanneal::SQAMetricsObserver::counter_trace)
         .def("clear", &qanneal::SQAMetricsObserver::clear);
 
+    // Registered after SQAObserver so it can be passed to every engine.
+    py::class_<qanneal::TelemetryOptions>(m, "TelemetryOptions")
+        .def(py::init<>())
+        .def_readwrite("path", &qanneal::TelemetryOptions::path)
+        .def_readwrite("decimation", &qanneal::TelemetryOptions::decimation)
+        .def_readwrite("capacity", &qanneal::TelemetryOptions::capacity)
+        .def_readwrite("store_spins", &qanneal::TelemetryOptions::store_spins);
+
+    py::class_<qanneal::TelemetryObserver, qanneal::Observer, qanneal::SQAObserver,
+               std::shared_ptr<qanneal::TelemetryObserver>>(m, "TelemetryObserver")
+        .def(py::init<qanneal::TelemetryOptions>(), py::arg("options"))
+        .def("close", &qanneal::TelemetryObserver::close, py::call_guard<py::gil_scoped_release>())
+        .def_property_readonly("written", &qanneal::TelemetryObserver::written)
+        .def_property_readonly("dropped", &qanneal::TelemetryObserver::dropped)
+        .def("__enter__", [](std::shared_ptr<qanneal::TelemetryObserver> self) { return self; })
+        .def("__exit__", [](qanneal::TelemetryObserver &self, py::object, py::object, py::object) {
+            py::gil_scoped_release release;
+            self.close();
+        });
+
+    // Calls `callback(steps, betas, gammas, energies, magnetizations)` with
+    // numpy arrays every `interval` steps; the engine runs without the GIL
+    // and takes it only for these calls.
+    py::class_<qanneal::BatchedObserver, qanneal::Observer, qanneal::SQAObserver,
+               std::shared_ptr<qanneal::BatchedObserver>>(m, "BatchedObserver")
+        .def(py::init([](py::function callback, std::size_t interval) {
+            auto target = std::shared_ptr<py::function>(new py::function(std::move(callback)),
+                                                        [](py::function *f) {
+                                                            py::gil_scoped_acquire gil;
+                                                            delete f;
+                                                        });
+            return std::make_shared<qanneal::BatchedObserver>([target](qanneal::ObserverBatch batch) {
+                py::gil_scoped_acquire gil;
+                const auto k = static_cast<py::ssize_t>(batch.size());
+                (*target)(adopt(std::move(batch.steps), {k}),
+                          adopt(std::move(batch.betas), {k}),
+                          adopt(std::move(batch.gammas), {k}),
+                          adopt(std::move(batch.energies), {k}),
+                          adopt(std::move(batch.magnetizations), {k}));
+                // Lets Ctrl-C stop a long run at the next batch.
+                if (PyErr_CheckSignals() != 0) {
+                    throw py::error_already_set();
+                }
+            }, interval);
+        }), py::arg("callback"), py::arg("interval") = 64)
+        .def("flush", &qanneal::BatchedObserver::flush)
+        .def_property_readonly("interval", &qanneal::BatchedObserver::interval)
+        .def_property_readonly("pending", &qanneal::BatchedObserver::pending);
+
+    py::class_<qanneal::TelemetryTrace>(m, "TelemetryTrace")
+        .def_readonly("snapshot_spins", &qanneal::TelemetryTrace::snapshot_spins)
+        .def_readonly("has_spins", &qanneal::TelemetryTrace::has_spins)
+        .def_property_readonly("steps", view_of(&qanneal::TelemetryTrace::steps))
+        .def_property_readonly("betas", view_of(&qanneal::TelemetryTrace::betas))
+        .def_property_readonly("gammas", view_of(&qanneal::TelemetryTrace::gammas))
+        .def_property_readonly("energies", view_of(&qanneal::TelemetryTrace::energies))
+        .def_property_readonly("magnetizations", view_of(&qanneal::TelemetryTrace::magnetizations))
+        // [records, snapshot_spins] int8, empty without spins.
+        .def_property_readonly("spins", [](py::object self) {
+            const auto &trace = self.cast<const qanneal::TelemetryTrace &>();
+            const auto width = static_cast<py::ssize_t>(trace.has_spins ? trace.snapshot_spins : 0);
+            const auto rows = width > 0 ? static_cast<py::ssize_t>(trace.spins.size()) / width : 0;
+            return vector_view(trace.spins, self, {rows, width});
+        })
+        .def("__len__", &qanneal::TelemetryTrace::size);
+    m.def("read_telemetry", &qanneal::read_telemetry, py::arg("path"));
+
     py::class_<qanneal::SQAResult>(m, "SQAResult")
         .def_readonly("best_state", &qanneal::SQAResult::best_state)
         .def_readonly("best_energy", &qanneal::SQAResult::best_energy)
-        .def_readonly("energy_trace", &qanneal::SQAResult::energy_trace);
+        .def_property_readonly("energy_trace", view_of(&qanneal::SQAResult::energy_trace))
+        .def_readonly("step_counters", &qanneal::SQAResult::step_counters)
+        .def_readonly("stop_reason", &qanneal::SQAResult::stop_reason)
+        .def_readonly("sweeps", &qanneal::SQAResult::sweeps);
 
     py::class_<qanneal::SQAAnnealer>(m, "SQAAnnealer")
         .def(py::init([](std::shared_ptr<qanneal::Hamiltonian> ham,
@@ -272,24 +816,39 @@ PYBIND11_MODULE(_qanneal, m) {
         py::arg("backend") = "cpu",
         py::keep_alive<1, 2>())
         .def("set_seed", &qanneal::SQAAnnealer::set_seed)
+        .def("set_polish", &qanneal::SQAAnnealer::set_polish, py::arg("options"))
+        .def("set_stop_criteria", &qanneal::SQAAnnealer::set_stop_criteria, py::arg("criteria"))
+        .def("set_sample_set", &qanneal::SQAAnnealer::set_sample_set, py::arg("samples"))
+        .def("set_checkpoint", &qanneal::SQAAnnealer::set_checkpoint, py::arg("options"))
         .def("run", [](qanneal::SQAAnnealer &self,
                        std::size_t sweeps_per_beta,
                        std::size_t worldline_sweeps,
                        std::shared_ptr<qanneal::SQAObserver> obs) {
-            return self.run(sweeps_per_beta, worldline_sweeps, obs.get());
-        }, py::arg("sweeps_per_beta"), py::arg("worldline_sweeps"), py::arg("observer") = nullptr);
+            auto result = self.run(sweeps_per_beta, worldline_sweeps, obs.get());
+            flush_batches(obs.get());
+            return result;
+        }, py::arg("sweeps_per_beta"), py::arg("worldline_sweeps"), py::arg("observer") = nullptr,
+           py::call_guard<py::gil_scoped_release>())
+        .def("resume", [](qanneal::SQAAnnealer &self,
+                          const std::string &path,
+                          std::size_t sweeps_per_beta,
+                          std::size_t worldline_sweeps,
+                          std::shared_ptr<qanneal::SQAObserver> obs) {
+            auto result = self.resume(path, sweeps_per_beta, worldline_sweeps, obs.get());
+            flush_batches(obs.get());
+            return result;
+        }, py::arg("path"), py::arg("sweeps_per_beta"), py::arg("worldline_sweeps"),
+           py::arg("observer") = nullptr, py::call_guard<py::gil_scoped_release>());
 
-    m.def("magnetization", [](const py::sequence &spins) {
-        auto data = seq_to_spins(spins);
-        return qanneal::magnetization(data.data(), data.size());
+    m.def("magnetization", [](SpinArray spins) {
+        return qanneal::magnetization(spins.data(), vector_length(spins, "spins"));
     });
 
-    m.def("overlap", [](const py::sequence &a, const py::sequence &b) {
-        auto da = seq_to_spins(a);
-        auto db = seq_to_spins(b);
-        if (da.size() != db.size()) {
+    m.def("overlap", [](SpinArray a, SpinArray b) {
+        const std::size_t n = vector_length(a, "spins");
+        if (vector_length(b, "spins") != n) {
             throw std::invalid_argument("Spin vectors must be same length.");
         }
-        return qanneal::overlap(da.data(), db.data(), da.size());
+        return qanneal::overlap(a.data(), b.data(), n);
     });
 }
@@ -10,27 +10,100 @@ __all__ = [
     "version_major",
     "version_minor",
     "version_patch",
+    "instrumentation_enabled",
     "State",
     "Hamiltonian",
     "DenseIsing",
+    "DenseIsingView",
+    "CsrIsingView32",
+    "CsrIsingView64",
+    "csr_ising",
+    "from_scipy",
     "SparseEdge",
     "SparseIsing",
     "QUBO",
     "AnnealSchedule",
+    "BetaRange",
+    "AdaptiveScheduleOptions",
+    "estimate_beta_range",
+    "auto_schedule",
+    "adaptive_schedule",
+    "StopReason",
+    "CancellationToken",
+    "StopCriteria",
+    "CheckpointOptions",
+    "PolishMode",
+    "PolishOptions",
+    "StepCounters",
+    "sum_counters",
+    "set_hardware_counters",
+    "hardware_counters",
+    "hardware_counter_status",
     "Observer",
     "MetricsObserver",
     "AnnealResult",
+    "Sample",
+    "SampleSet",
+    "EnergyHistogram",
+    "UpdateMode",
     "Annealer",
     "ReplicaResult",
     "MultiAnnealResult",
     "ReplicaAnnealer",
     "ParallelTemperingAnnealer",
     "ParallelTemperingResult",
+    "ClusterUpdate",
+    "ClusterMoveOptions",
+    "PopulationAnnealer",
+    "PopulationAnnealResult",
+    "IsingBatch",
+    "BatchResult",
+    "BatchAnnealer",
+    "SolverEngine",
+    "SolverJob",
+    "SolverJobResult",
+    "SolverFuture",
+    "SolverPool",
     "SQASchedule",
     "SQAObserver",
     "SQAMetricsObserver",
+    "TelemetryOptions",
+    "TelemetryObserver",
+    "BatchedObserver",
+    "TelemetryTrace",
+    "read_telemetry",
     "SQAResult",
     "SQAAnnealer",
     "magnetization",
     "overlap",
 ]
+
+
+def from_scipy(matrix, h=None, c=0.0):
+    """Ising model over a symmetric scipy.sparse coupling matrix.
+
+    A CSR matrix with float64 data is read in place (other formats and dtypes
+    are converted once), so it must stay unchanged while the model is in use.
+    Each coupling must appear in both triangles; the diagonal is ignored.
+    """
+    import numpy as np
+
+    csr = matrix.tocsr()
+    n = csr.shape[0]
+    if csr.shape != (n, n):
+        raise ValueError("Expected a square coupling matrix.")
+    if h is None:
+        h = np.zeros(n)
+    return csr_ising(h, csr.indptr, csr.indices, csr.data, c)
+
+
+def _solver_future_await(self):
+    # Wait on an executor thread; SolverFuture.result() drops the GIL while
+    # blocked, so the event loop keeps running.
+    import asyncio
+
+    loop = asyncio.get_running_loop()
+    return loop.run_in_executor(None, self.result).__await__()
+
+
+SolverFuture.__await__ = _solver_future_await
@@ -0,0 +1,14 @@
+#!/bin/bash
+#SBATCH -J qanneal_hybrid_srun
+#SBATCH -N 2
+#SBATCH --ntasks-per-node=2
+#SBATCH --cpus-per-task=16
+#SBATCH --time=00:10:00
+#SBATCH --partition=compute
+
+# One rank per socket, one pinned worker thread per core of that socket.
+# OpenMPI example. Adjust module name and counts for your cluster.
+# module load openmpi
+
+export OMP_NUM_THREADS=${SLURM_CPUS_PER_TASK}
+srun --cpu-bind=sockets qanneal/build/qanneal_mpi_hybrid_example
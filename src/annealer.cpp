@@ -1,17 +1,23 @@
 #include "qanneal/annealer.hpp"
 
+#include "qanneal/flip_journal.hpp"
+
 #include <cmath>
 #include <stdexcept>
 
 namespace qanneal {
 
+namespace {
+
+constexpr const char *kCheckpointTag = "annealer";
+
+} // namespace
+
 Annealer::Annealer(const Hamiltonian &hamiltonian, AnnealSchedule schedule)
     : backend_(make_backend(BackendKind::CPU, hamiltonian)),
       schedule_(std::move(schedule)),
       rng_(std::random_device{}()) {
-    if (schedule_.betas.empty()) {
-        throw std::invalid_argument("Schedule must contain at least one beta.");
-    }
+    schedule_.validate();
 }
 
 Annealer::Annealer(std::shared_ptr<Backend> backend, AnnealSchedule schedule)
@@ -21,48 +27,235 @@ Annealer::Annealer(std::shared_ptr<Backend> backend, AnnealSchedule schedule)
     if (!backend_) {
         throw std::invalid_argument("Annealer requires a backend.");
     }
-    if (schedule_.betas.empty()) {
-        throw std::invalid_argument("Schedule must contain at least one beta.");
-    }
+    schedule_.validate();
 }
 
 void Annealer::set_seed(std::uint64_t seed) {
     rng_.seed(seed);
 }
 
+void Annealer::set_polish(PolishOptions options) {
+    polish_ = options;
+}
+
+void Annealer::set_stop_criteria(StopCriteria criteria) {
+    stop_ = std::move(criteria);
+}
+
+void Annealer::set_checkpoint(CheckpointOptions options) {
+    if (options.interval == 0) {
+        throw std::invalid_argument("checkpoint interval must be > 0.");
+    }
+    checkpoint_ = std::move(options);
+}
+
+void Annealer::set_sample_set(std::shared_ptr<SampleSet> samples) {
+    samples_ = std::move(samples);
+}
+
+void Annealer::set_update_mode(UpdateMode mode, double acceptance_threshold) {
+    if (acceptance_threshold < 0.0 || acceptance_threshold > 1.0) {
+        throw std::invalid_argument("acceptance_threshold must be in [0, 1].");
+    }
+    mode_ = mode;
+    acceptance_threshold_ = acceptance_threshold;
+}
+
 AnnealResult Annealer::run(std::size_t sweeps_per_beta, Observer *observer) {
+    return run_from(sweeps_per_beta, observer, nullptr);
+}
+
+AnnealResult Annealer::resume(const std::string &path,
+                              std::size_t sweeps_per_beta,
+                              Observer *observer) {
+    CheckpointReader reader(path, kCheckpointTag);
+    return run_from(sweeps_per_beta, observer, &reader);
+}
+
+AnnealResult Annealer::run_from(std::size_t sweeps_per_beta,
+                                Observer *observer,
+                                CheckpointReader *reader) {
     if (sweeps_per_beta == 0) {
         throw std::invalid_argument("sweeps_per_beta must be > 0.");
     }
 
     std::uniform_real_distribution<double> uniform(0.0, 1.0);
 
-    State state = State::random(backend_->size(), rng_);
+    const std::size_t n = backend_->size();
+    State state = State::random(n, rng_);
     double energy = backend_->energy(state.spins.data(), state.size());
 
     AnnealResult result;
     result.best_state = state;
     result.best_energy = energy;
     result.energy_trace.reserve(schedule_.size());
+    result.acceptance_trace.reserve(schedule_.size());
+    result.rejection_free_step = schedule_.size();
+
+    bool rejection_free = (mode_ == UpdateMode::RejectionFree);
+    RejectionFreeSampler sampler;
+    if (mode_ != UpdateMode::Metropolis) {
+        sampler = RejectionFreeSampler(require_hamiltonian(*backend_).coupling_graph());
+    }
+
+    StopMonitor monitor(stop_);
+    std::size_t first_step = 0;
+    FlipJournal journal;
+    journal.reserve(n);
 
-    for (std::size_t step = 0; step < schedule_.betas.size(); ++step) {
+    if (reader) {
+        if (reader->read_size() != sweeps_per_beta || reader->read_doubles() != schedule_.betas) {
+            throw std::invalid_argument("Checkpoint was written for a different schedule.");
+        }
+        first_step = reader->read_size();
+        reader->read_rng(rng_);
+        state = reader->read_state();
+        energy = reader->read_f64();
+        result.best_state = reader->read_state();
+        result.best_energy = reader->read_f64();
+        result.energy_trace = reader->read_doubles();
+        result.acceptance_trace = reader->read_doubles();
+        result.rejection_free_step = reader->read_size();
+        rejection_free = reader->read_u64() != 0;
+        reader->read_monitor(monitor);
+        reader->finish();
+        if (state.size() != n) {
+            throw std::invalid_argument("Checkpoint state size does not match the problem.");
+        }
+    }
+    instrumentation::reset();
+    instrumentation::skip_steps(result.step_counters, first_step);
+
+    // Zobrist hash of `state`, kept current flip by flip while sampling.
+    SampleSet *samples = samples_.get();
+    const std::uint64_t *keys = nullptr;
+    std::uint64_t hash = 0;
+    if (samples) {
+        if (samples->num_spins() != n) {
+            throw std::invalid_argument("Sample set size does not match the problem.");
+        }
+        keys = samples->zobrist().keys();
+        hash = samples->zobrist().hash(state);
+    }
+
+    for (std::size_t step = first_step; step < schedule_.betas.size() && !monitor.stopped(); ++step) {
         const double beta = schedule_.betas[step];
-        for (std::size_t sweep = 0; sweep < sweeps_per_beta; ++sweep) {
-            for (std::size_t i = 0; i < backend_->size(); ++i) {
-                const double delta = backend_->delta_energy(state.spins.data(), state.size(), i);
-                if (delta <= 0.0 || uniform(rng_) < std::exp(-beta * delta)) {
-                    state[i] = static_cast<int8_t>(-state[i]);
-                    energy += delta;
+        const std::size_t sweeps = schedule_.sweeps_at(step, sweeps_per_beta);
+        std::size_t accepted = 0;
+        std::size_t sweeps_done = 0;
+        instrumentation::PhaseTimer timer;
+        if (rejection_free) {
+            if (result.rejection_free_step == schedule_.size()) {
+                result.rejection_free_step = step;
+            }
+            sampler.reset(state, beta);
+        }
+        for (std::size_t sweep = 0; sweep < sweeps; ++sweep) {
+            if (rejection_free) {
+                // Waiting times are exponential, so discarding the overshoot
+                // at each sweep boundary leaves the dynamics unchanged.
+                double time_left = 1.0;
+                std::size_t flipped = n;
+                while (true) {
+                    time_left -= sampler.step(state, energy, time_left, rng_, flipped);
+                    if (flipped == n) {
+                        break;
+                    }
+                    ++accepted;
+                    journal.record(flipped);
+                    if (keys) {
+                        hash ^= keys[flipped];
+                    }
                     if (energy < result.best_energy) {
                         result.best_energy = energy;
-                        result.best_state = state;
+                        journal.mark_best();
                     }
                 }
+            } else {
+                for (std::size_t i = 0; i < n; ++i) {
+                    const double delta = backend_->delta_energy(state.spins.data(), state.size(), i);
+                    if (delta <= 0.0 || uniform(rng_) < std::exp(-beta * delta)) {
+                        state[i] = static_cast<int8_t>(-state[i]);
+                        energy += delta;
+                        ++accepted;
+                        journal.record(i);
+                        if (keys) {
+                            hash ^= keys[i];
+                        }
+                        if (energy < result.best_energy) {
+                            result.best_energy = energy;
+                            journal.mark_best();
+                        }
+                    }
+                }
+            }
+            if (journal.has_best()) {
+                journal.rebuild_best(state, result.best_state);
             }
+            journal.clear();
+            if (samples) {
+                samples->add(state.spins.data(), energy, hash);
+            }
+            ++sweeps_done;
+            if (monitor.record(1, result.best_energy)) {
+                break;
+            }
+        }
+        // Every rejection-free event is an accepted flip.
+        instrumentation::add(&StepCounters::attempted_flips, rejection_free ? accepted : sweeps_done * n);
+        instrumentation::add(&StepCounters::accepted_flips, accepted);
+        timer.end_sweeps();
+        const double attempts = static_cast<double>(sweeps_done) * static_cast<double>(n);
+        const double acceptance = (attempts > 0.0) ? static_cast<double>(accepted) / attempts : 0.0;
+        if (mode_ == UpdateMode::Adaptive && acceptance < acceptance_threshold_) {
+            rejection_free = true;
         }
         result.energy_trace.push_back(energy);
+        result.acceptance_trace.push_back(acceptance);
         if (observer) {
             observer->record(step, beta, energy, state);
+            timer.lap(&StepCounters::observer_ns);
+        }
+        instrumentation::finish_step(result.step_counters);
+        if constexpr (instrumentation::enabled) {
+            if (observer) {
+                observer->record_counters(step, result.step_counters.back());
+            }
+        }
+
+        if (!checkpoint_.path.empty() && !monitor.stopped() &&
+            (step + 1) % checkpoint_.interval == 0) {
+            CheckpointWriter writer(kCheckpointTag);
+            writer.write_size(sweeps_per_beta);
+            writer.write_doubles(schedule_.betas);
+            writer.write_size(step + 1);
+            writer.write_rng(rng_);
+            writer.write_state(state);
+            writer.write_f64(energy);
+            writer.write_state(result.best_state);
+            writer.write_f64(result.best_energy);
+            writer.write_doubles(result.energy_trace);
+            writer.write_doubles(result.acceptance_trace);
+            writer.write_size(result.rejection_free_step);
+            writer.write_u64(rejection_free ? 1 : 0);
+            writer.write_monitor(monitor);
+            writer.commit(checkpoint_.path);
+        }
+    }
+
+    result.stop_reason = monitor.reason();
+    result.sweeps = monitor.sweeps();
+
+    if (polish_.mode != PolishMode::None) {
+        LocalSearch search(require_hamiltonian(*backend_).coupling_graph());
+        std::vector<State> candidates = {state, result.best_state};
+        std::vector<double> candidate_energies = {energy, result.best_energy};
+        search.polish_all(candidates, candidate_energies, polish_);
+        for (std::size_t k = 0; k < candidates.size(); ++k) {
+            if (candidate_energies[k] < result.best_energy) {
+                result.best_energy = candidate_energies[k];
+                result.best_state = std::move(candidates[k]);
+            }
         }
     }
 
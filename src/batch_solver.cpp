@@ -0,0 +1,250 @@
+#include "qanneal/batch_solver.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace qanneal {
+
+namespace {
+
+std::uint64_t splitmix64(std::uint64_t x) {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+// Per-thread buffers, grown to the largest instance a thread has seen.
+struct BatchWorkspace {
+    std::vector<int8_t> spins;
+    std::vector<double> fields;
+};
+
+thread_local BatchWorkspace tls_workspace;
+
+} // namespace
+
+IsingBatch::IsingBatch(const std::vector<DenseIsing> &problems) {
+    std::size_t spins = 0;
+    std::size_t couplings = 0;
+    for (const auto &problem : problems) {
+        spins += problem.size();
+        couplings += problem.size() * problem.size();
+    }
+    reserve(problems.size(), spins, couplings);
+    for (const auto &problem : problems) {
+        add(problem);
+    }
+}
+
+IsingBatch::IsingBatch(const std::vector<std::size_t> &sizes,
+                       const std::vector<double> &h,
+                       const std::vector<double> &J,
+                       const std::vector<double> &constants) {
+    if (!constants.empty() && constants.size() != sizes.size()) {
+        throw std::invalid_argument("IsingBatch constants size mismatch.");
+    }
+    std::size_t spins = 0;
+    std::size_t couplings = 0;
+    for (std::size_t n : sizes) {
+        spins += n;
+        couplings += n * n;
+    }
+    if (h.size() != spins) {
+        throw std::invalid_argument("IsingBatch h size mismatch.");
+    }
+    if (J.size() != couplings) {
+        throw std::invalid_argument("IsingBatch J size mismatch.");
+    }
+    reserve(sizes.size(), spins, couplings);
+    std::size_t h_pos = 0;
+    std::size_t j_pos = 0;
+    for (std::size_t k = 0; k < sizes.size(); ++k) {
+        add(h.data() + h_pos, J.data() + j_pos, sizes[k], constants.empty() ? 0.0 : constants[k]);
+        h_pos += sizes[k];
+        j_pos += sizes[k] * sizes[k];
+    }
+}
+
+void IsingBatch::reserve(std::size_t instances, std::size_t total_spins, std::size_t total_couplings) {
+    spin_offsets_.reserve(instances + 1);
+    coupling_offsets_.reserve(instances + 1);
+    constants_.reserve(instances);
+    h_.reserve(total_spins);
+    J_.reserve(total_couplings);
+}
+
+void IsingBatch::add(const double *h, const double *J, std::size_t n, double c) {
+    if (n == 0) {
+        throw std::invalid_argument("IsingBatch instance size must be > 0.");
+    }
+    h_.insert(h_.end(), h, h + n);
+    const std::size_t base = J_.size();
+    J_.resize(base + n * n, 0.0);
+    double *block = J_.data() + base;
+    for (std::size_t i = 0; i < n; ++i) {
+        for (std::size_t j = i + 1; j < n; ++j) {
+            block[i * n + j] = J[i * n + j];
+            block[j * n + i] = J[i * n + j];
+        }
+    }
+    constants_.push_back(c);
+    spin_offsets_.push_back(h_.size());
+    coupling_offsets_.push_back(J_.size());
+}
+
+void IsingBatch::add(const DenseIsing &problem) {
+    add(problem.h().data(), problem.J().data(), problem.size(), problem.constant());
+}
+
+void IsingBatch::add(const Hamiltonian &problem) {
+    if (const auto *dense = dynamic_cast<const DenseIsing *>(&problem)) {
+        add(*dense);
+        return;
+    }
+    const CouplingGraph graph = problem.coupling_graph();
+    const std::size_t n = graph.size();
+    std::vector<double> J(n * n, 0.0);
+    double field_sum = 0.0;
+    double coupling_sum = 0.0;
+    for (std::size_t i = 0; i < n; ++i) {
+        field_sum += graph.h[i];
+        for (std::size_t k = graph.offsets[i]; k < graph.offsets[i + 1]; ++k) {
+            const std::size_t j = graph.neighbors[k];
+            // Duplicate edges add up, as in the single-problem engines.
+            J[i * n + j] += graph.weights[k];
+            if (i < j) {
+                coupling_sum += graph.weights[k];
+            }
+        }
+    }
+    // The graph carries no constant; recover it from the all-up energy.
+    const std::vector<int8_t> up(n, 1);
+    const double c = problem.energy(up.data(), n) - field_sum - coupling_sum;
+    add(graph.h.data(), J.data(), n, c);
+}
+
+double IsingBatch::energy(std::size_t k, const int8_t *spins) const {
+    const std::size_t n = this->spins(k);
+    const double *hk = h(k);
+    const double *Jk = J(k);
+    double E = constant(k);
+    for (std::size_t i = 0; i < n; ++i) {
+        const double s = static_cast<double>(spins[i]);
+        E += hk[i] * s;
+        for (std::size_t j = i + 1; j < n; ++j) {
+            E += Jk[i * n + j] * s * static_cast<double>(spins[j]);
+        }
+    }
+    return E;
+}
+
+State BatchResult::best_state(std::size_t k) const {
+    State state(offsets[k + 1] - offsets[k]);
+    std::copy(best_spins.begin() + static_cast<std::ptrdiff_t>(offsets[k]),
+              best_spins.begin() + static_cast<std::ptrdiff_t>(offsets[k + 1]),
+              state.spins.begin());
+    return state;
+}
+
+BatchAnnealer::BatchAnnealer(AnnealSchedule schedule)
+    : schedule_(std::move(schedule)),
+      rng_(std::random_device{}()) {
+    schedule_.validate();
+}
+
+void BatchAnnealer::set_seed(std::uint64_t seed) {
+    rng_.seed(seed);
+}
+
+void BatchAnnealer::set_threads(std::size_t threads) {
+    if (threads != threads_) {
+        pool_.reset();
+    }
+    threads_ = threads;
+}
+
+BatchResult BatchAnnealer::run(const IsingBatch &batch, std::size_t sweeps_per_beta) {
+    if (sweeps_per_beta == 0) {
+        throw std::invalid_argument("sweeps_per_beta must be > 0.");
+    }
+    if (!pool_) {
+        pool_ = std::make_unique<ThreadPool>(threads_);
+    }
+
+    const std::size_t count = batch.size();
+    BatchResult result;
+    result.offsets.resize(count + 1);
+    for (std::size_t k = 0; k <= count; ++k) {
+        result.offsets[k] = (k < count) ? batch.spin_offset(k) : batch.total_spins();
+    }
+    result.best_spins.assign(batch.total_spins(), 1);
+    result.best_energies.assign(count, 0.0);
+
+    const std::uint64_t base_seed = rng_();
+    const std::vector<double> &betas = schedule_.betas;
+
+    pool_->parallel_for(count, 1, [&](std::size_t k) {
+        const std::size_t n = batch.spins(k);
+        const double *h = batch.h(k);
+        const double *J = batch.J(k);
+        auto &ws = tls_workspace;
+        if (ws.spins.size() < n) {
+            ws.spins.resize(n);
+            ws.fields.resize(n);
+        }
+        int8_t *spins = ws.spins.data();
+        double *fields = ws.fields.data();
+        int8_t *best = result.best_spins.data() + result.offsets[k];
+
+        std::mt19937_64 gen(splitmix64(base_seed + k));
+        std::uniform_real_distribution<double> uniform(0.0, 1.0);
+        for (std::size_t i = 0; i < n; ++i) {
+            spins[i] = (gen() & 1U) ? 1 : -1;
+        }
+
+        // fields[i] = h_i + sum_j J_ij s_j, so flipping i changes the energy
+        // by -2 s_i fields[i].
+        double energy = batch.constant(k);
+        for (std::size_t i = 0; i < n; ++i) {
+            const double *row = J + i * n;
+            double field = h[i];
+            for (std::size_t j = 0; j < n; ++j) {
+                field += row[j] * static_cast<double>(spins[j]);
+            }
+            fields[i] = field;
+            energy += 0.5 * static_cast<double>(spins[i]) * (field + h[i]);
+        }
+        double best_energy = energy;
+        std::copy(spins, spins + n, best);
+
+        for (std::size_t step = 0; step < betas.size(); ++step) {
+            const double beta = betas[step];
+            const std::size_t sweeps = schedule_.sweeps_at(step, sweeps_per_beta);
+            for (std::size_t sweep = 0; sweep < sweeps; ++sweep) {
+                for (std::size_t i = 0; i < n; ++i) {
+                    const double delta = -2.0 * static_cast<double>(spins[i]) * fields[i];
+                    if (delta <= 0.0 || uniform(gen) < std::exp(-beta * delta)) {
+                        spins[i] = static_cast<int8_t>(-spins[i]);
+                        energy += delta;
+                        const double change = 2.0 * static_cast<double>(spins[i]);
+                        const double *row = J + i * n;
+                        for (std::size_t j = 0; j < n; ++j) {
+                            fields[j] += change * row[j];
+                        }
+                        if (energy < best_energy) {
+                            best_energy = energy;
+                            std::copy(spins, spins + n, best);
+                        }
+                    }
+                }
+            }
+        }
+        result.best_energies[k] = best_energy;
+    });
+
+    return result;
+}
+
+} // namespace qanneal
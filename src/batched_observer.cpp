@@ -0,0 +1,76 @@
+#include "qanneal/batched_observer.hpp"
+
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+#include "qanneal/metrics.hpp"
+
+namespace qanneal {
+
+BatchedObserver::BatchedObserver(Callback callback, std::size_t interval)
+    : callback_(std::move(callback)), interval_(interval) {
+    if (!callback_) {
+        throw std::invalid_argument("BatchedObserver needs a callback.");
+    }
+    if (interval_ == 0) {
+        throw std::invalid_argument("BatchedObserver interval must be > 0.");
+    }
+    reserve();
+}
+
+void BatchedObserver::record(std::size_t step,
+                             double beta,
+                             double energy,
+                             const State &state) {
+    push(step, beta, std::numeric_limits<double>::quiet_NaN(), energy, magnetization(state));
+}
+
+void BatchedObserver::record(std::size_t step,
+                             double beta,
+                             double gamma,
+                             double avg_energy,
+                             const SQAState &state) {
+    const std::size_t count = state.replicas() * state.slices() * state.spins();
+    double sum = 0.0;
+    for (std::size_t r = 0; r < state.replicas(); ++r) {
+        for (std::size_t t = 0; t < state.slices(); ++t) {
+            const int8_t *ptr = state.slice_ptr(r, t);
+            for (std::size_t i = 0; i < state.spins(); ++i) {
+                sum += static_cast<double>(ptr[i]);
+            }
+        }
+    }
+    push(step, beta, gamma, avg_energy, count > 0 ? sum / static_cast<double>(count) : 0.0);
+}
+
+void BatchedObserver::flush() {
+    if (pending_.size() == 0) {
+        return;
+    }
+    ObserverBatch batch = std::move(pending_);
+    pending_ = ObserverBatch{};
+    reserve();
+    callback_(std::move(batch));
+}
+
+void BatchedObserver::push(std::size_t step, double beta, double gamma, double energy, double magnetization) {
+    pending_.steps.push_back(step);
+    pending_.betas.push_back(beta);
+    pending_.gammas.push_back(gamma);
+    pending_.energies.push_back(energy);
+    pending_.magnetizations.push_back(magnetization);
+    if (pending_.size() >= interval_) {
+        flush();
+    }
+}
+
+void BatchedObserver::reserve() {
+    pending_.steps.reserve(interval_);
+    pending_.betas.reserve(interval_);
+    pending_.gammas.reserve(interval_);
+    pending_.energies.reserve(interval_);
+    pending_.magnetizations.reserve(interval_);
+}
+
+}
@@ -0,0 +1,273 @@
+#include "qanneal/checkpoint.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+
+namespace qanneal {
+
+namespace {
+
+constexpr char kMagic[8] = {'Q', 'A', 'N', 'N', 'C', 'K', 'P', 'T'};
+constexpr std::uint64_t kVersion = 1;
+
+} // namespace
+
+CheckpointWriter::CheckpointWriter(const std::string &tag) {
+    append(kMagic, sizeof(kMagic));
+    write_u64(kVersion);
+    write_u64(tag.size());
+    append(tag.data(), tag.size());
+}
+
+void CheckpointWriter::append(const void *data, std::size_t bytes) {
+    buffer_.append(static_cast<const char *>(data), bytes);
+}
+
+void CheckpointWriter::write_u64(std::uint64_t value) {
+    unsigned char bytes[8];
+    for (std::size_t b = 0; b < 8; ++b) {
+        bytes[b] = static_cast<unsigned char>(value >> (8 * b));
+    }
+    append(bytes, sizeof(bytes));
+}
+
+void CheckpointWriter::write_f64(double value) {
+    std::uint64_t bits = 0;
+    std::memcpy(&bits, &value, sizeof(bits));
+    write_u64(bits);
+}
+
+void CheckpointWriter::write_doubles(const std::vector<double> &values) {
+    write_size(values.size());
+    for (double v : values) {
+        write_f64(v);
+    }
+}
+
+void CheckpointWriter::write_sizes(const std::vector<std::size_t> &values) {
+    write_size(values.size());
+    for (std::size_t v : values) {
+        write_size(v);
+    }
+}
+
+void CheckpointWriter::write_spins(const int8_t *spins, std::size_t n) {
+    std::vector<uint8_t> packed(packed_spin_bytes(n));
+    pack_spins(spins, n, packed.data());
+    append(packed.data(), packed.size());
+}
+
+void CheckpointWriter::write_state(const State &state) {
+    write_size(state.size());
+    write_spins(state.spins.data(), state.size());
+}
+
+void CheckpointWriter::write_states(const std::vector<State> &states) {
+    write_size(states.size());
+    for (const auto &state : states) {
+        write_state(state);
+    }
+}
+
+void CheckpointWriter::write_sqa_state(const SQAState &state) {
+    write_size(state.replicas());
+    write_size(state.slices());
+    write_size(state.spins());
+    write_spins(state.data(), state.size());
+}
+
+void CheckpointWriter::write_rng(const std::mt19937_64 &rng) {
+    // The standard only exposes the engine state as whitespace-separated
+    // integers; store them as binary words (312 words plus the position in
+    // libstdc++).
+    std::ostringstream text;
+    text << rng;
+    std::istringstream in(text.str());
+    std::vector<std::uint64_t> words;
+    words.reserve(std::mt19937_64::state_size + 1);
+    std::uint64_t word = 0;
+    while (in >> word) {
+        words.push_back(word);
+    }
+    write_size(words.size());
+    for (std::uint64_t w : words) {
+        write_u64(w);
+    }
+}
+
+void CheckpointWriter::write_monitor(const StopMonitor &monitor) {
+    write_size(monitor.sweeps());
+    write_size(monitor.last_improvement());
+    write_f64(monitor.best_energy());
+    write_f64(monitor.elapsed());
+}
+
+void CheckpointWriter::commit(const std::string &path) const {
+    const std::string tmp = path + ".tmp";
+    {
+        std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            throw std::runtime_error("Cannot open checkpoint file: " + tmp);
+        }
+        out.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+        if (!out) {
+            throw std::runtime_error("Failed to write checkpoint file: " + tmp);
+        }
+    }
+    if (std::rename(tmp.c_str(), path.c_str()) != 0) {
+        throw std::runtime_error("Failed to move checkpoint into place: " + path);
+    }
+}
+
+CheckpointReader::CheckpointReader(const std::string &path, const std::string &tag) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("Cannot open checkpoint file: " + path);
+    }
+    buffer_.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+
+    char magic[sizeof(kMagic)];
+    take(magic, sizeof(magic));
+    if (std::memcmp(magic, kMagic, sizeof(kMagic)) != 0) {
+        throw std::runtime_error("Not a qanneal checkpoint: " + path);
+    }
+    if (read_u64() != kVersion) {
+        throw std::runtime_error("Unsupported checkpoint version: " + path);
+    }
+    std::string stored(read_count(1), '\0');
+    take(stored.data(), stored.size());
+    if (stored != tag) {
+        throw std::runtime_error("Checkpoint was written by '" + stored + "', expected '" + tag + "'.");
+    }
+}
+
+void CheckpointReader::take(void *data, std::size_t bytes) {
+    if (bytes > remaining()) {
+        throw std::runtime_error("Checkpoint is truncated.");
+    }
+    std::memcpy(data, buffer_.data() + pos_, bytes);
+    pos_ += bytes;
+}
+
+std::size_t CheckpointReader::read_count(std::size_t item_bytes) {
+    const std::size_t count = read_size();
+    if (count > remaining() / item_bytes) {
+        throw std::runtime_error("Checkpoint is truncated.");
+    }
+    return count;
+}
+
+void CheckpointReader::require_spins(std::size_t n) const {
+    // Spins are bit-packed, eight per byte.
+    if (n / 8 > remaining()) {
+        throw std::runtime_error("Checkpoint is truncated.");
+    }
+}
+
+std::uint64_t CheckpointReader::read_u64() {
+    unsigned char bytes[8];
+    take(bytes, sizeof(bytes));
+    std::uint64_t value = 0;
+    for (std::size_t b = 0; b < 8; ++b) {
+        value |= static_cast<std::uint64_t>(bytes[b]) << (8 * b);
+    }
+    return value;
+}
+
+double CheckpointReader::read_f64() {
+    const std::uint64_t bits = read_u64();
+    double value = 0.0;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+std::vector<double> CheckpointReader::read_doubles() {
+    std::vector<double> values(read_count(sizeof(std::uint64_t)));
+    for (auto &v : values) {
+        v = read_f64();
+    }
+    return values;
+}
+
+std::vector<std::size_t> CheckpointReader::read_sizes() {
+    std::vector<std::size_t> values(read_count(sizeof(std::uint64_t)));
+    for (auto &v : values) {
+        v = read_size();
+    }
+    return values;
+}
+
+void CheckpointReader::read_spins(int8_t *spins, std::size_t n) {
+    std::vector<uint8_t> packed(packed_spin_bytes(n));
+    take(packed.data(), packed.size());
+    unpack_spins(packed.data(), n, spins);
+}
+
+State CheckpointReader::read_state() {
+    const std::size_t n = read_size();
+    require_spins(n);
+    State state(n);
+    read_spins(state.spins.data(), state.size());
+    return state;
+}
+
+std::vector<State> CheckpointReader::read_states() {
+    std::vector<State> states;
+    // Each state holds at least its size.
+    const std::size_t count = read_count(sizeof(std::uint64_t));
+    states.reserve(count);
+    for (std::size_t k = 0; k < count; ++k) {
+        states.push_back(read_state());
+    }
+    return states;
+}
+
+SQAState CheckpointReader::read_sqa_state() {
+    const std::size_t replicas = read_size();
+    const std::size_t slices = read_size();
+    const std::size_t spins = read_size();
+    const std::size_t limit = remaining() * 8;
+    if ((replicas != 0 && slices > limit / replicas) ||
+        (replicas != 0 && slices != 0 && spins > limit / (replicas * slices))) {
+        throw std::runtime_error("Checkpoint is truncated.");
+    }
+    SQAState state(replicas, slices, spins);
+    read_spins(state.data(), state.size());
+    return state;
+}
+
+void CheckpointReader::read_rng(std::mt19937_64 &rng) {
+    std::ostringstream text;
+    const std::size_t count = read_count(sizeof(std::uint64_t));
+    for (std::size_t k = 0; k < count; ++k) {
+        if (k > 0) {
+            text << ' ';
+        }
+        text << read_u64();
+    }
+    std::istringstream in(text.str());
+    in >> rng;
+    if (!in) {
+        throw std::runtime_error("Checkpoint holds an invalid RNG state.");
+    }
+}
+
+void CheckpointReader::read_monitor(StopMonitor &monitor) {
+    const std::size_t sweeps = read_size();
+    const std::size_t last_improvement = read_size();
+    const double best_energy = read_f64();
+    const double elapsed = read_f64();
+    monitor.restore(sweeps, last_improvement, best_energy, elapsed);
+}
+
+void CheckpointReader::finish() const {
+    if (pos_ != buffer_.size()) {
+        throw std::runtime_error("Checkpoint has trailing data.");
+    }
+}
+
+} // namespace qanneal
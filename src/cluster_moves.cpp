@@ -0,0 +1,206 @@
+#include "qanneal/cluster_moves.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace qanneal {
+
+namespace {
+
+constexpr std::uint8_t kFree = 0;
+constexpr std::uint8_t kInCluster = 1;
+constexpr std::uint8_t kDone = 2;
+
+} // namespace
+
+ClusterWorkspace::ClusterWorkspace(CouplingGraph graph)
+    : graph_(std::move(graph)),
+      queue_(graph_.size(), 0),
+      mask_(graph_.size(), kFree) {
+    if (graph_.offsets.size() != graph_.size() + 1) {
+        throw std::invalid_argument("CouplingGraph offsets size mismatch.");
+    }
+}
+
+double ClusterWorkspace::cluster_flip_delta(const State &state,
+                                            std::size_t count,
+                                            double &field_delta) const {
+    // Couplings inside the cluster are unchanged by a joint flip, so only the
+    // fields and the boundary bonds contribute.
+    double coupling_delta = 0.0;
+    field_delta = 0.0;
+    for (std::size_t k = 0; k < count; ++k) {
+        const std::size_t i = queue_[k];
+        const double s = static_cast<double>(state[i]);
+        field_delta -= 2.0 * graph_.h[i] * s;
+        for (std::size_t e = graph_.offsets[i]; e < graph_.offsets[i + 1]; ++e) {
+            const std::size_t j = graph_.neighbors[e];
+            if (mask_[j] == kInCluster) {
+                continue;
+            }
+            coupling_delta -= 2.0 * graph_.weights[e] * s * static_cast<double>(state[j]);
+        }
+    }
+    return field_delta + coupling_delta;
+}
+
+void ClusterWorkspace::flip_cluster(State &state, std::size_t count) const {
+    for (std::size_t k = 0; k < count; ++k) {
+        const std::size_t i = queue_[k];
+        state[i] = static_cast<int8_t>(-state[i]);
+    }
+}
+
+std::size_t ClusterWorkspace::houdayer_move(State &a,
+                                            State &b,
+                                            double &energy_a,
+                                            double &energy_b,
+                                            std::mt19937_64 &rng) {
+    const std::size_t n = size();
+    if (a.size() != n || b.size() != n) {
+        throw std::invalid_argument("State size mismatch.");
+    }
+
+    std::size_t disagree = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        disagree += (a[i] != b[i]) ? 1 : 0;
+    }
+    if (disagree == 0) {
+        return 0;
+    }
+
+    std::uniform_int_distribution<std::size_t> pick(0, disagree - 1);
+    std::size_t target = pick(rng);
+    std::size_t seed = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        if (a[i] != b[i]) {
+            if (target == 0) {
+                seed = i;
+                break;
+            }
+            --target;
+        }
+    }
+
+    std::size_t head = 0;
+    std::size_t tail = 0;
+    queue_[tail++] = seed;
+    mask_[seed] = kInCluster;
+    while (head < tail) {
+        const std::size_t i = queue_[head++];
+        for (std::size_t e = graph_.offsets[i]; e < graph_.offsets[i + 1]; ++e) {
+            const std::size_t j = graph_.neighbors[e];
+            if (mask_[j] == kFree && a[j] != b[j]) {
+                mask_[j] = kInCluster;
+                queue_[tail++] = j;
+            }
+        }
+    }
+
+    double field_delta = 0.0;
+    energy_a += cluster_flip_delta(a, tail, field_delta);
+    energy_b += cluster_flip_delta(b, tail, field_delta);
+    flip_cluster(a, tail);
+    flip_cluster(b, tail);
+
+    for (std::size_t k = 0; k < tail; ++k) {
+        mask_[queue_[k]] = kFree;
+    }
+    return tail;
+}
+
+std::size_t ClusterWorkspace::grow_fk_cluster(const State &state,
+                                              std::size_t seed,
+                                              double beta,
+                                              std::mt19937_64 &rng) {
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    std::size_t head = 0;
+    std::size_t tail = 0;
+    queue_[tail++] = seed;
+    mask_[seed] = kInCluster;
+    while (head < tail) {
+        const std::size_t i = queue_[head++];
+        const double s = static_cast<double>(state[i]);
+        for (std::size_t e = graph_.offsets[i]; e < graph_.offsets[i + 1]; ++e) {
+            const std::size_t j = graph_.neighbors[e];
+            if (mask_[j] != kFree) {
+                continue;
+            }
+            // A satisfied bond (negative bond energy) is activated with
+            // probability 1 - exp(-2 beta |J_ij|).
+            const double bond = graph_.weights[e] * s * static_cast<double>(state[j]);
+            if (bond < 0.0 && uniform(rng) >= std::exp(2.0 * beta * bond)) {
+                mask_[j] = kInCluster;
+                queue_[tail++] = j;
+            }
+        }
+    }
+    return tail;
+}
+
+std::size_t ClusterWorkspace::wolff_update(State &state,
+                                           double beta,
+                                           double &energy,
+                                           std::mt19937_64 &rng) {
+    const std::size_t n = size();
+    if (state.size() != n) {
+        throw std::invalid_argument("State size mismatch.");
+    }
+
+    std::uniform_int_distribution<std::size_t> pick(0, n - 1);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    const std::size_t count = grow_fk_cluster(state, pick(rng), beta, rng);
+
+    double field_delta = 0.0;
+    const double delta = cluster_flip_delta(state, count, field_delta);
+    std::size_t flipped = 0;
+    if (field_delta <= 0.0 || uniform(rng) < std::exp(-beta * field_delta)) {
+        flip_cluster(state, count);
+        energy += delta;
+        flipped = count;
+    }
+
+    for (std::size_t k = 0; k < count; ++k) {
+        mask_[queue_[k]] = kFree;
+    }
+    return flipped;
+}
+
+std::size_t ClusterWorkspace::swendsen_wang_update(State &state,
+                                                   double beta,
+                                                   double &energy,
+                                                   std::mt19937_64 &rng) {
+    const std::size_t n = size();
+    if (state.size() != n) {
+        throw std::invalid_argument("State size mismatch.");
+    }
+
+    // Clusters are grown and flipped one at a time. Bonds to already processed
+    // clusters were decided when those clusters were grown, so flipping early
+    // does not bias the decomposition.
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    std::size_t flipped = 0;
+    for (std::size_t seed = 0; seed < n; ++seed) {
+        if (mask_[seed] != kFree) {
+            continue;
+        }
+        const std::size_t count = grow_fk_cluster(state, seed, beta, rng);
+        double field_delta = 0.0;
+        const double delta = cluster_flip_delta(state, count, field_delta);
+        const double p_flip = 1.0 / (1.0 + std::exp(beta * field_delta));
+        if (uniform(rng) < p_flip) {
+            flip_cluster(state, count);
+            energy += delta;
+            flipped += count;
+        }
+        for (std::size_t k = 0; k < count; ++k) {
+            mask_[queue_[k]] = kDone;
+        }
+    }
+
+    std::fill(mask_.begin(), mask_.end(), kFree);
+    return flipped;
+}
+
+} // namespace qanneal
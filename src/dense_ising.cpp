@@ -61,4 +61,23 @@ double DenseIsing::delta_energy(const int8_t *spins, std::size_t n, std::size_t
     return -2.0 * s * local;
 }
 
+CouplingGraph DenseIsing::coupling_graph() const {
+    CouplingGraph graph;
+    graph.h = h_;
+    graph.offsets.reserve(n_ + 1);
+    graph.offsets.push_back(0);
+    for (std::size_t i = 0; i < n_; ++i) {
+        for (std::size_t j = 0; j < n_; ++j) {
+            const double value = J_at(i, j);
+            if (j == i || value == 0.0) {
+                continue;
+            }
+            graph.neighbors.push_back(j);
+            graph.weights.push_back(value);
+        }
+        graph.offsets.push_back(graph.neighbors.size());
+    }
+    return graph;
+}
+
 }
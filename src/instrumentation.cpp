@@ -0,0 +1,51 @@
+#include "qanneal/instrumentation.hpp"
+
+#include <atomic>
+#include <memory>
+
+namespace qanneal::instrumentation {
+
+namespace {
+
+std::atomic<bool> hardware_enabled{false};
+
+// Opened lazily so threads that never sweep with the switch on never make
+// the system calls.
+std::unique_ptr<PerfCounters> &thread_perf() {
+    thread_local std::unique_ptr<PerfCounters> counters;
+    return counters;
+}
+
+} // namespace
+
+void set_hardware_counters(bool on) {
+    hardware_enabled.store(on, std::memory_order_relaxed);
+}
+
+bool hardware_counters() {
+    return hardware_enabled.load(std::memory_order_relaxed);
+}
+
+const PerfCounters *thread_perf_counters() {
+    if (!enabled || !hardware_counters()) {
+        return nullptr;
+    }
+    auto &counters = thread_perf();
+    if (!counters) {
+        counters = std::make_unique<PerfCounters>();
+    }
+    return counters->available() ? counters.get() : nullptr;
+}
+
+std::string hardware_counter_status() {
+    if (!enabled) {
+        return "unavailable: built without instrumentation";
+    }
+    if (!hardware_counters()) {
+        return "off";
+    }
+    thread_perf_counters();
+    return thread_perf()->status();
+}
+
+}
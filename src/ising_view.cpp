@@ -0,0 +1,73 @@
+#include "qanneal/ising_view.hpp"
+
+namespace qanneal {
+
+DenseIsingView::DenseIsingView(const double *h, const double *J, std::size_t n, double c)
+    : h_(h), J_(J), n_(n), c_(c) {
+    if (n_ == 0) {
+        throw std::invalid_argument("DenseIsingView size must be > 0.");
+    }
+    if (!h_ || !J_) {
+        throw std::invalid_argument("DenseIsingView needs h and J.");
+    }
+}
+
+double DenseIsingView::energy(const int8_t *spins, std::size_t n) const {
+    if (n != n_) {
+        throw std::invalid_argument("State size mismatch.");
+    }
+    validate_spins(spins, n_);
+    double E = c_;
+    for (std::size_t i = 0; i < n_; ++i) {
+        E += h_[i] * static_cast<double>(spins[i]);
+    }
+    for (std::size_t i = 0; i < n_; ++i) {
+        const double *row = J_ + i * n_;
+        for (std::size_t j = i + 1; j < n_; ++j) {
+            E += row[j] * static_cast<double>(spins[i]) * static_cast<double>(spins[j]);
+        }
+    }
+    return E;
+}
+
+double DenseIsingView::delta_energy(const int8_t *spins, std::size_t n, std::size_t flip) const {
+    if (n != n_) {
+        throw std::invalid_argument("State size mismatch.");
+    }
+    if (flip >= n_) {
+        throw std::invalid_argument("Flip index out of range.");
+    }
+    const double *row = J_ + flip * n_;
+    double local = h_[flip];
+    for (std::size_t j = 0; j < n_; ++j) {
+        if (j == flip) {
+            continue;
+        }
+        local += row[j] * static_cast<double>(spins[j]);
+    }
+    return -2.0 * static_cast<double>(spins[flip]) * local;
+}
+
+CouplingGraph DenseIsingView::coupling_graph() const {
+    CouplingGraph graph;
+    graph.h.assign(h_, h_ + n_);
+    graph.offsets.reserve(n_ + 1);
+    graph.offsets.push_back(0);
+    for (std::size_t i = 0; i < n_; ++i) {
+        for (std::size_t j = 0; j < n_; ++j) {
+            const double value = J_[i * n_ + j];
+            if (j == i || value == 0.0) {
+                continue;
+            }
+            graph.neighbors.push_back(j);
+            graph.weights.push_back(value);
+        }
+        graph.offsets.push_back(graph.neighbors.size());
+    }
+    return graph;
+}
+
+template class CsrIsingView<std::int32_t>;
+template class CsrIsingView<std::int64_t>;
+
+}
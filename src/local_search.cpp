@@ -0,0 +1,146 @@
+#include "qanneal/local_search.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+namespace qanneal {
+
+namespace {
+
+inline double flip_delta(const State &state, const std::vector<double> &fields, std::size_t idx) {
+    return -2.0 * static_cast<double>(state[idx]) * fields[idx];
+}
+
+} // namespace
+
+LocalSearch::LocalSearch(CouplingGraph graph)
+    : graph_(std::move(graph)) {
+    if (graph_.offsets.size() != graph_.size() + 1) {
+        throw std::invalid_argument("CouplingGraph offsets size mismatch.");
+    }
+}
+
+void LocalSearch::compute_fields(const State &state, std::vector<double> &fields) const {
+    const std::size_t n = size();
+    if (state.size() != n) {
+        throw std::invalid_argument("State size mismatch.");
+    }
+    fields.assign(n, 0.0);
+    for (std::size_t i = 0; i < n; ++i) {
+        double field = graph_.h[i];
+        for (std::size_t e = graph_.offsets[i]; e < graph_.offsets[i + 1]; ++e) {
+            field += graph_.weights[e] * static_cast<double>(state[graph_.neighbors[e]]);
+        }
+        fields[i] = field;
+    }
+}
+
+void LocalSearch::flip(State &state, std::vector<double> &fields, std::size_t idx) const {
+    const double change = -2.0 * static_cast<double>(state[idx]);
+    state[idx] = static_cast<int8_t>(-state[idx]);
+    for (std::size_t e = graph_.offsets[idx]; e < graph_.offsets[idx + 1]; ++e) {
+        fields[graph_.neighbors[e]] += graph_.weights[e] * change;
+    }
+}
+
+double LocalSearch::steepest_descent(State &state, double energy) const {
+    std::vector<double> fields;
+    compute_fields(state, fields);
+    const std::size_t n = size();
+    while (true) {
+        std::size_t best = n;
+        double best_delta = 0.0;
+        for (std::size_t i = 0; i < n; ++i) {
+            const double delta = flip_delta(state, fields, i);
+            if (delta < best_delta) {
+                best_delta = delta;
+                best = i;
+            }
+        }
+        if (best == n) {
+            break;
+        }
+        flip(state, fields, best);
+        energy += best_delta;
+    }
+    return energy;
+}
+
+double LocalSearch::tabu_search(State &state,
+                                double energy,
+                                std::size_t iterations,
+                                std::size_t tenure) const {
+    const std::size_t n = size();
+    if (n < 2 || iterations == 0) {
+        return steepest_descent(state, energy);
+    }
+    tenure = std::min(tenure, n - 1);
+
+    std::vector<double> fields;
+    compute_fields(state, fields);
+    std::vector<std::size_t> tabu_until(n, 0);
+
+    State best_state = state;
+    double best_energy = energy;
+
+    for (std::size_t it = 1; it <= iterations; ++it) {
+        std::size_t move = n;
+        double move_delta = std::numeric_limits<double>::infinity();
+        for (std::size_t i = 0; i < n; ++i) {
+            const double delta = flip_delta(state, fields, i);
+            // Aspiration: a tabu move is allowed if it reaches a new best.
+            const bool allowed = tabu_until[i] < it || energy + delta < best_energy;
+            if (allowed && delta < move_delta) {
+                move_delta = delta;
+                move = i;
+            }
+        }
+        if (move == n) {
+            continue;
+        }
+        flip(state, fields, move);
+        energy += move_delta;
+        tabu_until[move] = it + tenure;
+        if (energy < best_energy) {
+            best_energy = energy;
+            best_state.spins = state.spins;
+        }
+    }
+
+    state.spins = best_state.spins;
+    return steepest_descent(state, best_energy);
+}
+
+double LocalSearch::polish(State &state, double energy, const PolishOptions &options) const {
+    switch (options.mode) {
+    case PolishMode::None:
+        return energy;
+    case PolishMode::SteepestDescent:
+        return steepest_descent(state, energy);
+    case PolishMode::Tabu:
+        return tabu_search(state, energy, options.tabu_iterations, options.tabu_tenure);
+    }
+    return energy;
+}
+
+void LocalSearch::polish_all(std::vector<State> &states,
+                             std::vector<double> &energies,
+                             const PolishOptions &options) const {
+    if (states.size() != energies.size()) {
+        throw std::invalid_argument("states/energies length mismatch.");
+    }
+    for (const auto &state : states) {
+        if (state.size() != size()) {
+            throw std::invalid_argument("State size mismatch.");
+        }
+    }
+    const auto count = static_cast<std::ptrdiff_t>(states.size());
+#pragma omp parallel for schedule(dynamic) if (options.parallel)
+    for (std::ptrdiff_t idx = 0; idx < count; ++idx) {
+        const auto r = static_cast<std::size_t>(idx);
+        energies[r] = polish(states[r], energies[r], options);
+    }
+}
+
+} // namespace qanneal
@@ -0,0 +1,75 @@
+#include "qanneal/mpi/mpi_distributed_anneal.hpp"
+
+#include <cmath>
+#include <limits>
+#include <random>
+#include <stdexcept>
+
+namespace qanneal::mpi {
+
+DistributedAnnealSummary run_distributed_anneal(DistributedSparseIsing &hamiltonian,
+                                                const AnnealSchedule &schedule,
+                                                std::size_t sweeps_per_beta,
+                                                std::uint64_t seed) {
+    if (schedule.size() == 0) {
+        throw std::invalid_argument("Schedule must contain betas.");
+    }
+    if (sweeps_per_beta == 0) {
+        throw std::invalid_argument("sweeps_per_beta must be > 0.");
+    }
+
+    DistributedAnnealSummary summary;
+    MPI_Comm_rank(hamiltonian.comm(), &summary.rank);
+    MPI_Comm_size(hamiltonian.comm(), &summary.size);
+    std::mt19937_64 rng(seed != 0 ? seed + static_cast<std::uint64_t>(summary.rank) : std::random_device{}());
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+
+    const std::size_t m = hamiltonian.num_owned();
+    std::vector<int8_t> spins(hamiltonian.local_size(), 1);
+    for (std::size_t i = 0; i < m; ++i) {
+        spins[i] = (rng() & 1U) ? int8_t{1} : int8_t{-1};
+    }
+    hamiltonian.exchange_all(spins.data());
+    double partial = hamiltonian.partial_energy(spins.data());
+
+    summary.best_energy = std::numeric_limits<double>::infinity();
+    summary.energy_trace.reserve(schedule.size());
+    auto update = [&](std::size_t i, double beta) {
+        const double delta = hamiltonian.delta_energy(spins.data(), i);
+        if (delta <= 0.0 || uniform(rng) < std::exp(-beta * delta)) {
+            spins[i] = static_cast<int8_t>(-spins[i]);
+            partial += delta;
+        }
+    };
+
+    for (std::size_t step = 0; step < schedule.size(); ++step) {
+        const double beta = schedule.betas[step];
+        const std::size_t sweeps = schedule.sweeps_at(step, sweeps_per_beta);
+        for (std::size_t sweep = 0; sweep < sweeps; ++sweep) {
+            for (std::size_t color = 0; color < hamiltonian.num_colors(); ++color) {
+                for (std::size_t i : hamiltonian.interior(color)) {
+                    update(i, beta);
+                }
+                hamiltonian.wait_halo();
+                for (std::size_t i : hamiltonian.boundary(color)) {
+                    update(i, beta);
+                }
+                hamiltonian.post_halo(spins.data(), color);
+            }
+        }
+        summary.sweeps += sweeps;
+
+        double energy = partial;
+        MPI_Allreduce(MPI_IN_PLACE, &energy, 1, MPI_DOUBLE, MPI_SUM, hamiltonian.comm());
+        summary.energy_trace.push_back(energy);
+        if (energy < summary.best_energy) {
+            summary.best_energy = energy;
+            summary.best_local_spins.assign(spins.begin(), spins.begin() + static_cast<std::ptrdiff_t>(m));
+        }
+    }
+    hamiltonian.wait_halo();
+
+    return summary;
+}
+
+} // namespace qanneal::mpi
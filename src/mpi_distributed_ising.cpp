@@ -0,0 +1,576 @@
+#include "qanneal/mpi/mpi_distributed_ising.hpp"
+
+#include <algorithm>
+#include <exception>
+#include <numeric>
+#include <stdexcept>
+
+namespace qanneal::mpi {
+
+namespace {
+
+constexpr int kSetupTag = 4301;
+constexpr int kColorTag = 4302;
+constexpr int kHaloTag = 4303;
+
+std::uint64_t priority(std::size_t global) {
+    std::uint64_t z = static_cast<std::uint64_t>(global) + 0x9e3779b97f4a7c15ULL;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+} // namespace
+
+SpinPartition partition_spins(const SparseIsing &hamiltonian, std::size_t parts) {
+    const std::size_t n = hamiltonian.size();
+    if (parts == 0 || parts > n) {
+        throw std::invalid_argument("partition_spins needs between 1 and size() parts.");
+    }
+    const CouplingGraph graph = hamiltonian.coupling_graph();
+    auto degree = [&](std::size_t v) { return graph.offsets[v + 1] - graph.offsets[v]; };
+
+    // Cuthill-McKee: breadth-first from a minimum-degree spin of each
+    // component, visiting neighbors by increasing degree.
+    std::vector<std::size_t> by_degree(n);
+    std::iota(by_degree.begin(), by_degree.end(), 0);
+    std::stable_sort(by_degree.begin(), by_degree.end(),
+                     [&](std::size_t a, std::size_t b) { return degree(a) < degree(b); });
+    SpinPartition partition;
+    partition.order.reserve(n);
+    std::vector<char> visited(n, 0);
+    std::vector<std::size_t> next;
+    for (std::size_t start : by_degree) {
+        if (visited[start]) {
+            continue;
+        }
+        visited[start] = 1;
+        std::size_t head = partition.order.size();
+        partition.order.push_back(start);
+        while (head < partition.order.size()) {
+            const std::size_t v = partition.order[head++];
+            next.clear();
+            for (std::size_t k = graph.offsets[v]; k < graph.offsets[v + 1]; ++k) {
+                const std::size_t u = graph.neighbors[k];
+                if (!visited[u]) {
+                    visited[u] = 1;
+                    next.push_back(u);
+                }
+            }
+            std::stable_sort(next.begin(), next.end(),
+                             [&](std::size_t a, std::size_t b) { return degree(a) < degree(b); });
+            partition.order.insert(partition.order.end(), next.begin(), next.end());
+        }
+    }
+
+    partition.offsets.resize(parts + 1);
+    for (std::size_t p = 0; p <= parts; ++p) {
+        partition.offsets[p] = p * n / parts;
+    }
+    return partition;
+}
+
+DistributedSparseIsing::DistributedSparseIsing(const SparseIsing &global, MPI_Comm comm)
+    : comm_(comm) {
+    MPI_Comm_rank(comm_, &rank_);
+    MPI_Comm_size(comm_, &size_);
+    const SpinPartition partition = partition_spins(global, static_cast<std::size_t>(size_));
+    const std::size_t n = global.size();
+    std::vector<std::size_t> position(n);
+    for (std::size_t k = 0; k < n; ++k) {
+        position[partition.order[k]] = k;
+    }
+
+    offsets_ = partition.offsets;
+    const std::size_t first = offsets_[rank_];
+    const std::size_t end = offsets_[rank_ + 1];
+    original_ids_.assign(partition.order.begin() + static_cast<std::ptrdiff_t>(first),
+                         partition.order.begin() + static_cast<std::ptrdiff_t>(end));
+    h_.reserve(end - first);
+    for (std::size_t id : original_ids_) {
+        h_.push_back(global.h()[id]);
+    }
+    c_ = rank_ == 0 ? global.constant() : 0.0;
+
+    std::vector<SparseEdge> edges;
+    for (const auto &edge : global.edges()) {
+        const std::size_t i = position[edge.i];
+        const std::size_t j = position[edge.j];
+        if ((i >= first && i < end) || (j >= first && j < end)) {
+            edges.push_back({i, j, edge.value});
+        }
+    }
+    build(edges);
+}
+
+DistributedSparseIsing::DistributedSparseIsing(const SparseIsing *global, MPI_Comm comm, int root)
+    : comm_(comm) {
+    MPI_Comm_rank(comm_, &rank_);
+    MPI_Comm_size(comm_, &size_);
+    const std::size_t parts = static_cast<std::size_t>(size_);
+
+    // The root lays out every rank's piece back to back: fields and labels
+    // in partition order, then the couplings with an owned end (those
+    // between two ranks go to both).
+    std::vector<std::uint64_t> offsets(parts + 1, 0);
+    double c = 0.0;
+    std::vector<double> all_h;
+    std::vector<std::uint64_t> all_ids;
+    std::vector<int> edge_counts(parts, 0);
+    std::vector<std::uint64_t> all_ends;
+    std::vector<double> all_values;
+    std::exception_ptr error;
+    if (rank_ == root) {
+        try {
+            if (!global) {
+                throw std::invalid_argument("DistributedSparseIsing needs the Hamiltonian on the root rank.");
+            }
+            const SpinPartition partition = partition_spins(*global, parts);
+            const std::size_t n = global->size();
+            std::vector<std::size_t> position(n);
+            for (std::size_t k = 0; k < n; ++k) {
+                position[partition.order[k]] = k;
+            }
+            std::copy(partition.offsets.begin(), partition.offsets.end(), offsets.begin());
+            all_ids.assign(partition.order.begin(), partition.order.end());
+            all_h.reserve(n);
+            for (std::size_t id : partition.order) {
+                all_h.push_back(global->h()[id]);
+            }
+            c = global->constant();
+
+            auto owner = [&](std::size_t g) {
+                return static_cast<std::size_t>(std::upper_bound(partition.offsets.begin(), partition.offsets.end(), g) -
+                                                partition.offsets.begin()) - 1;
+            };
+            std::vector<std::vector<SparseEdge>> pieces(parts);
+            for (const auto &edge : global->edges()) {
+                const SparseEdge moved{position[edge.i], position[edge.j], edge.value};
+                const std::size_t pi = owner(moved.i);
+                const std::size_t pj = owner(moved.j);
+                pieces[pi].push_back(moved);
+                if (pj != pi) {
+                    pieces[pj].push_back(moved);
+                }
+            }
+            for (std::size_t p = 0; p < parts; ++p) {
+                edge_counts[p] = static_cast<int>(pieces[p].size());
+                for (const auto &edge : pieces[p]) {
+                    all_ends.push_back(edge.i);
+                    all_ends.push_back(edge.j);
+                    all_values.push_back(edge.value);
+                }
+            }
+        } catch (...) {
+            error = std::current_exception();
+        }
+    }
+    int ok = error ? 0 : 1;
+    MPI_Bcast(&ok, 1, MPI_INT, root, comm_);
+    if (error) {
+        std::rethrow_exception(error);
+    }
+    if (!ok) {
+        throw std::runtime_error("DistributedSparseIsing partitioning failed on the root rank.");
+    }
+    MPI_Bcast(offsets.data(), size_ + 1, MPI_UINT64_T, root, comm_);
+    MPI_Bcast(&c, 1, MPI_DOUBLE, root, comm_);
+    offsets_.assign(offsets.begin(), offsets.end());
+
+    std::vector<int> counts(parts);
+    std::vector<int> displs(parts);
+    for (std::size_t p = 0; p < parts; ++p) {
+        counts[p] = static_cast<int>(offsets_[p + 1] - offsets_[p]);
+        displs[p] = static_cast<int>(offsets_[p]);
+    }
+    const int owned = counts[static_cast<std::size_t>(rank_)];
+    h_.resize(static_cast<std::size_t>(owned));
+    std::vector<std::uint64_t> ids(h_.size());
+    MPI_Scatterv(all_h.data(), counts.data(), displs.data(), MPI_DOUBLE, h_.data(), owned, MPI_DOUBLE,
+                 root, comm_);
+    MPI_Scatterv(all_ids.data(), counts.data(), displs.data(), MPI_UINT64_T, ids.data(), owned,
+                 MPI_UINT64_T, root, comm_);
+    original_ids_.assign(ids.begin(), ids.end());
+
+    int edge_count = 0;
+    MPI_Scatter(edge_counts.data(), 1, MPI_INT, &edge_count, 1, MPI_INT, root, comm_);
+    for (std::size_t p = 0; p < parts; ++p) {
+        counts[p] = edge_counts[p];
+        displs[p] = p == 0 ? 0 : displs[p - 1] + counts[p - 1];
+    }
+    std::vector<double> values(static_cast<std::size_t>(edge_count));
+    MPI_Scatterv(all_values.data(), counts.data(), displs.data(), MPI_DOUBLE, values.data(), edge_count,
+                 MPI_DOUBLE, root, comm_);
+    for (std::size_t p = 0; p < parts; ++p) {
+        counts[p] *= 2;
+        displs[p] *= 2;
+    }
+    std::vector<std::uint64_t> ends(2 * values.size());
+    MPI_Scatterv(all_ends.data(), counts.data(), displs.data(), MPI_UINT64_T, ends.data(), 2 * edge_count,
+                 MPI_UINT64_T, root, comm_);
+
+    std::vector<SparseEdge> edges(values.size());
+    for (std::size_t k = 0; k < edges.size(); ++k) {
+        edges[k] = {static_cast<std::size_t>(ends[2 * k]), static_cast<std::size_t>(ends[2 * k + 1]), values[k]};
+    }
+    c_ = rank_ == 0 ? c : 0.0;
+    build(edges);
+}
+
+DistributedSparseIsing::DistributedSparseIsing(std::vector<std::size_t> offsets,
+                                               std::vector<double> h,
+                                               const std::vector<SparseEdge> &edges,
+                                               MPI_Comm comm,
+                                               double c,
+                                               std::vector<std::size_t> original_ids)
+    : comm_(comm), offsets_(std::move(offsets)), original_ids_(std::move(original_ids)), h_(std::move(h)) {
+    MPI_Comm_rank(comm_, &rank_);
+    MPI_Comm_size(comm_, &size_);
+    if (offsets_.size() != static_cast<std::size_t>(size_) + 1 || offsets_.front() != 0 ||
+        !std::is_sorted(offsets_.begin(), offsets_.end())) {
+        throw std::invalid_argument("DistributedSparseIsing offsets must hold size() + 1 increasing entries from 0.");
+    }
+    if (h_.size() != offsets_[rank_ + 1] - offsets_[rank_]) {
+        throw std::invalid_argument("DistributedSparseIsing h size does not match the owned range.");
+    }
+    if (original_ids_.empty()) {
+        original_ids_.resize(h_.size());
+        std::iota(original_ids_.begin(), original_ids_.end(), offsets_[rank_]);
+    } else if (original_ids_.size() != h_.size()) {
+        throw std::invalid_argument("DistributedSparseIsing original_ids size does not match h.");
+    }
+    c_ = rank_ == 0 ? c : 0.0;
+    build(edges);
+}
+
+std::size_t DistributedSparseIsing::global_id(std::size_t local) const {
+    const std::size_t m = num_owned();
+    return local < m ? offsets_[rank_] + local : ghost_global_[local - m];
+}
+
+void DistributedSparseIsing::build(const std::vector<SparseEdge> &edges) {
+    const std::size_t m = num_owned();
+    const std::size_t first = offsets_[rank_];
+    const std::size_t n = offsets_.back();
+    auto owned = [&](std::size_t g) { return g >= first && g < first + m; };
+
+    for (const auto &edge : edges) {
+        if (edge.i >= n || edge.j >= n) {
+            throw std::invalid_argument("DistributedSparseIsing edge index out of range.");
+        }
+        if (edge.i == edge.j) {
+            throw std::invalid_argument("DistributedSparseIsing self-edge not allowed.");
+        }
+        if (!owned(edge.i) && !owned(edge.j)) {
+            throw std::invalid_argument("DistributedSparseIsing edge has no owned end.");
+        }
+        if (!owned(edge.i)) {
+            ghost_global_.push_back(edge.i);
+        }
+        if (!owned(edge.j)) {
+            ghost_global_.push_back(edge.j);
+        }
+    }
+    // Sorted by global index, ghosts are grouped by owner.
+    std::sort(ghost_global_.begin(), ghost_global_.end());
+    ghost_global_.erase(std::unique(ghost_global_.begin(), ghost_global_.end()), ghost_global_.end());
+    auto local_of = [&](std::size_t g) {
+        if (owned(g)) {
+            return g - first;
+        }
+        return m + static_cast<std::size_t>(std::lower_bound(ghost_global_.begin(), ghost_global_.end(), g) -
+                                            ghost_global_.begin());
+    };
+
+    row_.assign(m + 1, 0);
+    for (const auto &edge : edges) {
+        if (owned(edge.i)) {
+            ++row_[edge.i - first + 1];
+        }
+        if (owned(edge.j)) {
+            ++row_[edge.j - first + 1];
+        }
+    }
+    std::partial_sum(row_.begin(), row_.end(), row_.begin());
+    col_.resize(row_.back());
+    weight_.resize(row_.back());
+    std::vector<std::size_t> fill(row_.begin(), row_.end() - 1);
+    for (const auto &edge : edges) {
+        if (owned(edge.i)) {
+            const std::size_t k = fill[edge.i - first]++;
+            col_[k] = local_of(edge.j);
+            weight_[k] = edge.value;
+        }
+        if (owned(edge.j)) {
+            const std::size_t k = fill[edge.j - first]++;
+            col_[k] = local_of(edge.i);
+            weight_[k] = edge.value;
+        }
+    }
+
+    // Tell each owner which of its spins this rank keeps ghosts of; what
+    // comes back in the other direction are the spins to send.
+    std::vector<int> want(size_, 0);
+    std::vector<int> asked(size_, 0);
+    std::vector<int> owner(ghost_global_.size());
+    for (std::size_t g = 0; g < ghost_global_.size(); ++g) {
+        owner[g] = static_cast<int>(std::upper_bound(offsets_.begin(), offsets_.end(), ghost_global_[g]) -
+                                    offsets_.begin()) - 1;
+        ++want[owner[g]];
+    }
+    MPI_Alltoall(want.data(), 1, MPI_INT, asked.data(), 1, MPI_INT, comm_);
+
+    std::vector<std::vector<std::uint64_t>> incoming(size_);
+    std::vector<MPI_Request> requests;
+    std::vector<std::uint64_t> outgoing(ghost_global_.begin(), ghost_global_.end());
+    std::size_t at = 0;
+    for (int q = 0; q < size_; ++q) {
+        if (asked[q] > 0) {
+            incoming[q].resize(static_cast<std::size_t>(asked[q]));
+            requests.emplace_back();
+            MPI_Irecv(incoming[q].data(), asked[q], MPI_UINT64_T, q, kSetupTag, comm_, &requests.back());
+        }
+        if (want[q] > 0) {
+            requests.emplace_back();
+            MPI_Isend(outgoing.data() + at, want[q], MPI_UINT64_T, q, kSetupTag, comm_, &requests.back());
+            at += static_cast<std::size_t>(want[q]);
+        }
+    }
+    MPI_Waitall(static_cast<int>(requests.size()), requests.data(), MPI_STATUSES_IGNORE);
+
+    // Uncolored lists first (a single "color"), split after coloring.
+    at = 0;
+    for (int q = 0; q < size_; ++q) {
+        if (asked[q] == 0 && want[q] == 0) {
+            continue;
+        }
+        Neighbor neighbor;
+        neighbor.rank = q;
+        neighbor.send.resize(1);
+        neighbor.recv.resize(1);
+        for (std::uint64_t g : incoming[q]) {
+            if (!owned(static_cast<std::size_t>(g))) {
+                throw std::invalid_argument("DistributedSparseIsing ranks disagree on the partition.");
+            }
+            neighbor.send[0].push_back(static_cast<std::size_t>(g) - first);
+        }
+        for (int k = 0; k < want[q]; ++k, ++at) {
+            neighbor.recv[0].push_back(m + at);
+        }
+        neighbors_.push_back(std::move(neighbor));
+    }
+
+    color_spins();
+}
+
+void DistributedSparseIsing::color_spins() {
+    // Jones-Plassmann: in each round every uncolored spin whose uncolored
+    // neighbors all have lower priority takes the smallest color free among
+    // its neighbors. Such spins are never adjacent, on any rank.
+    const std::size_t m = num_owned();
+    color_.assign(local_size(), -1);
+    std::vector<std::uint64_t> prio(local_size());
+    for (std::size_t v = 0; v < local_size(); ++v) {
+        prio[v] = priority(global_id(v));
+    }
+    auto higher = [&](std::size_t a, std::size_t b) {
+        return prio[a] != prio[b] ? prio[a] > prio[b] : global_id(a) > global_id(b);
+    };
+
+    std::vector<std::size_t> chosen;
+    std::vector<char> used;
+    std::vector<std::vector<int>> send_buf(neighbors_.size());
+    std::vector<std::vector<int>> recv_buf(neighbors_.size());
+    std::vector<MPI_Request> requests;
+    while (true) {
+        chosen.clear();
+        for (std::size_t i = 0; i < m; ++i) {
+            if (color_[i] >= 0) {
+                continue;
+            }
+            bool top = true;
+            for (std::size_t k = row_[i]; k < row_[i + 1] && top; ++k) {
+                const std::size_t j = col_[k];
+                top = color_[j] >= 0 || higher(i, j);
+            }
+            if (top) {
+                chosen.push_back(i);
+            }
+        }
+        for (std::size_t i : chosen) {
+            used.assign(row_[i + 1] - row_[i] + 1, 0);
+            for (std::size_t k = row_[i]; k < row_[i + 1]; ++k) {
+                const int c = color_[col_[k]];
+                if (c >= 0 && static_cast<std::size_t>(c) < used.size()) {
+                    used[static_cast<std::size_t>(c)] = 1;
+                }
+            }
+            color_[i] = static_cast<int>(std::find(used.begin(), used.end(), 0) - used.begin());
+        }
+
+        requests.clear();
+        for (std::size_t q = 0; q < neighbors_.size(); ++q) {
+            const auto &neighbor = neighbors_[q];
+            send_buf[q].clear();
+            for (std::size_t i : neighbor.send[0]) {
+                send_buf[q].push_back(color_[i]);
+            }
+            recv_buf[q].resize(neighbor.recv[0].size());
+            if (!recv_buf[q].empty()) {
+                requests.emplace_back();
+                MPI_Irecv(recv_buf[q].data(), static_cast<int>(recv_buf[q].size()), MPI_INT,
+                          neighbor.rank, kColorTag, comm_, &requests.back());
+            }
+            if (!send_buf[q].empty()) {
+                requests.emplace_back();
+                MPI_Isend(send_buf[q].data(), static_cast<int>(send_buf[q].size()), MPI_INT,
+                          neighbor.rank, kColorTag, comm_, &requests.back());
+            }
+        }
+        MPI_Waitall(static_cast<int>(requests.size()), requests.data(), MPI_STATUSES_IGNORE);
+        for (std::size_t q = 0; q < neighbors_.size(); ++q) {
+            for (std::size_t k = 0; k < recv_buf[q].size(); ++k) {
+                color_[neighbors_[q].recv[0][k]] = recv_buf[q][k];
+            }
+        }
+
+        long long uncolored = static_cast<long long>(std::count(color_.begin(), color_.begin() + static_cast<std::ptrdiff_t>(m), -1));
+        MPI_Allreduce(MPI_IN_PLACE, &uncolored, 1, MPI_LONG_LONG, MPI_SUM, comm_);
+        if (uncolored == 0) {
+            break;
+        }
+    }
+
+    int local_colors = 0;
+    for (std::size_t i = 0; i < m; ++i) {
+        local_colors = std::max(local_colors, color_[i] + 1);
+    }
+    MPI_Allreduce(&local_colors, &colors_, 1, MPI_INT, MPI_MAX, comm_);
+    colors_ = std::max(colors_, 1);
+
+    const std::size_t C = num_colors();
+    interior_.assign(C, {});
+    boundary_.assign(C, {});
+    for (std::size_t i = 0; i < m; ++i) {
+        bool ghost = false;
+        for (std::size_t k = row_[i]; k < row_[i + 1] && !ghost; ++k) {
+            ghost = col_[k] >= m;
+        }
+        (ghost ? boundary_ : interior_)[static_cast<std::size_t>(color_[i])].push_back(i);
+    }
+    for (auto &neighbor : neighbors_) {
+        std::vector<std::vector<std::size_t>> send(C);
+        std::vector<std::vector<std::size_t>> recv(C);
+        for (std::size_t i : neighbor.send[0]) {
+            send[static_cast<std::size_t>(color_[i])].push_back(i);
+        }
+        for (std::size_t g : neighbor.recv[0]) {
+            recv[static_cast<std::size_t>(color_[g])].push_back(g);
+        }
+        neighbor.send = std::move(send);
+        neighbor.recv = std::move(recv);
+    }
+    send_buffers_.resize(neighbors_.size());
+    recv_buffers_.resize(neighbors_.size());
+}
+
+double DistributedSparseIsing::partial_energy(const int8_t *local_spins) const {
+    // Each coupling is counted by the rank owning its lower global end.
+    double E = c_;
+    for (std::size_t i = 0; i < num_owned(); ++i) {
+        const double s = static_cast<double>(local_spins[i]);
+        E += h_[i] * s;
+        const std::size_t gi = offsets_[rank_] + i;
+        for (std::size_t k = row_[i]; k < row_[i + 1]; ++k) {
+            if (global_id(col_[k]) > gi) {
+                E += weight_[k] * s * static_cast<double>(local_spins[col_[k]]);
+            }
+        }
+    }
+    return E;
+}
+
+double DistributedSparseIsing::energy(const int8_t *local_spins) const {
+    double E = partial_energy(local_spins);
+    MPI_Allreduce(MPI_IN_PLACE, &E, 1, MPI_DOUBLE, MPI_SUM, comm_);
+    return E;
+}
+
+void DistributedSparseIsing::post_halo(int8_t *local_spins, std::size_t color) {
+    if (pending_spins_) {
+        throw std::logic_error("DistributedSparseIsing halo exchange already in flight.");
+    }
+    pending_spins_ = local_spins;
+    pending_color_ = color;
+    requests_.clear();
+    for (std::size_t q = 0; q < neighbors_.size(); ++q) {
+        const auto &neighbor = neighbors_[q];
+        const auto &recv = neighbor.recv[color];
+        const auto &send = neighbor.send[color];
+        recv_buffers_[q].resize(recv.size());
+        if (!recv.empty()) {
+            requests_.emplace_back();
+            MPI_Irecv(recv_buffers_[q].data(), static_cast<int>(recv.size()), MPI_SIGNED_CHAR,
+                      neighbor.rank, kHaloTag, comm_, &requests_.back());
+        }
+        send_buffers_[q].resize(send.size());
+        for (std::size_t k = 0; k < send.size(); ++k) {
+            send_buffers_[q][k] = local_spins[send[k]];
+        }
+        if (!send.empty()) {
+            requests_.emplace_back();
+            MPI_Isend(send_buffers_[q].data(), static_cast<int>(send.size()), MPI_SIGNED_CHAR,
+                      neighbor.rank, kHaloTag, comm_, &requests_.back());
+        }
+    }
+}
+
+void DistributedSparseIsing::wait_halo() {
+    if (!pending_spins_) {
+        return;
+    }
+    MPI_Waitall(static_cast<int>(requests_.size()), requests_.data(), MPI_STATUSES_IGNORE);
+    for (std::size_t q = 0; q < neighbors_.size(); ++q) {
+        const auto &recv = neighbors_[q].recv[pending_color_];
+        for (std::size_t k = 0; k < recv.size(); ++k) {
+            pending_spins_[recv[k]] = recv_buffers_[q][k];
+        }
+    }
+    pending_spins_ = nullptr;
+}
+
+void DistributedSparseIsing::exchange_all(int8_t *local_spins) {
+    for (std::size_t color = 0; color < num_colors(); ++color) {
+        post_halo(local_spins, color);
+        wait_halo();
+    }
+}
+
+State DistributedSparseIsing::gather_state(const int8_t *local_spins, int root) const {
+    const int count = static_cast<int>(num_owned());
+    std::vector<int> counts(rank_ == root ? size_ : 0);
+    MPI_Gather(&count, 1, MPI_INT, counts.data(), 1, MPI_INT, root, comm_);
+    std::vector<int> displs(counts.size(), 0);
+    for (std::size_t p = 1; p < counts.size(); ++p) {
+        displs[p] = displs[p - 1] + counts[p - 1];
+    }
+
+    const std::size_t n = global_size();
+    std::vector<std::uint64_t> ids(original_ids_.begin(), original_ids_.end());
+    std::vector<std::uint64_t> all_ids(rank_ == root ? n : 0);
+    std::vector<int8_t> all_spins(rank_ == root ? n : 0);
+    MPI_Gatherv(ids.data(), count, MPI_UINT64_T, all_ids.data(), counts.data(), displs.data(),
+                MPI_UINT64_T, root, comm_);
+    MPI_Gatherv(local_spins, count, MPI_SIGNED_CHAR, all_spins.data(), counts.data(), displs.data(),
+                MPI_SIGNED_CHAR, root, comm_);
+    if (rank_ != root) {
+        return State();
+    }
+    State state(n);
+    for (std::size_t k = 0; k < n; ++k) {
+        state.spins[static_cast<std::size_t>(all_ids[k])] = all_spins[k];
+    }
+    return state;
+}
+
+} // namespace qanneal::mpi
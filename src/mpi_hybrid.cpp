@@ -0,0 +1,186 @@
+#include "qanneal/mpi/mpi_hybrid.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <exception>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "qanneal/mpi/mpi_context.hpp"
+
+namespace qanneal::mpi {
+
+namespace {
+
+// Cores this process may run on, in increasing order.
+std::vector<int> allowed_cores() {
+    std::vector<int> cores;
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (int c = 0; c < CPU_SETSIZE; ++c) {
+            if (CPU_ISSET(c, &set)) {
+                cores.push_back(c);
+            }
+        }
+    }
+#endif
+    return cores;
+}
+
+// The OpenMP runtime's thread count when OMP_NUM_THREADS asks for one;
+// without it the runtime would report the whole node, not this rank's share.
+std::size_t omp_num_threads() {
+#ifdef _OPENMP
+    if (std::getenv("OMP_NUM_THREADS")) {
+        return static_cast<std::size_t>(omp_get_max_threads());
+    }
+#endif
+    return 0;
+}
+
+void pin_to(int core) {
+#if defined(__linux__)
+    if (core < 0) {
+        return;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(core, &set);
+    // Best effort: an unpinned worker is slower, not wrong.
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+    (void)core;
+#endif
+}
+
+} // namespace
+
+HybridLayout discover_layout(const HybridOptions &options, MPI_Comm comm) {
+    HybridLayout layout;
+    MPI_Comm_rank(comm, &layout.rank);
+    MPI_Comm_size(comm, &layout.size);
+    MPI_Comm node;
+    MPI_Comm_split_type(comm, MPI_COMM_TYPE_SHARED, layout.rank, MPI_INFO_NULL, &node);
+    MPI_Comm_rank(node, &layout.node_rank);
+    MPI_Comm_size(node, &layout.node_size);
+    MPI_Comm_free(&node);
+
+    std::vector<int> share = allowed_cores();
+    const std::size_t hardware = std::thread::hardware_concurrency();
+    if (!share.empty() && share.size() >= hardware && layout.node_size > 1) {
+        // Not bound by the launcher: take this rank's slice of the node.
+        const std::size_t per = std::max<std::size_t>(1, share.size() / static_cast<std::size_t>(layout.node_size));
+        const std::size_t first = (static_cast<std::size_t>(layout.node_rank) * per) % share.size();
+        const std::size_t last = std::min(share.size(), first + per);
+        share = std::vector<int>(share.begin() + static_cast<std::ptrdiff_t>(first),
+                                 share.begin() + static_cast<std::ptrdiff_t>(last));
+    }
+
+    layout.threads = options.threads;
+    if (layout.threads == 0) {
+        layout.threads = omp_num_threads();
+    }
+    if (layout.threads == 0) {
+        layout.threads = share.empty() ? std::max<std::size_t>(1, hardware) : share.size();
+    }
+    layout.cores.assign(layout.threads, -1);
+    if (options.pin_threads && !share.empty()) {
+        for (std::size_t t = 0; t < layout.threads; ++t) {
+            layout.cores[t] = share[t % share.size()];
+        }
+    }
+    return layout;
+}
+
+MPIHybridSummary run_hybrid_replica_anneal(const Hamiltonian &hamiltonian,
+                                           AnnealSchedule schedule,
+                                           std::size_t sweeps_per_beta,
+                                           std::size_t replicas_per_rank,
+                                           std::uint64_t seed,
+                                           MPI_Comm comm,
+                                           HybridOptions options) {
+    if (replicas_per_rank == 0) {
+        throw std::invalid_argument("replicas_per_rank must be > 0.");
+    }
+    require_funneled("run_hybrid_replica_anneal");
+    MPIHybridSummary summary;
+    summary.layout = discover_layout(options, comm);
+    summary.rank = summary.layout.rank;
+    summary.size = summary.layout.size;
+
+    const std::size_t workers = std::min(summary.layout.threads, replicas_per_rank);
+    // Every worker in the job gets its own seed.
+    std::uint64_t local_workers = workers;
+    std::uint64_t first_worker = 0;
+    MPI_Exscan(&local_workers, &first_worker, 1, MPI_UINT64_T, MPI_SUM, comm);
+    if (summary.rank == 0) {
+        first_worker = 0;
+    }
+
+    std::vector<MultiAnnealResult> results(workers);
+    std::vector<std::exception_ptr> errors(workers);
+    std::vector<std::thread> threads;
+    threads.reserve(workers);
+    for (std::size_t t = 0; t < workers; ++t) {
+        const std::size_t replicas = replicas_per_rank / workers + (t < replicas_per_rank % workers ? 1 : 0);
+        threads.emplace_back([&, t, replicas] {
+            try {
+                pin_to(summary.layout.cores[t]);
+                // Built on the pinned thread, so the replica states are
+                // first touched, and placed, on its NUMA node.
+                ReplicaAnnealer annealer(hamiltonian, schedule, replicas);
+                if (seed != 0) {
+                    annealer.set_seed(seed + first_worker + t);
+                }
+                results[t] = annealer.run(sweeps_per_beta);
+            } catch (...) {
+                errors[t] = std::current_exception();
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    // Agree on failure before the reduction below, which a failed rank
+    // would never join: the lowest failed rank, or size when none failed.
+    std::exception_ptr error;
+    for (const auto &e : errors) {
+        if (e && !error) {
+            error = e;
+        }
+    }
+    int failed = error ? summary.rank : summary.size;
+    MPI_Allreduce(MPI_IN_PLACE, &failed, 1, MPI_INT, MPI_MIN, comm);
+    if (error) {
+        std::rethrow_exception(error);
+    }
+    if (failed < summary.size) {
+        throw std::runtime_error("Hybrid replica annealing failed on rank " + std::to_string(failed) + ".");
+    }
+
+    std::size_t best = 0;
+    for (std::size_t t = 1; t < workers; ++t) {
+        if (results[t].global_best_energy < results[best].global_best_energy) {
+            best = t;
+        }
+    }
+    summary.local_best_energy = results[best].global_best_energy;
+    summary.local_best_state = results[best].global_best_state;
+    reduce_global_best(summary, hamiltonian.size(), comm);
+
+    return summary;
+}
+
+} // namespace qanneal::mpi
@@ -0,0 +1,406 @@
+#include "qanneal/mpi/mpi_parallel_tempering.hpp"
+
+#include <cmath>
+#include <limits>
+#include <random>
+#include <stdexcept>
+
+#include "qanneal/backend.hpp"
+
+namespace qanneal::mpi {
+
+namespace {
+
+// Message kinds; the tag is kind * T + the sender's temperature before the
+// round, so every message a rank can be waiting for is unambiguous.
+enum Phase : int {
+    kEnergy = 0,   // energy to the swap partner
+    kHolder = 1,   // new holder of my old temperature, to the outer neighbor
+    kForward = 2,  // that neighbor's reply, forwarded to a partner I swapped with
+};
+
+enum class Role { None, Lower, Upper };
+
+struct Replica {
+    State state;
+    double energy = 0.0;
+    std::size_t temperature = 0;
+    int down = -1;  // rank holding temperature - 1
+    int up = -1;    // rank holding temperature + 1
+
+    // The swap round in flight.
+    Role role = Role::None;
+    std::size_t old_temperature = 0;
+    int partner = -1;
+    int outer = -1;
+    std::size_t outer_temperature = 0;
+    bool accepted = false;
+    double sent_energy = 0.0;
+    double partner_energy = 0.0;
+    int sent_holder = -1;
+    int outer_holder = -1;
+    int sent_forward = -1;
+    int forwarded = -1;
+};
+
+// Same value on both sides of the pair (round, lower), from the shared seed.
+double swap_uniform(std::uint64_t seed, std::uint64_t round, std::uint64_t lower) {
+    std::uint64_t z = seed ^ (round * 0x9e3779b97f4a7c15ULL) ^ (lower * 0xc2b2ae3d27d4eb4fULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    z ^= z >> 31;
+    return static_cast<double>(z >> 11) * 0x1.0p-53;
+}
+
+int owner_of(std::size_t temperature, std::size_t temperatures, int size) {
+    // Inverse of the block split below: rank p starts at p * T / P.
+    int p = static_cast<int>((temperature * static_cast<std::size_t>(size)) / temperatures);
+    while (static_cast<std::size_t>(p + 1) * temperatures / static_cast<std::size_t>(size) <= temperature) {
+        ++p;
+    }
+    while (static_cast<std::size_t>(p) * temperatures / static_cast<std::size_t>(size) > temperature) {
+        --p;
+    }
+    return p;
+}
+
+class SwapRounds {
+public:
+    SwapRounds(std::vector<Replica> &replicas,
+               const std::vector<double> &betas,
+               std::uint64_t seed,
+               int rank,
+               MPI_Comm comm)
+        : replicas_(replicas),
+          betas_(betas),
+          T_(static_cast<int>(betas.size())),
+          seed_(seed),
+          rank_(rank),
+          comm_(comm),
+          attempts_(betas.size() - 1, 0),
+          accepts_(betas.size() - 1, 0) {}
+
+    const std::vector<std::uint64_t> &attempts() const { return attempts_; }
+    const std::vector<std::uint64_t> &accepts() const { return accepts_; }
+
+    // Assigns every local replica its part in the next round and posts the
+    // energy receives. The previous round must be finished first, since it
+    // decides who the partners are.
+    void begin() {
+        finish();
+        const std::size_t parity = round_ % 2;
+        const std::size_t last = betas_.size() - 1;
+        for (auto &rep : replicas_) {
+            const std::size_t t = rep.temperature;
+            rep.old_temperature = t;
+            rep.accepted = false;
+            rep.outer_holder = -1;
+            rep.forwarded = -1;
+            if (t % 2 == parity && t < last) {
+                rep.role = Role::Lower;
+                rep.partner = rep.up;
+                rep.outer = rep.down;
+                rep.outer_temperature = t - 1;
+            } else if (t > 0 && (t - 1) % 2 == parity) {
+                rep.role = Role::Upper;
+                rep.partner = rep.down;
+                rep.outer = rep.up;
+                rep.outer_temperature = t + 1;
+            } else {
+                // Ladder ends sit out; their one neighbor is in a pair.
+                rep.role = Role::None;
+                rep.partner = -1;
+                rep.outer = (t == 0) ? rep.up : rep.down;
+                rep.outer_temperature = (t == 0) ? t + 1 : t - 1;
+            }
+            if (rep.role != Role::None) {
+                recvs_.emplace_back();
+                MPI_Irecv(&rep.partner_energy, 1, MPI_DOUBLE, rep.partner,
+                          tag(kEnergy, partner_temperature(rep)), comm_, &recvs_.back());
+            }
+        }
+        open_ = true;
+    }
+
+    // Sends a replica's energy as soon as its sweeps are done, while the
+    // rank goes on sweeping the others.
+    void send_energy(Replica &rep) {
+        if (rep.role == Role::None) {
+            return;
+        }
+        rep.sent_energy = rep.energy;
+        sends_.emplace_back();
+        MPI_Isend(&rep.sent_energy, 1, MPI_DOUBLE, rep.partner,
+                  tag(kEnergy, rep.old_temperature), comm_, &sends_.back());
+    }
+
+    // Waits for the partners' energies, swaps labels and tells the outer
+    // neighbors. The rest of the round is left to progress() and finish().
+    // The wait stays here, before the next sweep, so that the decision uses
+    // the energies of the states that actually swap.
+    void decide() {
+        wait(recvs_);
+        for (auto &rep : replicas_) {
+            if (rep.role != Role::None) {
+                const bool lower = rep.role == Role::Lower;
+                const std::size_t l = lower ? rep.old_temperature : rep.old_temperature - 1;
+                const double e_l = lower ? rep.energy : rep.partner_energy;
+                const double e_u = lower ? rep.partner_energy : rep.energy;
+                const double delta = (betas_[l] - betas_[l + 1]) * (e_u - e_l);
+                rep.accepted = delta <= 0.0 || swap_uniform(seed_, round_, l) < std::exp(-delta);
+                if (lower) {
+                    ++attempts_[l];
+                    accepts_[l] += rep.accepted ? 1 : 0;
+                }
+                if (rep.accepted) {
+                    rep.temperature = partner_temperature(rep);
+                }
+            }
+            if (rep.outer >= 0) {
+                rep.sent_holder = rep.accepted ? rep.partner : rank_;
+                sends_.emplace_back();
+                MPI_Isend(&rep.sent_holder, 1, MPI_INT, rep.outer,
+                          tag(kHolder, rep.old_temperature), comm_, &sends_.back());
+                recvs_.emplace_back();
+                MPI_Irecv(&rep.outer_holder, 1, MPI_INT, rep.outer,
+                          tag(kHolder, rep.outer_temperature), comm_, &recvs_.back());
+            }
+        }
+        ++round_;
+        forwarding_ = false;
+    }
+
+    // Non-blocking step between sweeps: once the outer neighbors answered,
+    // forwards their answers across accepted swaps.
+    void progress() {
+        if (!open_ || forwarding_ || recvs_.empty()) {
+            return;
+        }
+        int done = 0;
+        MPI_Testall(static_cast<int>(recvs_.size()), recvs_.data(), &done, MPI_STATUSES_IGNORE);
+        if (done) {
+            recvs_.clear();
+            post_forwards();
+        }
+    }
+
+    // Completes the round in flight and updates every replica's neighbors.
+    void finish() {
+        if (!open_) {
+            return;
+        }
+        if (!forwarding_) {
+            wait(recvs_);
+            post_forwards();
+        }
+        wait(recvs_);
+        wait(sends_);
+        for (auto &rep : replicas_) {
+            switch (rep.role) {
+            case Role::Lower:
+                if (rep.accepted) {
+                    rep.down = rep.partner;
+                    rep.up = rep.forwarded;
+                } else {
+                    rep.down = rep.outer_holder;
+                }
+                break;
+            case Role::Upper:
+                if (rep.accepted) {
+                    rep.up = rep.partner;
+                    rep.down = rep.forwarded;
+                } else {
+                    rep.up = rep.outer_holder;
+                }
+                break;
+            case Role::None:
+                (rep.temperature == 0 ? rep.up : rep.down) = rep.outer_holder;
+                break;
+            }
+        }
+        open_ = false;
+    }
+
+private:
+    std::vector<Replica> &replicas_;
+    const std::vector<double> &betas_;
+    int T_;
+    std::uint64_t seed_;
+    int rank_;
+    MPI_Comm comm_;
+    std::uint64_t round_ = 0;
+    bool open_ = false;
+    bool forwarding_ = false;
+    std::vector<MPI_Request> recvs_;
+    std::vector<MPI_Request> sends_;
+    std::vector<std::uint64_t> attempts_;
+    std::vector<std::uint64_t> accepts_;
+
+    int tag(Phase phase, std::size_t temperature) const {
+        return static_cast<int>(phase) * T_ + static_cast<int>(temperature);
+    }
+
+    static std::size_t partner_temperature(const Replica &rep) {
+        return rep.role == Role::Lower ? rep.old_temperature + 1 : rep.old_temperature - 1;
+    }
+
+    // A replica that took its partner's label needs the holder of the
+    // temperature beyond it, which only the partner heard about.
+    void post_forwards() {
+        for (auto &rep : replicas_) {
+            if (rep.role == Role::None || !rep.accepted) {
+                continue;
+            }
+            rep.sent_forward = rep.outer_holder;
+            sends_.emplace_back();
+            MPI_Isend(&rep.sent_forward, 1, MPI_INT, rep.partner,
+                      tag(kForward, rep.old_temperature), comm_, &sends_.back());
+            recvs_.emplace_back();
+            MPI_Irecv(&rep.forwarded, 1, MPI_INT, rep.partner,
+                      tag(kForward, partner_temperature(rep)), comm_, &recvs_.back());
+        }
+        forwarding_ = true;
+    }
+
+    static void wait(std::vector<MPI_Request> &requests) {
+        if (!requests.empty()) {
+            MPI_Waitall(static_cast<int>(requests.size()), requests.data(), MPI_STATUSES_IGNORE);
+            requests.clear();
+        }
+    }
+};
+
+} // namespace
+
+MPIParallelTemperingSummary run_parallel_tempering(const Hamiltonian &hamiltonian,
+                                                   std::vector<double> betas,
+                                                   std::size_t sweeps_per_step,
+                                                   std::size_t steps,
+                                                   std::size_t swap_interval,
+                                                   std::uint64_t seed,
+                                                   MPI_Comm comm) {
+    int rank = 0;
+    int size = 1;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &size);
+
+    const std::size_t T = betas.size();
+    if (T < 2) {
+        throw std::invalid_argument("Parallel tempering requires at least two betas.");
+    }
+    if (T < static_cast<std::size_t>(size)) {
+        throw std::invalid_argument("MPI parallel tempering needs at least one temperature per rank.");
+    }
+    if (sweeps_per_step == 0) {
+        throw std::invalid_argument("sweeps_per_step must be > 0.");
+    }
+    if (steps == 0) {
+        throw std::invalid_argument("steps must be > 0.");
+    }
+    if (swap_interval == 0) {
+        throw std::invalid_argument("swap_interval must be > 0.");
+    }
+    int *tag_ub = nullptr;
+    int has_tag_ub = 0;
+    MPI_Comm_get_attr(comm, MPI_TAG_UB, &tag_ub, &has_tag_ub);
+    if (has_tag_ub && static_cast<std::size_t>(*tag_ub) < 3 * T) {
+        throw std::invalid_argument("Too many temperatures for the MPI tag range.");
+    }
+
+    // Swap decisions need the same stream on every rank; sweeps do not.
+    std::uint64_t swap_seed = seed;
+    if (seed == 0) {
+        if (rank == 0) {
+            swap_seed = (static_cast<std::uint64_t>(std::random_device{}()) << 32) ^ std::random_device{}();
+        }
+        MPI_Bcast(&swap_seed, 1, MPI_UINT64_T, 0, comm);
+    }
+    std::mt19937_64 rng(seed != 0 ? seed + static_cast<std::uint64_t>(rank) : std::random_device{}());
+
+    auto backend = make_backend(BackendKind::CPU, hamiltonian);
+    const std::size_t n = backend->size();
+    const std::size_t first = static_cast<std::size_t>(rank) * T / static_cast<std::size_t>(size);
+    const std::size_t end = static_cast<std::size_t>(rank + 1) * T / static_cast<std::size_t>(size);
+
+    std::vector<Replica> replicas(end - first);
+    for (std::size_t j = 0; j < replicas.size(); ++j) {
+        auto &rep = replicas[j];
+        rep.temperature = first + j;
+        rep.state = State::random(n, rng);
+        rep.energy = backend->energy(rep.state.spins.data(), n);
+        rep.down = rep.temperature > 0 ? owner_of(rep.temperature - 1, T, size) : -1;
+        rep.up = rep.temperature + 1 < T ? owner_of(rep.temperature + 1, T, size) : -1;
+    }
+
+    double best_energy = std::numeric_limits<double>::infinity();
+    State best_state(n);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    SwapRounds swaps(replicas, betas, swap_seed, rank, comm);
+
+    for (std::size_t step = 0; step < steps; ++step) {
+        const bool swap_step = (step + 1) % swap_interval == 0;
+        for (std::size_t j = 0; j < replicas.size(); ++j) {
+            auto &rep = replicas[j];
+            const double beta = betas[rep.temperature];
+            for (std::size_t sweep = 0; sweep < sweeps_per_step; ++sweep) {
+                for (std::size_t i = 0; i < n; ++i) {
+                    const double delta = backend->delta_energy(rep.state.spins.data(), n, i);
+                    if (delta <= 0.0 || uniform(rng) < std::exp(-beta * delta)) {
+                        rep.state[i] = static_cast<int8_t>(-rep.state[i]);
+                        rep.energy += delta;
+                    }
+                }
+            }
+            if (rep.energy < best_energy) {
+                best_energy = rep.energy;
+                best_state = rep.state;
+            }
+            if (swap_step) {
+                if (j == 0) {
+                    swaps.begin();
+                }
+                swaps.send_energy(rep);
+            } else {
+                swaps.progress();
+            }
+        }
+        if (swap_step) {
+            swaps.decide();
+        }
+    }
+    swaps.finish();
+
+    MPIParallelTemperingSummary summary;
+    summary.rank = rank;
+    summary.size = size;
+    summary.temperature_energies.assign(T, 0.0);
+    for (const auto &rep : replicas) {
+        summary.local_temperatures.push_back(rep.temperature);
+        summary.local_energies.push_back(rep.energy);
+        summary.temperature_energies[rep.temperature] = rep.energy;
+    }
+    MPI_Allreduce(MPI_IN_PLACE, summary.temperature_energies.data(), static_cast<int>(T),
+                  MPI_DOUBLE, MPI_SUM, comm);
+    summary.swap_attempts = swaps.attempts();
+    summary.swap_accepts = swaps.accepts();
+    MPI_Allreduce(MPI_IN_PLACE, summary.swap_attempts.data(), static_cast<int>(T - 1),
+                  MPI_UINT64_T, MPI_SUM, comm);
+    MPI_Allreduce(MPI_IN_PLACE, summary.swap_accepts.data(), static_cast<int>(T - 1),
+                  MPI_UINT64_T, MPI_SUM, comm);
+
+    struct {
+        double energy;
+        int rank;
+    } local, global;
+    local.energy = best_energy;
+    local.rank = rank;
+    MPI_Allreduce(&local, &global, 1, MPI_DOUBLE_INT, MPI_MINLOC, comm);
+
+    summary.global_best_energy = global.energy;
+    summary.global_best_state = best_state;
+    MPI_Bcast(summary.global_best_state.spins.data(), static_cast<int>(n), MPI_SIGNED_CHAR, global.rank, comm);
+
+    return summary;
+}
+
+} // namespace qanneal::mpi
@@ -1,16 +1,163 @@
 #include "qanneal/mpi/mpi_replica.hpp"
 
+#include <algorithm>
+#include <cstring>
 #include <limits>
+#include <memory>
+#include <numeric>
+#include <random>
 #include <stdexcept>
+#include <vector>
 
 namespace qanneal::mpi {
 
+namespace {
+
+constexpr int kMigrationTag = 4401;
+
+// Island migration as a ReplicaAnnealer hook, run after every step: an
+// exchange posted after step s is received and applied after step s + 1,
+// so the transfer overlaps that step's sweeps.
+class Migration {
+public:
+    Migration(const IslandOptions &options, std::size_t n, std::uint64_t seed,
+              int rank, int size, MPI_Comm comm)
+        : options_(options),
+          n_(n),
+          record_(sizeof(double) + packed_spin_bytes(n)),
+          seed_(seed),
+          rank_(rank),
+          size_(size),
+          comm_(comm) {}
+
+    void operator()(std::size_t step, std::vector<State> &states, std::vector<double> &energies) {
+        if (pending_) {
+            receive(states, energies);
+        }
+        if ((step + 1) % options_.interval == 0) {
+            send(states, energies);
+        }
+    }
+
+    // Completes an exchange still in flight when the run ends; its
+    // migrants arrive too late to be used.
+    void finish() {
+        if (pending_) {
+            MPI_Waitall(2, requests_, MPI_STATUSES_IGNORE);
+            pending_ = false;
+        }
+    }
+
+    std::size_t received() const { return received_; }
+    std::size_t accepted() const { return accepted_; }
+
+private:
+    IslandOptions options_;
+    std::size_t n_;
+    std::size_t record_;
+    std::uint64_t seed_;
+    int rank_;
+    int size_;
+    MPI_Comm comm_;
+    std::uint64_t migrations_ = 0;
+    bool pending_ = false;
+    std::size_t count_ = 0;
+    std::vector<uint8_t> send_buffer_;
+    std::vector<uint8_t> recv_buffer_;
+    MPI_Request requests_[2];
+    std::vector<std::size_t> order_;
+    std::size_t received_ = 0;
+    std::size_t accepted_ = 0;
+
+    int shift() {
+        if (options_.topology == IslandTopology::Ring) {
+            return 1;
+        }
+        // The same draw on every rank, so senders and receivers pair up.
+        std::uint64_t z = seed_ ^ (++migrations_ * 0x9e3779b97f4a7c15ULL);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        z ^= z >> 31;
+        return 1 + static_cast<int>(z % static_cast<std::uint64_t>(size_ - 1));
+    }
+
+    void sort_by_energy(const std::vector<double> &energies) {
+        order_.resize(energies.size());
+        std::iota(order_.begin(), order_.end(), 0);
+        std::stable_sort(order_.begin(), order_.end(),
+                         [&](std::size_t a, std::size_t b) { return energies[a] < energies[b]; });
+    }
+
+    void send(const std::vector<State> &states, const std::vector<double> &energies) {
+        count_ = std::min(options_.migrants, states.size());
+        sort_by_energy(energies);
+        send_buffer_.resize(count_ * record_);
+        recv_buffer_.resize(count_ * record_);
+        for (std::size_t k = 0; k < count_; ++k) {
+            uint8_t *out = send_buffer_.data() + k * record_;
+            const std::size_t r = order_[k];
+            std::memcpy(out, &energies[r], sizeof(double));
+            pack_spins(states[r].spins.data(), n_, out + sizeof(double));
+        }
+        const int k = shift();
+        const int bytes = static_cast<int>(send_buffer_.size());
+        MPI_Irecv(recv_buffer_.data(), bytes, MPI_BYTE, (rank_ - k + size_) % size_,
+                  kMigrationTag, comm_, &requests_[0]);
+        MPI_Isend(send_buffer_.data(), bytes, MPI_BYTE, (rank_ + k) % size_,
+                  kMigrationTag, comm_, &requests_[1]);
+        pending_ = true;
+    }
+
+    void receive(std::vector<State> &states, std::vector<double> &energies) {
+        MPI_Waitall(2, requests_, MPI_STATUSES_IGNORE);
+        pending_ = false;
+        // Best migrant against the worst replica, and so on.
+        sort_by_energy(energies);
+        for (std::size_t k = 0; k < count_; ++k) {
+            const uint8_t *in = recv_buffer_.data() + k * record_;
+            double energy = 0.0;
+            std::memcpy(&energy, in, sizeof(double));
+            const std::size_t r = order_[order_.size() - 1 - k];
+            ++received_;
+            if (energy < energies[r]) {
+                unpack_spins(in + sizeof(double), n_, states[r].spins.data());
+                energies[r] = energy;
+                ++accepted_;
+            }
+        }
+    }
+};
+
+} // namespace
+
+void reduce_global_best(MPIReplicaSummary &summary, std::size_t n, MPI_Comm comm) {
+    struct {
+        double energy;
+        int rank;
+    } local, global;
+
+    local.energy = summary.local_best_energy;
+    local.rank = summary.rank;
+
+    MPI_Allreduce(&local, &global, 1, MPI_DOUBLE_INT, MPI_MINLOC, comm);
+
+    summary.global_best_energy = global.energy;
+    summary.global_best_state = State(n);
+
+    if (summary.rank == global.rank) {
+        summary.global_best_state = summary.local_best_state;
+    }
+
+    MPI_Bcast(summary.global_best_state.spins.data(), static_cast<int>(n), MPI_SIGNED_CHAR, global.rank, comm);
+}
+
 MPIReplicaSummary run_replica_anneal(const Hamiltonian &hamiltonian,
                                      AnnealSchedule schedule,
                                      std::size_t sweeps_per_beta,
                                      std::size_t replicas_per_rank,
                                      std::uint64_t seed,
-                                     MPI_Comm comm) {
+                                     MPI_Comm comm,
+                                     IslandOptions island) {
     int rank = 0;
     int size = 1;
     MPI_Comm_rank(comm, &rank);
@@ -20,33 +167,36 @@ MPIReplicaSummary run_replica_anneal(const Hamiltonian &hamiltonian,
     if (seed != 0) {
         annealer.set_seed(seed + static_cast<std::uint64_t>(rank));
     }
+    std::shared_ptr<Migration> migration;
+    if (island.interval > 0 && island.migrants > 0 && size > 1) {
+        // Random topologies need the same stream on every rank.
+        std::uint64_t shared_seed = seed;
+        if (rank == 0 && seed == 0) {
+            shared_seed = std::random_device{}();
+        }
+        MPI_Bcast(&shared_seed, 1, MPI_UINT64_T, 0, comm);
+        migration = std::make_shared<Migration>(island, hamiltonian.size(), shared_seed, rank, size, comm);
+        annealer.set_migration(1, [migration](std::size_t step, std::vector<State> &states,
+                                              std::vector<double> &energies) {
+            (*migration)(step, states, energies);
+        });
+    }
     const auto local_result = annealer.run(sweeps_per_beta);
+    if (migration) {
+        migration->finish();
+    }
 
     MPIReplicaSummary summary;
     summary.rank = rank;
     summary.size = size;
     summary.local_best_energy = local_result.global_best_energy;
     summary.local_best_state = local_result.global_best_state;
-
-    struct {
-        double energy;
-        int rank;
-    } local, global;
-
-    local.energy = local_result.global_best_energy;
-    local.rank = rank;
-
-    MPI_Allreduce(&local, &global, 1, MPI_DOUBLE_INT, MPI_MINLOC, comm);
-
-    summary.global_best_energy = global.energy;
-    summary.global_best_state = State(hamiltonian.size());
-
-    if (rank == global.rank) {
-        summary.global_best_state = local_result.global_best_state;
+    if (migration) {
+        summary.migrants_received = migration->received();
+        summary.migrants_accepted = migration->accepted();
     }
 
-    const int n = static_cast<int>(hamiltonian.size());
-    MPI_Bcast(summary.global_best_state.spins.data(), n, MPI_SIGNED_CHAR, global.rank, comm);
+    reduce_global_best(summary, hamiltonian.size(), comm);
 
     return summary;
 }
@@ -0,0 +1,469 @@
+#include "qanneal/mpi/mpi_restart_scheduler.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <exception>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include "qanneal/annealer.hpp"
+#include "qanneal/backend.hpp"
+#include "qanneal/mpi/mpi_context.hpp"
+
+namespace qanneal::mpi {
+
+namespace {
+
+// On a private duplicate of the caller's communicator, so these never
+// match the caller's own messages.
+constexpr int kRequestTag = 1;
+constexpr int kAssignTag = 2;
+constexpr int kReportTag = 3;
+// A worker whose batch threw; it sends nothing after this.
+constexpr int kFailTag = 4;
+
+using Clock = std::chrono::steady_clock;
+
+double seconds_since(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// Restarts [first, first + count); count == 0 tells a worker to stop.
+struct Batch {
+    std::uint64_t first = 0;
+    std::uint64_t count = 0;
+};
+
+struct BatchResult {
+    std::uint64_t restarts = 0;
+    std::uint64_t sweeps = 0;
+    std::uint64_t best_restart = 0;
+    double best_energy = std::numeric_limits<double>::infinity();
+    double seconds = 0.0;
+    StopReason reason = StopReason::Completed;
+    State best_state;
+};
+
+// What a worker streams back after each batch: the fixed fields, then the
+// best state bit-packed.
+struct ReportHeader {
+    std::uint64_t restarts;
+    std::uint64_t sweeps;
+    std::uint64_t best_restart;
+    double best_energy;
+    double seconds;
+    std::int32_t reason;
+};
+
+std::vector<std::uint8_t> pack_report(const BatchResult &result, std::size_t n) {
+    const ReportHeader header{result.restarts, result.sweeps, result.best_restart,
+                              result.best_energy, result.seconds, static_cast<std::int32_t>(result.reason)};
+    std::vector<std::uint8_t> buffer(sizeof(header) + packed_spin_bytes(n), 0);
+    std::memcpy(buffer.data(), &header, sizeof(header));
+    if (result.restarts > 0) {
+        pack_spins(result.best_state.spins.data(), n, buffer.data() + sizeof(header));
+    }
+    return buffer;
+}
+
+BatchResult unpack_report(const std::vector<std::uint8_t> &buffer, std::size_t n) {
+    ReportHeader header;
+    std::memcpy(&header, buffer.data(), sizeof(header));
+    BatchResult result;
+    result.restarts = header.restarts;
+    result.sweeps = header.sweeps;
+    result.best_restart = header.best_restart;
+    result.best_energy = header.best_energy;
+    result.seconds = header.seconds;
+    result.reason = static_cast<StopReason>(header.reason);
+    if (result.restarts > 0) {
+        result.best_state = State(n);
+        unpack_spins(buffer.data() + sizeof(header), n, result.best_state.spins.data());
+    }
+    return result;
+}
+
+class BatchRunner {
+public:
+    BatchRunner(const Hamiltonian &hamiltonian,
+                const AnnealSchedule &schedule,
+                std::size_t sweeps_per_beta,
+                const RestartSchedulerOptions &options,
+                std::uint64_t seed,
+                Clock::time_point start)
+        : backend_(make_backend(BackendKind::CPU, hamiltonian)),
+          schedule_(schedule),
+          sweeps_per_beta_(sweeps_per_beta),
+          options_(options),
+          seed_(seed),
+          start_(start) {}
+
+    BatchResult run(const Batch &batch) {
+        const auto begin = Clock::now();
+        BatchResult result;
+        for (std::uint64_t r = batch.first; r < batch.first + batch.count; ++r) {
+            StopCriteria stop;
+            stop.target_energy = options_.target_energy;
+            if (options_.time_limit > 0.0) {
+                stop.time_limit = options_.time_limit - seconds_since(start_);
+                if (stop.time_limit <= 0.0) {
+                    result.reason = StopReason::TimeLimit;
+                    break;
+                }
+            }
+            Annealer annealer(backend_, schedule_);
+            annealer.set_seed(seed_ + r);
+            annealer.set_stop_criteria(stop);
+            auto outcome = annealer.run(sweeps_per_beta_);
+            ++result.restarts;
+            result.sweeps += outcome.sweeps;
+            if (outcome.best_energy < result.best_energy) {
+                result.best_energy = outcome.best_energy;
+                result.best_restart = r;
+                result.best_state = std::move(outcome.best_state);
+            }
+            if (outcome.stop_reason != StopReason::Completed) {
+                result.reason = outcome.stop_reason;
+                break;
+            }
+        }
+        result.seconds = seconds_since(begin);
+        return result;
+    }
+
+private:
+    std::shared_ptr<Backend> backend_;
+    const AnnealSchedule &schedule_;
+    std::size_t sweeps_per_beta_;
+    RestartSchedulerOptions options_;
+    std::uint64_t seed_;
+    Clock::time_point start_;
+};
+
+// Rank 0's view of the job, shared by the thread serving requests and the
+// thread running rank 0's own batches.
+class Ledger {
+public:
+    Ledger(const RestartSchedulerOptions &options, Clock::time_point start)
+        : options_(options), start_(start) {}
+
+    Batch take() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        check_deadline();
+        Batch batch;
+        if (!stopping_) {
+            batch.first = next_;
+            batch.count = std::min<std::uint64_t>(options_.batch, options_.restarts - next_);
+            next_ += batch.count;
+        }
+        return batch;
+    }
+
+    void record(BatchResult result) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (result.restarts > 0 && result.best_energy < best_energy_) {
+            best_energy_ = result.best_energy;
+            best_restart_ = result.best_restart;
+            best_state_ = std::move(result.best_state);
+        }
+        if (best_energy_ <= options_.target_energy) {
+            stop(StopReason::TargetEnergy);
+        } else if (result.reason == StopReason::TimeLimit) {
+            stop(StopReason::TimeLimit);
+        }
+    }
+
+    void cancel() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop(StopReason::Cancelled);
+    }
+
+    // Only once every batch is in.
+    StopReason reason() const { return reason_; }
+    double best_energy() const { return best_energy_; }
+    std::uint64_t best_restart() const { return best_restart_; }
+    const State &best_state() const { return best_state_; }
+
+private:
+    RestartSchedulerOptions options_;
+    Clock::time_point start_;
+    std::mutex mutex_;
+    std::uint64_t next_ = 0;
+    bool stopping_ = false;
+    StopReason reason_ = StopReason::Completed;
+    double best_energy_ = std::numeric_limits<double>::infinity();
+    std::uint64_t best_restart_ = 0;
+    State best_state_;
+
+    void stop(StopReason reason) {
+        if (!stopping_) {
+            stopping_ = true;
+            reason_ = reason;
+        }
+    }
+
+    void check_deadline() {
+        if (options_.time_limit > 0.0 && seconds_since(start_) >= options_.time_limit) {
+            stop(StopReason::TimeLimit);
+        }
+    }
+};
+
+struct LocalWork {
+    std::size_t restarts = 0;
+    std::size_t batches = 0;
+    std::size_t sweeps = 0;
+    double busy = 0.0;
+
+    void add(const BatchResult &result) {
+        restarts += result.restarts;
+        ++batches;
+        sweeps += result.sweeps;
+        busy += result.seconds;
+    }
+};
+
+// Serves batch requests and reports from every other rank until each has
+// been told to stop and has reported every batch it was given, or has
+// failed. Returns the lowest failed rank, or 0 if none failed.
+int serve(Ledger &ledger, std::size_t n, int size, MPI_Comm comm) {
+    constexpr std::uint64_t kFinished = std::numeric_limits<std::uint64_t>::max();
+    std::vector<std::uint64_t> outstanding(static_cast<std::size_t>(size), 0);
+    std::vector<bool> stopped(static_cast<std::size_t>(size), false);
+    int live = size - 1;
+    int failed = 0;
+    // Replies in flight; a list keeps each buffer in place until sent.
+    std::list<std::pair<Batch, MPI_Request>> replies;
+    std::vector<std::uint8_t> report;
+
+    while (live > 0) {
+        // Blocks until a rank asks, reports or fails; the deadline is
+        // checked whenever a batch is handed out.
+        MPI_Status status;
+        MPI_Probe(MPI_ANY_SOURCE, MPI_ANY_TAG, comm, &status);
+        replies.remove_if([](std::pair<Batch, MPI_Request> &reply) {
+            int done = 0;
+            MPI_Test(&reply.second, &done, MPI_STATUS_IGNORE);
+            return done != 0;
+        });
+        const int source = status.MPI_SOURCE;
+        if (status.MPI_TAG == kFailTag) {
+            char message = 0;
+            MPI_Recv(&message, 1, MPI_CHAR, source, kFailTag, comm, MPI_STATUS_IGNORE);
+            ledger.cancel();
+            if (failed == 0 || source < failed) {
+                failed = source;
+            }
+            if (outstanding[static_cast<std::size_t>(source)] != kFinished) {
+                outstanding[static_cast<std::size_t>(source)] = kFinished;
+                --live;
+            }
+            continue;
+        }
+        if (status.MPI_TAG == kRequestTag) {
+            char request = 0;
+            MPI_Recv(&request, 1, MPI_CHAR, source, kRequestTag, comm, MPI_STATUS_IGNORE);
+            replies.emplace_back(ledger.take(), MPI_REQUEST_NULL);
+            auto &reply = replies.back();
+            if (reply.first.count > 0) {
+                ++outstanding[static_cast<std::size_t>(source)];
+            } else {
+                stopped[static_cast<std::size_t>(source)] = true;
+            }
+            MPI_Isend(&reply.first, 2, MPI_UINT64_T, source, kAssignTag, comm, &reply.second);
+        } else {
+            int bytes = 0;
+            MPI_Get_count(&status, MPI_BYTE, &bytes);
+            report.resize(static_cast<std::size_t>(bytes));
+            MPI_Recv(report.data(), bytes, MPI_BYTE, source, kReportTag, comm, MPI_STATUS_IGNORE);
+            ledger.record(unpack_report(report, n));
+            --outstanding[static_cast<std::size_t>(source)];
+        }
+        if (stopped[static_cast<std::size_t>(source)] && outstanding[static_cast<std::size_t>(source)] == 0) {
+            // Marks the rank finished exactly once.
+            outstanding[static_cast<std::size_t>(source)] = kFinished;
+            --live;
+        }
+    }
+    for (auto &reply : replies) {
+        MPI_Wait(&reply.second, MPI_STATUS_IGNORE);
+    }
+    return failed;
+}
+
+// A rank other than 0: asks for its next batch as soon as it starts the
+// current one, so the reply arrives while it anneals. If a batch throws,
+// tells rank 0 (which then stops handing out work) and returns the error.
+std::exception_ptr work(BatchRunner &runner, LocalWork &local, std::size_t n, MPI_Comm comm) {
+    const char request = 0;
+    MPI_Request ask = MPI_REQUEST_NULL;
+    MPI_Request assign = MPI_REQUEST_NULL;
+    MPI_Request sent = MPI_REQUEST_NULL;
+    std::vector<std::uint8_t> report;
+
+    Batch current;
+    MPI_Isend(&request, 1, MPI_CHAR, 0, kRequestTag, comm, &ask);
+    MPI_Irecv(&current, 2, MPI_UINT64_T, 0, kAssignTag, comm, &assign);
+    MPI_Wait(&assign, MPI_STATUS_IGNORE);
+    MPI_Wait(&ask, MPI_STATUS_IGNORE);
+    while (current.count > 0) {
+        Batch next;
+        MPI_Isend(&request, 1, MPI_CHAR, 0, kRequestTag, comm, &ask);
+        MPI_Irecv(&next, 2, MPI_UINT64_T, 0, kAssignTag, comm, &assign);
+
+        std::exception_ptr error;
+        try {
+            const BatchResult result = runner.run(current);
+            local.add(result);
+            MPI_Wait(&sent, MPI_STATUS_IGNORE);
+            report = pack_report(result, n);
+            MPI_Isend(report.data(), static_cast<int>(report.size()), MPI_BYTE, 0, kReportTag, comm, &sent);
+        } catch (...) {
+            error = std::current_exception();
+            const char message = 0;
+            MPI_Wait(&sent, MPI_STATUS_IGNORE);
+            MPI_Send(&message, 1, MPI_CHAR, 0, kFailTag, comm);
+        }
+
+        // The request went out before any failure, so it is still answered.
+        MPI_Wait(&assign, MPI_STATUS_IGNORE);
+        MPI_Wait(&ask, MPI_STATUS_IGNORE);
+        if (error) {
+            return error;
+        }
+        current = next;
+    }
+    MPI_Wait(&sent, MPI_STATUS_IGNORE);
+    return nullptr;
+}
+
+} // namespace
+
+MPIRestartSummary run_scheduled_restarts(const Hamiltonian &hamiltonian,
+                                         AnnealSchedule schedule,
+                                         std::size_t sweeps_per_beta,
+                                         RestartSchedulerOptions options,
+                                         MPI_Comm comm) {
+    schedule.validate();
+    if (sweeps_per_beta == 0) {
+        throw std::invalid_argument("sweeps_per_beta must be > 0.");
+    }
+    if (options.restarts == 0) {
+        throw std::invalid_argument("restarts must be > 0.");
+    }
+    if (options.batch == 0) {
+        throw std::invalid_argument("batch must be > 0.");
+    }
+    require_funneled("run_scheduled_restarts");
+
+    MPIRestartSummary summary;
+    MPI_Comm jobs;
+    MPI_Comm_dup(comm, &jobs);
+    MPI_Comm_rank(jobs, &summary.rank);
+    MPI_Comm_size(jobs, &summary.size);
+    const std::size_t n = hamiltonian.size();
+
+    std::uint64_t seed = options.seed;
+    if (summary.rank == 0 && seed == 0) {
+        seed = (static_cast<std::uint64_t>(std::random_device{}()) << 32) ^ std::random_device{}();
+    }
+    MPI_Bcast(&seed, 1, MPI_UINT64_T, 0, jobs);
+
+    MPI_Barrier(jobs);
+    const auto start = Clock::now();
+    BatchRunner runner(hamiltonian, schedule, sweeps_per_beta, options, seed, start);
+    LocalWork local;
+
+    double best_energy = 0.0;
+    std::uint64_t best_restart = 0;
+    std::int32_t reason = 0;
+    int failed = 0;
+    summary.global_best_state = State(n);
+    if (summary.rank == 0) {
+        Ledger ledger(options, start);
+        std::exception_ptr error;
+        auto own_batches = [&] {
+            try {
+                for (Batch batch = ledger.take(); batch.count > 0; batch = ledger.take()) {
+                    BatchResult result = runner.run(batch);
+                    local.add(result);
+                    ledger.record(std::move(result));
+                }
+            } catch (...) {
+                error = std::current_exception();
+                // The other ranks still get their stop replies.
+                ledger.cancel();
+            }
+        };
+        int failed_rank = 0;
+        if (summary.size > 1) {
+            std::thread annealing(own_batches);
+            failed_rank = serve(ledger, n, summary.size, jobs);
+            annealing.join();
+        } else {
+            own_batches();
+        }
+        // 1 + the failed rank, so that a failure on rank 0 is 1.
+        failed = error ? 1 : (failed_rank > 0 ? failed_rank + 1 : 0);
+        MPI_Bcast(&failed, 1, MPI_INT, 0, jobs);
+        if (error) {
+            MPI_Comm_free(&jobs);
+            std::rethrow_exception(error);
+        }
+        if (failed) {
+            MPI_Comm_free(&jobs);
+            throw std::runtime_error("Restart scheduling failed on rank " + std::to_string(failed_rank) + ".");
+        }
+        best_energy = ledger.best_energy();
+        best_restart = ledger.best_restart();
+        reason = static_cast<std::int32_t>(ledger.reason());
+        if (ledger.best_state().size() == n) {
+            summary.global_best_state = ledger.best_state();
+        }
+    } else {
+        const std::exception_ptr error = work(runner, local, n, jobs);
+        MPI_Bcast(&failed, 1, MPI_INT, 0, jobs);
+        if (failed) {
+            MPI_Comm_free(&jobs);
+            if (error) {
+                std::rethrow_exception(error);
+            }
+            throw std::runtime_error("Restart scheduling failed on rank " + std::to_string(failed - 1) + ".");
+        }
+    }
+    summary.local_restarts = local.restarts;
+    summary.local_batches = local.batches;
+    summary.local_sweeps = local.sweeps;
+    summary.local_busy_seconds = local.busy;
+
+    MPI_Bcast(&best_energy, 1, MPI_DOUBLE, 0, jobs);
+    MPI_Bcast(&best_restart, 1, MPI_UINT64_T, 0, jobs);
+    MPI_Bcast(&reason, 1, MPI_INT32_T, 0, jobs);
+    MPI_Bcast(summary.global_best_state.spins.data(), static_cast<int>(n), MPI_SIGNED_CHAR, 0, jobs);
+    summary.global_best_energy = best_energy;
+    summary.best_restart = static_cast<std::size_t>(best_restart);
+    summary.stop_reason = static_cast<StopReason>(reason);
+
+    const std::uint64_t restarts = local.restarts;
+    std::vector<std::uint64_t> restarts_per_rank(static_cast<std::size_t>(summary.size));
+    MPI_Allgather(&restarts, 1, MPI_UINT64_T, restarts_per_rank.data(), 1, MPI_UINT64_T, jobs);
+    summary.busy_seconds_per_rank.resize(static_cast<std::size_t>(summary.size));
+    MPI_Allgather(&local.busy, 1, MPI_DOUBLE, summary.busy_seconds_per_rank.data(), 1, MPI_DOUBLE, jobs);
+    for (std::uint64_t count : restarts_per_rank) {
+        summary.restarts_per_rank.push_back(static_cast<std::size_t>(count));
+        summary.restarts_completed += static_cast<std::size_t>(count);
+    }
+    const double elapsed = seconds_since(start);
+    MPI_Allreduce(&elapsed, &summary.elapsed_seconds, 1, MPI_DOUBLE, MPI_MAX, jobs);
+
+    MPI_Comm_free(&jobs);
+    return summary;
+}
+
+} // namespace qanneal::mpi
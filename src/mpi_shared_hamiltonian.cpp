@@ -0,0 +1,326 @@
+#include "qanneal/mpi/mpi_shared_hamiltonian.hpp"
+
+#include <algorithm>
+#include <exception>
+#include <limits>
+#include <stdexcept>
+
+#include "qanneal/state.hpp"
+
+namespace qanneal::mpi {
+
+namespace {
+
+// Copies the node leader's `value` to the other ranks on its node.
+template <typename T>
+void broadcast_on_node(T &value, MPI_Comm comm) {
+    int rank = 0;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm node;
+    MPI_Comm_split_type(comm, MPI_COMM_TYPE_SHARED, rank, MPI_INFO_NULL, &node);
+    MPI_Bcast(&value, static_cast<int>(sizeof(T)), MPI_BYTE, 0, node);
+    MPI_Comm_free(&node);
+}
+
+bool node_leader(MPI_Comm comm) {
+    int rank = 0;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm node;
+    MPI_Comm_split_type(comm, MPI_COMM_TYPE_SHARED, rank, MPI_INFO_NULL, &node);
+    int node_rank = 0;
+    MPI_Comm_rank(node, &node_rank);
+    MPI_Comm_free(&node);
+    return node_rank == 0;
+}
+
+// Whether `ok` holds on every rank of `comm`. Windows are only agreed on
+// within a node, so a failure on one node has to reach the others before
+// they go on to the next collective over `comm`.
+bool on_every_rank(bool ok, MPI_Comm comm) {
+    int flag = ok ? 1 : 0;
+    MPI_Allreduce(MPI_IN_PLACE, &flag, 1, MPI_INT, MPI_LAND, comm);
+    return flag != 0;
+}
+
+constexpr std::size_t kMaxBytes = static_cast<std::size_t>(std::numeric_limits<MPI_Aint>::max());
+
+} // namespace
+
+NodeSharedWindow::NodeSharedWindow(std::size_t bytes, MPI_Comm comm) : bytes_(bytes) {
+    if (bytes > kMaxBytes) {
+        throw std::invalid_argument("Shared window too large.");
+    }
+    int rank = 0;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_split_type(comm, MPI_COMM_TYPE_SHARED, rank, MPI_INFO_NULL, &node_);
+    MPI_Comm_rank(node_, &node_rank_);
+
+    void *base = nullptr;
+    const MPI_Aint local = leader() ? static_cast<MPI_Aint>(bytes) : 0;
+    if (MPI_Win_allocate_shared(local, 1, MPI_INFO_NULL, node_, &base, &win_) != MPI_SUCCESS) {
+        MPI_Comm_free(&node_);
+        throw std::runtime_error("MPI_Win_allocate_shared failed.");
+    }
+    MPI_Aint size = 0;
+    int unit = 0;
+    MPI_Win_shared_query(win_, 0, &size, &unit, &data_);
+    MPI_Win_fence(MPI_MODE_NOPRECEDE, win_);
+}
+
+NodeSharedWindow::~NodeSharedWindow() {
+    int finalized = 0;
+    MPI_Finalized(&finalized);
+    if (finalized) {
+        return;
+    }
+    if (win_ != MPI_WIN_NULL) {
+        MPI_Win_free(&win_);
+    }
+    if (node_ != MPI_COMM_NULL) {
+        MPI_Comm_free(&node_);
+    }
+}
+
+bool NodeSharedWindow::publish(bool ok) {
+    MPI_Win_fence(MPI_MODE_NOSUCCEED, win_);
+    int flag = ok ? 1 : 0;
+    MPI_Bcast(&flag, 1, MPI_INT, 0, node_);
+    return flag != 0;
+}
+
+SharedDenseIsing::SharedDenseIsing(std::size_t n, const Fill &fill, double c, MPI_Comm comm)
+    : n_(n),
+      c_(c),
+      window_((n == 0 || n > (kMaxBytes / sizeof(double)) / (n + 1)) ? 0 : (n + n * n) * sizeof(double), comm) {
+    if (n_ == 0) {
+        throw std::invalid_argument("SharedDenseIsing size must be > 0.");
+    }
+    if (window_.bytes() == 0) {
+        throw std::invalid_argument("SharedDenseIsing too large.");
+    }
+    double *h = static_cast<double *>(window_.data());
+    std::exception_ptr error;
+    if (window_.leader()) {
+        try {
+            fill(h, h + n_);
+        } catch (...) {
+            error = std::current_exception();
+        }
+    }
+    const bool ok = on_every_rank(window_.publish(!error), comm);
+    if (error) {
+        std::rethrow_exception(error);
+    }
+    if (!ok) {
+        throw std::runtime_error("SharedDenseIsing fill failed on a node leader.");
+    }
+    h_ = h;
+    J_ = h + n_;
+}
+
+SharedDenseIsing::SharedDenseIsing(const DenseIsing *source, MPI_Comm comm)
+    : SharedDenseIsing(source, shape(source, comm), comm) {}
+
+SharedDenseIsing::Shape SharedDenseIsing::shape(const DenseIsing *source, MPI_Comm comm) {
+    Shape result{0, 0.0};
+    if (node_leader(comm) && source) {
+        result = {source->size(), source->constant()};
+    }
+    broadcast_on_node(result, comm);
+    if (!on_every_rank(result.n != 0, comm)) {
+        throw std::invalid_argument("SharedDenseIsing needs a source on every node leader.");
+    }
+    return result;
+}
+
+SharedDenseIsing::SharedDenseIsing(const DenseIsing *source, const Shape &shape, MPI_Comm comm)
+    : SharedDenseIsing(
+          static_cast<std::size_t>(shape.n),
+          [source](double *h, double *J) {
+              std::copy(source->h().begin(), source->h().end(), h);
+              std::copy(source->J().begin(), source->J().end(), J);
+          },
+          shape.c,
+          comm) {}
+
+void SharedDenseIsing::validate(std::size_t n, std::size_t flip) const {
+    if (n != n_) {
+        throw std::invalid_argument("State size mismatch.");
+    }
+    if (flip >= n_) {
+        throw std::invalid_argument("Flip index out of range.");
+    }
+}
+
+double SharedDenseIsing::energy(const int8_t *spins, std::size_t n) const {
+    if (n != n_) {
+        throw std::invalid_argument("State size mismatch.");
+    }
+    validate_spins(spins, n_);
+    double E = c_;
+    for (std::size_t i = 0; i < n_; ++i) {
+        E += h_[i] * static_cast<double>(spins[i]);
+    }
+    for (std::size_t i = 0; i < n_; ++i) {
+        const double *row = J_ + i * n_;
+        for (std::size_t j = i + 1; j < n_; ++j) {
+            E += row[j] * static_cast<double>(spins[i]) * static_cast<double>(spins[j]);
+        }
+    }
+    return E;
+}
+
+double SharedDenseIsing::delta_energy(const int8_t *spins, std::size_t n, std::size_t flip) const {
+    validate(n, flip);
+    const double *row = J_ + flip * n_;
+    double local = h_[flip];
+    for (std::size_t j = 0; j < n_; ++j) {
+        if (j == flip) {
+            continue;
+        }
+        local += row[j] * static_cast<double>(spins[j]);
+    }
+    return -2.0 * static_cast<double>(spins[flip]) * local;
+}
+
+CouplingGraph SharedDenseIsing::coupling_graph() const {
+    CouplingGraph graph;
+    graph.h.assign(h_, h_ + n_);
+    graph.offsets.reserve(n_ + 1);
+    graph.offsets.push_back(0);
+    for (std::size_t i = 0; i < n_; ++i) {
+        for (std::size_t j = 0; j < n_; ++j) {
+            const double value = J_[i * n_ + j];
+            if (j == i || value == 0.0) {
+                continue;
+            }
+            graph.neighbors.push_back(j);
+            graph.weights.push_back(value);
+        }
+        graph.offsets.push_back(graph.neighbors.size());
+    }
+    return graph;
+}
+
+SharedSparseIsing::SharedSparseIsing(const SparseIsing *source, MPI_Comm comm)
+    : SharedSparseIsing(source, shape(source, comm), comm) {}
+
+SharedSparseIsing::Shape SharedSparseIsing::shape(const SparseIsing *source, MPI_Comm comm) {
+    Shape result{0, 0, 0.0};
+    if (node_leader(comm) && source) {
+        // Each coupling is stored once per endpoint, zero couplings dropped.
+        std::uint64_t entries = 0;
+        for (const auto &edge : source->edges()) {
+            entries += edge.value != 0.0 ? 2 : 0;
+        }
+        result = {source->size(), entries, source->constant()};
+    }
+    broadcast_on_node(result, comm);
+    if (!on_every_rank(result.n != 0, comm)) {
+        throw std::invalid_argument("SharedSparseIsing needs a source on every node leader.");
+    }
+    return result;
+}
+
+SharedSparseIsing::SharedSparseIsing(const SparseIsing *source, const Shape &shape, MPI_Comm comm)
+    : n_(static_cast<std::size_t>(shape.n)),
+      entries_(static_cast<std::size_t>(shape.entries)),
+      c_(shape.c),
+      window_((2 * n_ + 1 + 2 * entries_) * 8, comm) {
+    static_assert(sizeof(double) == 8 && sizeof(std::uint64_t) == 8, "8-byte coefficients expected.");
+    // Layout: h, weights, offsets, neighbors.
+    double *h = static_cast<double *>(window_.data());
+    double *weights = h + n_;
+    auto *offsets = reinterpret_cast<std::uint64_t *>(weights + entries_);
+    std::uint64_t *neighbors = offsets + n_ + 1;
+    std::exception_ptr error;
+    if (window_.leader()) {
+        try {
+            // Counting sort of the edges into rows, without building a second
+            // adjacency list next to the shared one.
+            std::copy(source->h().begin(), source->h().end(), h);
+            std::fill(offsets, offsets + n_ + 1, 0);
+            for (const auto &edge : source->edges()) {
+                if (edge.value != 0.0) {
+                    ++offsets[edge.i + 1];
+                    ++offsets[edge.j + 1];
+                }
+            }
+            for (std::size_t i = 0; i < n_; ++i) {
+                offsets[i + 1] += offsets[i];
+            }
+            std::vector<std::uint64_t> next(offsets, offsets + n_);
+            for (const auto &edge : source->edges()) {
+                if (edge.value == 0.0) {
+                    continue;
+                }
+                const std::uint64_t a = next[edge.i]++;
+                neighbors[a] = edge.j;
+                weights[a] = edge.value;
+                const std::uint64_t b = next[edge.j]++;
+                neighbors[b] = edge.i;
+                weights[b] = edge.value;
+            }
+        } catch (...) {
+            error = std::current_exception();
+        }
+    }
+    const bool ok = on_every_rank(window_.publish(!error), comm);
+    if (error) {
+        std::rethrow_exception(error);
+    }
+    if (!ok) {
+        throw std::runtime_error("SharedSparseIsing copy failed on a node leader.");
+    }
+    h_ = h;
+    weights_ = weights;
+    offsets_ = offsets;
+    neighbors_ = neighbors;
+}
+
+void SharedSparseIsing::validate(std::size_t n, std::size_t flip) const {
+    if (n != n_) {
+        throw std::invalid_argument("State size mismatch.");
+    }
+    if (flip >= n_) {
+        throw std::invalid_argument("Flip index out of range.");
+    }
+}
+
+double SharedSparseIsing::energy(const int8_t *spins, std::size_t n) const {
+    if (n != n_) {
+        throw std::invalid_argument("State size mismatch.");
+    }
+    validate_spins(spins, n_);
+    double E = c_;
+    for (std::size_t i = 0; i < n_; ++i) {
+        const double s = static_cast<double>(spins[i]);
+        E += h_[i] * s;
+        for (std::uint64_t k = offsets_[i]; k < offsets_[i + 1]; ++k) {
+            if (neighbors_[k] > i) {
+                E += weights_[k] * s * static_cast<double>(spins[neighbors_[k]]);
+            }
+        }
+    }
+    return E;
+}
+
+double SharedSparseIsing::delta_energy(const int8_t *spins, std::size_t n, std::size_t flip) const {
+    validate(n, flip);
+    double local = h_[flip];
+    for (std::uint64_t k = offsets_[flip]; k < offsets_[flip + 1]; ++k) {
+        local += weights_[k] * static_cast<double>(spins[neighbors_[k]]);
+    }
+    return -2.0 * static_cast<double>(spins[flip]) * local;
+}
+
+CouplingGraph SharedSparseIsing::coupling_graph() const {
+    CouplingGraph graph;
+    graph.h.assign(h_, h_ + n_);
+    graph.offsets.assign(offsets_, offsets_ + n_ + 1);
+    graph.neighbors.assign(neighbors_, neighbors_ + entries_);
+    graph.weights.assign(weights_, weights_ + entries_);
+    return graph;
+}
+
+} // namespace qanneal::mpi
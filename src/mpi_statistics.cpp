@@ -0,0 +1,232 @@
+#include "qanneal/mpi/mpi_statistics.hpp"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+#include "qanneal/state.hpp"
+
+namespace qanneal::mpi {
+
+namespace {
+
+// Throws on every rank unless `values` is the same on every rank.
+template <typename T>
+void require_same(const std::vector<T> &values, MPI_Datatype type, MPI_Comm comm, const char *message) {
+    std::vector<T> low(values.size());
+    std::vector<T> high(values.size());
+    const int count = static_cast<int>(values.size());
+    MPI_Allreduce(values.data(), low.data(), count, type, MPI_MIN, comm);
+    MPI_Allreduce(values.data(), high.data(), count, type, MPI_MAX, comm);
+    if (low != high) {
+        throw std::invalid_argument(message);
+    }
+}
+
+// Count, mean and sum of squared deviations of one step, combined with
+// Chan's pairwise update so that the spread of energies far from zero
+// does not cancel away.
+struct Moments {
+    double count;
+    double mean;
+    double m2;
+    double min;
+    double max;
+};
+
+void combine(const Moments &in, Moments &out) {
+    if (in.count == 0.0) {
+        return;
+    }
+    if (out.count == 0.0) {
+        out = in;
+        return;
+    }
+    const double count = in.count + out.count;
+    const double delta = in.mean - out.mean;
+    out.mean += delta * in.count / count;
+    out.m2 += in.m2 + delta * delta * in.count * out.count / count;
+    out.count = count;
+    out.min = std::min(out.min, in.min);
+    out.max = std::max(out.max, in.max);
+}
+
+void combine_moments(void *in, void *inout, int *len, MPI_Datatype *) {
+    const auto *a = static_cast<const Moments *>(in);
+    auto *b = static_cast<Moments *>(inout);
+    for (int i = 0; i < *len; ++i) {
+        combine(a[i], b[i]);
+    }
+}
+
+// A sample set as one contiguous MPI element: a header, then `capacity`
+// fixed-size records (energy, count, hash, bit-packed spins), of which the
+// first `size` are used.
+struct SetHeader {
+    std::uint64_t n;
+    std::uint64_t capacity;
+    std::uint64_t seed;
+    std::uint64_t size;
+    std::uint64_t offered;
+};
+
+std::size_t record_bytes(std::size_t n) {
+    return sizeof(double) + 2 * sizeof(std::uint64_t) + packed_spin_bytes(n);
+}
+
+std::size_t set_bytes(std::size_t n, std::size_t capacity) {
+    return sizeof(SetHeader) + capacity * record_bytes(n);
+}
+
+void encode(const SampleSet &set, std::uint8_t *out) {
+    const std::size_t n = set.num_spins();
+    const auto samples = set.samples();
+    const SetHeader header{n, set.capacity(), set.zobrist().seed(), samples.size(), set.offered()};
+    std::memcpy(out, &header, sizeof(header));
+    std::uint8_t *record = out + sizeof(header);
+    for (const auto &sample : samples) {
+        const std::uint64_t hash = set.zobrist().hash(sample.state);
+        std::memcpy(record, &sample.energy, sizeof(double));
+        std::memcpy(record + sizeof(double), &sample.count, sizeof(std::uint64_t));
+        std::memcpy(record + sizeof(double) + sizeof(std::uint64_t), &hash, sizeof(std::uint64_t));
+        pack_spins(sample.state.spins.data(), n, record + sizeof(double) + 2 * sizeof(std::uint64_t));
+        record += record_bytes(n);
+    }
+}
+
+SampleSet decode(const std::uint8_t *in) {
+    SetHeader header;
+    std::memcpy(&header, in, sizeof(header));
+    const std::size_t n = static_cast<std::size_t>(header.n);
+    SampleSet set(n, static_cast<std::size_t>(header.capacity), header.seed);
+    std::vector<int8_t> spins(n);
+    std::uint64_t kept = 0;
+    const std::uint8_t *record = in + sizeof(header);
+    for (std::uint64_t k = 0; k < header.size; ++k) {
+        double energy;
+        std::uint64_t count;
+        std::uint64_t hash;
+        std::memcpy(&energy, record, sizeof(double));
+        std::memcpy(&count, record + sizeof(double), sizeof(std::uint64_t));
+        std::memcpy(&hash, record + sizeof(double) + sizeof(std::uint64_t), sizeof(std::uint64_t));
+        unpack_spins(record + sizeof(double) + 2 * sizeof(std::uint64_t), n, spins.data());
+        set.add(spins.data(), energy, hash, count);
+        kept += count;
+        record += record_bytes(n);
+    }
+    set.add_offered(header.offered - kept);
+    return set;
+}
+
+void merge_sample_sets(void *in, void *inout, int *len, MPI_Datatype *type) {
+    MPI_Aint lower = 0;
+    MPI_Aint extent = 0;
+    MPI_Type_get_extent(*type, &lower, &extent);
+    for (int e = 0; e < *len; ++e) {
+        const auto *a = static_cast<const std::uint8_t *>(in) + e * extent;
+        auto *b = static_cast<std::uint8_t *>(inout) + e * extent;
+        SampleSet merged = decode(b);
+        merged.merge(decode(a));
+        encode(merged, b);
+    }
+}
+
+} // namespace
+
+void allreduce_histogram(EnergyHistogram &histogram, MPI_Comm comm) {
+    require_same(std::vector<double>{histogram.lower, histogram.upper, histogram.target,
+                                     static_cast<double>(histogram.bins())},
+                 MPI_DOUBLE, comm, "Histograms must share bins and target on every rank.");
+
+    std::vector<std::uint64_t> counts(histogram.counts);
+    counts.push_back(histogram.underflow);
+    counts.push_back(histogram.overflow);
+    counts.push_back(histogram.hits);
+    MPI_Allreduce(MPI_IN_PLACE, counts.data(), static_cast<int>(counts.size()), MPI_UINT64_T, MPI_SUM, comm);
+    double extremes[2] = {histogram.min_energy, -histogram.max_energy};
+    MPI_Allreduce(MPI_IN_PLACE, extremes, 2, MPI_DOUBLE, MPI_MIN, comm);
+
+    const std::size_t bins = histogram.bins();
+    std::copy(counts.begin(), counts.begin() + static_cast<std::ptrdiff_t>(bins), histogram.counts.begin());
+    histogram.underflow = counts[bins];
+    histogram.overflow = counts[bins + 1];
+    histogram.hits = counts[bins + 2];
+    histogram.min_energy = extremes[0];
+    histogram.max_energy = -extremes[1];
+}
+
+TraceStatistics allreduce_traces(const std::vector<std::vector<double>> &traces, MPI_Comm comm) {
+    std::uint64_t steps = 0;
+    for (const auto &trace : traces) {
+        steps = std::max<std::uint64_t>(steps, trace.size());
+    }
+    MPI_Allreduce(MPI_IN_PLACE, &steps, 1, MPI_UINT64_T, MPI_MAX, comm);
+
+    std::vector<Moments> moments(static_cast<std::size_t>(steps),
+                                 Moments{0.0, 0.0, 0.0, std::numeric_limits<double>::infinity(),
+                                         -std::numeric_limits<double>::infinity()});
+    for (const auto &trace : traces) {
+        for (std::size_t t = 0; t < trace.size(); ++t) {
+            combine(Moments{1.0, trace[t], 0.0, trace[t], trace[t]}, moments[t]);
+        }
+    }
+
+    if (steps > 0) {
+        MPI_Datatype type;
+        MPI_Type_contiguous(5, MPI_DOUBLE, &type);
+        MPI_Type_commit(&type);
+        MPI_Op op;
+        MPI_Op_create(&combine_moments, 1, &op);
+        MPI_Allreduce(MPI_IN_PLACE, moments.data(), static_cast<int>(steps), type, op, comm);
+        MPI_Op_free(&op);
+        MPI_Type_free(&type);
+    }
+
+    TraceStatistics stats;
+    for (const auto &m : moments) {
+        stats.counts.push_back(static_cast<std::uint64_t>(m.count));
+        stats.mean.push_back(m.mean);
+        stats.stddev.push_back(m.count > 0.0 ? std::sqrt(m.m2 / m.count) : 0.0);
+        stats.min.push_back(m.min);
+        stats.max.push_back(m.max);
+    }
+    return stats;
+}
+
+void allreduce_sample_set(SampleSet &samples, MPI_Comm comm) {
+    require_same(std::vector<std::uint64_t>{samples.num_spins(), samples.capacity(), samples.zobrist().seed()},
+                 MPI_UINT64_T, comm, "Sample sets must share spin count, capacity and Zobrist seed on every rank.");
+    const std::size_t bytes = set_bytes(samples.num_spins(), samples.capacity());
+    if (bytes > static_cast<std::size_t>(INT_MAX)) {
+        throw std::invalid_argument("Sample set too large for one MPI reduction.");
+    }
+
+    std::vector<std::uint8_t> buffer(bytes, 0);
+    encode(samples, buffer.data());
+
+    MPI_Datatype type;
+    MPI_Type_contiguous(static_cast<int>(bytes), MPI_BYTE, &type);
+    MPI_Type_commit(&type);
+    MPI_Op op;
+    MPI_Op_create(&merge_sample_sets, 1, &op);
+    // Counts of states near the capacity cut can depend on the order of
+    // the merges, so reduce to one rank and broadcast rather than let each
+    // rank of an allreduce combine in its own order.
+    int rank = 0;
+    MPI_Comm_rank(comm, &rank);
+    std::vector<std::uint8_t> merged(rank == 0 ? bytes : 0);
+    MPI_Reduce(buffer.data(), merged.data(), 1, type, op, 0, comm);
+    if (rank == 0) {
+        buffer.swap(merged);
+    }
+    MPI_Bcast(buffer.data(), 1, type, 0, comm);
+    MPI_Op_free(&op);
+    MPI_Type_free(&type);
+
+    samples = decode(buffer.data());
+}
+
+} // namespace qanneal::mpi
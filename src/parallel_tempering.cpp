@@ -6,6 +6,12 @@
 
 namespace qanneal {
 
+namespace {
+
+constexpr const char *kCheckpointTag = "parallel_tempering";
+
+} // namespace
+
 ParallelTemperingAnnealer::ParallelTemperingAnnealer(const Hamiltonian &hamiltonian,
                                                      std::vector<double> betas)
     : backend_(make_backend(BackendKind::CPU, hamiltonian)),
@@ -33,9 +39,50 @@ void ParallelTemperingAnnealer::set_seed(std::uint64_t seed) {
     rng_.seed(seed);
 }
 
+void ParallelTemperingAnnealer::set_polish(PolishOptions options) {
+    polish_ = options;
+}
+
+void ParallelTemperingAnnealer::set_stop_criteria(StopCriteria criteria) {
+    stop_ = std::move(criteria);
+}
+
+void ParallelTemperingAnnealer::set_cluster_moves(ClusterMoveOptions options) {
+    if (options.interval == 0) {
+        throw std::invalid_argument("cluster move interval must be > 0.");
+    }
+    cluster_ = options;
+}
+
+void ParallelTemperingAnnealer::set_checkpoint(CheckpointOptions options) {
+    if (options.interval == 0) {
+        throw std::invalid_argument("checkpoint interval must be > 0.");
+    }
+    checkpoint_ = std::move(options);
+}
+
+void ParallelTemperingAnnealer::set_sample_set(std::shared_ptr<SampleSet> samples) {
+    samples_ = std::move(samples);
+}
+
 ParallelTemperingResult ParallelTemperingAnnealer::run(std::size_t sweeps_per_step,
                                                        std::size_t steps,
                                                        std::size_t swap_interval) {
+    return run_from(sweeps_per_step, steps, swap_interval, nullptr);
+}
+
+ParallelTemperingResult ParallelTemperingAnnealer::resume(const std::string &path,
+                                                          std::size_t sweeps_per_step,
+                                                          std::size_t steps,
+                                                          std::size_t swap_interval) {
+    CheckpointReader reader(path, kCheckpointTag);
+    return run_from(sweeps_per_step, steps, swap_interval, &reader);
+}
+
+ParallelTemperingResult ParallelTemperingAnnealer::run_from(std::size_t sweeps_per_step,
+                                                            std::size_t steps,
+                                                            std::size_t swap_interval,
+                                                            CheckpointReader *reader) {
     if (sweeps_per_step == 0) {
         throw std::invalid_argument("sweeps_per_step must be > 0.");
     }
@@ -47,7 +94,15 @@ ParallelTemperingResult ParallelTemperingAnnealer::run(std::size_t sweeps_per_st
     }
 
     const std::size_t n = backend_->size();
-    const std::size_t replicas = betas_.size();
+    const std::size_t temperatures = betas_.size();
+    const std::size_t copies = cluster_.houdayer ? 2 : 1;
+    const std::size_t replicas = temperatures * copies;
+    const bool use_clusters = cluster_.houdayer || cluster_.update != ClusterUpdate::None;
+
+    ClusterWorkspace workspace;
+    if (use_clusters) {
+        workspace = ClusterWorkspace(require_hamiltonian(*backend_).coupling_graph());
+    }
 
     std::vector<State> states;
     states.reserve(replicas);
@@ -64,48 +119,154 @@ ParallelTemperingResult ParallelTemperingAnnealer::run(std::size_t sweeps_per_st
     result.best_energy = std::numeric_limits<double>::infinity();
     result.average_energy_trace.reserve(steps);
     result.swap_acceptance_trace.reserve(steps);
+    result.cluster_size_trace.reserve(steps);
 
     std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    StopMonitor monitor(stop_);
+    std::size_t first_step = 0;
+
+    if (reader) {
+        if (reader->read_size() != sweeps_per_step || reader->read_size() != steps ||
+            reader->read_size() != swap_interval || reader->read_doubles() != betas_) {
+            throw std::invalid_argument("Checkpoint was written for different run parameters.");
+        }
+        first_step = reader->read_size();
+        reader->read_rng(rng_);
+        states = reader->read_states();
+        energies = reader->read_doubles();
+        if (states.size() != replicas || energies.size() != replicas) {
+            throw std::invalid_argument("Checkpoint replica count does not match the cluster options.");
+        }
+        result.best_state = reader->read_state();
+        result.best_energy = reader->read_f64();
+        result.average_energy_trace = reader->read_doubles();
+        result.swap_acceptance_trace = reader->read_doubles();
+        result.cluster_size_trace = reader->read_doubles();
+        reader->read_monitor(monitor);
+        reader->finish();
+    }
+    instrumentation::reset();
+    instrumentation::skip_steps(result.step_counters, first_step);
 
-    for (std::size_t step = 0; step < steps; ++step) {
+    // Zobrist hash per replica, kept current flip by flip while sampling.
+    // Cluster moves flip many spins at once and rehash their replicas.
+    SampleSet *samples = samples_.get();
+    const std::uint64_t *keys = nullptr;
+    std::vector<std::uint64_t> hashes(replicas, 0);
+    auto rehash = [&](std::size_t r) {
+        if (samples) {
+            hashes[r] = samples->zobrist().hash(states[r]);
+        }
+    };
+    if (samples) {
+        if (samples->num_spins() != n) {
+            throw std::invalid_argument("Sample set size does not match the problem.");
+        }
+        keys = samples->zobrist().keys();
         for (std::size_t r = 0; r < replicas; ++r) {
-            const double beta = betas_[r];
+            rehash(r);
+        }
+    }
+
+    for (std::size_t step = first_step; step < steps && !monitor.stopped(); ++step) {
+        instrumentation::PhaseTimer timer;
+        std::size_t flips_attempted = 0;
+        std::size_t flips_accepted = 0;
+        for (std::size_t r = 0; r < replicas && !monitor.stopped(); ++r) {
+            const double beta = betas_[r % temperatures];
             auto &state = states[r];
             double energy = energies[r];
+            std::uint64_t hash = hashes[r];
             for (std::size_t sweep = 0; sweep < sweeps_per_step; ++sweep) {
                 for (std::size_t i = 0; i < n; ++i) {
                     const double delta = backend_->delta_energy(state.spins.data(), state.size(), i);
                     if (delta <= 0.0 || uniform(rng_) < std::exp(-beta * delta)) {
                         state[i] = static_cast<int8_t>(-state[i]);
                         energy += delta;
+                        ++flips_accepted;
+                        if (keys) {
+                            hash ^= keys[i];
+                        }
                     }
                 }
+                if (samples) {
+                    samples->add(state.spins.data(), energy, hash);
+                }
+                flips_attempted += n;
+                if (monitor.record(1, energy)) {
+                    break;
+                }
             }
             energies[r] = energy;
-            if (energy < result.best_energy) {
-                result.best_energy = energy;
-                result.best_state = state;
+            hashes[r] = hash;
+        }
+        instrumentation::add(&StepCounters::attempted_flips, flips_attempted);
+        instrumentation::add(&StepCounters::accepted_flips, flips_accepted);
+
+        double cluster_spins = 0.0;
+        double cluster_moves = 0.0;
+        if (use_clusters && !monitor.stopped() && (step + 1) % cluster_.interval == 0) {
+            if (cluster_.update != ClusterUpdate::None) {
+                for (std::size_t r = 0; r < replicas; ++r) {
+                    const double beta = betas_[r % temperatures];
+                    const std::size_t flipped = (cluster_.update == ClusterUpdate::Wolff)
+                        ? workspace.wolff_update(states[r], beta, energies[r], rng_)
+                        : workspace.swendsen_wang_update(states[r], beta, energies[r], rng_);
+                    cluster_spins += static_cast<double>(flipped);
+                    ++cluster_moves;
+                    rehash(r);
+                }
+            }
+            if (cluster_.houdayer) {
+                for (std::size_t t = 0; t < temperatures; ++t) {
+                    if (betas_[t] < cluster_.houdayer_beta_min) {
+                        continue;
+                    }
+                    const std::size_t a = t;
+                    const std::size_t b = temperatures + t;
+                    cluster_spins += static_cast<double>(
+                        workspace.houdayer_move(states[a], states[b], energies[a], energies[b], rng_));
+                    ++cluster_moves;
+                    rehash(a);
+                    rehash(b);
+                }
+            }
+        }
+
+        for (std::size_t r = 0; r < replicas; ++r) {
+            if (energies[r] < result.best_energy) {
+                result.best_energy = energies[r];
+                result.best_state = states[r];
             }
         }
 
         double accepted = 0.0;
         double attempted = 0.0;
-        if ((step + 1) % swap_interval == 0) {
-            for (std::size_t r = 0; r + 1 < replicas; ++r) {
-                const double beta_i = betas_[r];
-                const double beta_j = betas_[r + 1];
-                const double e_i = energies[r];
-                const double e_j = energies[r + 1];
-                const double delta = (beta_i - beta_j) * (e_j - e_i);
-                ++attempted;
-                if (delta <= 0.0 || uniform(rng_) < std::exp(-delta)) {
-                    std::swap(states[r], states[r + 1]);
-                    std::swap(energies[r], energies[r + 1]);
-                    ++accepted;
+        if (!monitor.stopped() && (step + 1) % swap_interval == 0) {
+            for (std::size_t c = 0; c < copies; ++c) {
+                const std::size_t base = c * temperatures;
+                for (std::size_t t = 0; t + 1 < temperatures; ++t) {
+                    const std::size_t r = base + t;
+                    const double beta_i = betas_[t];
+                    const double beta_j = betas_[t + 1];
+                    const double e_i = energies[r];
+                    const double e_j = energies[r + 1];
+                    const double delta = (beta_i - beta_j) * (e_j - e_i);
+                    ++attempted;
+                    if (delta <= 0.0 || uniform(rng_) < std::exp(-delta)) {
+                        std::swap(states[r], states[r + 1]);
+                        std::swap(energies[r], energies[r + 1]);
+                        std::swap(hashes[r], hashes[r + 1]);
+                        ++accepted;
+                    }
                 }
             }
         }
 
+        instrumentation::add(&StepCounters::swap_attempts, static_cast<std::uint64_t>(attempted));
+        instrumentation::add(&StepCounters::swap_accepts, static_cast<std::uint64_t>(accepted));
+        timer.end_sweeps();
+
         double avg_energy = 0.0;
         for (double e : energies) {
             avg_energy += e;
@@ -113,6 +274,46 @@ ParallelTemperingResult ParallelTemperingAnnealer::run(std::size_t sweeps_per_st
         avg_energy /= static_cast<double>(replicas);
         result.average_energy_trace.push_back(avg_energy);
         result.swap_acceptance_trace.push_back(attempted > 0.0 ? (accepted / attempted) : 0.0);
+        result.cluster_size_trace.push_back(cluster_moves > 0.0 ? (cluster_spins / cluster_moves) : 0.0);
+        instrumentation::finish_step(result.step_counters);
+
+        if (!checkpoint_.path.empty() && !monitor.stopped() &&
+            (step + 1) % checkpoint_.interval == 0) {
+            CheckpointWriter writer(kCheckpointTag);
+            writer.write_size(sweeps_per_step);
+            writer.write_size(steps);
+            writer.write_size(swap_interval);
+            writer.write_doubles(betas_);
+            writer.write_size(step + 1);
+            writer.write_rng(rng_);
+            writer.write_states(states);
+            writer.write_doubles(energies);
+            writer.write_state(result.best_state);
+            writer.write_f64(result.best_energy);
+            writer.write_doubles(result.average_energy_trace);
+            writer.write_doubles(result.swap_acceptance_trace);
+            writer.write_doubles(result.cluster_size_trace);
+            writer.write_monitor(monitor);
+            writer.commit(checkpoint_.path);
+        }
+    }
+
+    result.stop_reason = monitor.reason();
+    result.sweeps = monitor.sweeps();
+
+    if (polish_.mode != PolishMode::None) {
+        LocalSearch search(require_hamiltonian(*backend_).coupling_graph());
+        states.push_back(result.best_state);
+        energies.push_back(result.best_energy);
+        search.polish_all(states, energies, polish_);
+        for (std::size_t r = 0; r < states.size(); ++r) {
+            if (energies[r] < result.best_energy) {
+                result.best_energy = energies[r];
+                result.best_state = states[r];
+            }
+        }
+        states.pop_back();
+        energies.pop_back();
     }
 
     result.final_states = states;
@@ -0,0 +1,162 @@
+#include "qanneal/perf_counters.hpp"
+
+#if defined(__linux__) && __has_include(<linux/perf_event.h>)
+#define QANNEAL_HAVE_PERF_EVENT 1
+#include <cerrno>
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#else
+#define QANNEAL_HAVE_PERF_EVENT 0
+#endif
+
+namespace qanneal {
+
+namespace {
+
+#if QANNEAL_HAVE_PERF_EVENT
+
+struct EventSpec {
+    const char *name;
+    std::uint32_t type;
+    std::uint64_t config;
+    // Generic event tried when `config` is not supported.
+    std::uint64_t fallback;
+};
+
+constexpr std::uint64_t kLLCReadMiss = PERF_COUNT_HW_CACHE_LL |
+                                       (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                       (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+
+const EventSpec kSpecs[] = {
+    {"cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_CPU_CYCLES},
+    {"instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_INSTRUCTIONS},
+    {"llc_misses", PERF_TYPE_HW_CACHE, kLLCReadMiss, PERF_COUNT_HW_CACHE_MISSES},
+    {"branch_misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES, PERF_COUNT_HW_BRANCH_MISSES},
+};
+
+// Opens a group leader when `group` is -1, otherwise a member of that
+// group. Members are scheduled on the PMU together with the leader, so
+// every event counts over the same intervals.
+int open_event(std::uint32_t type, std::uint64_t config, int group) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    // One read of the leader returns every member's count, with the
+    // group's enabled and running times to scale multiplexed counts.
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, group, 0));
+}
+
+#endif
+
+} // namespace
+
+PerfCounters::PerfCounters() {
+    fds_.fill(-1);
+    slots_.fill(-1);
+#if QANNEAL_HAVE_PERF_EVENT
+    std::string failed;
+    int first_errno = 0;
+    int members = 0;
+    // Cycles leads the group; if it cannot be opened the first event that
+    // can leads instead.
+    for (std::size_t k = 0; k < kEvents; ++k) {
+        const auto &spec = kSpecs[k];
+        const int group = leader_ >= 0 ? fds_[static_cast<std::size_t>(leader_)] : -1;
+        int fd = open_event(spec.type, spec.config, group);
+        if (fd < 0 && spec.type != PERF_TYPE_HARDWARE) {
+            fd = open_event(PERF_TYPE_HARDWARE, spec.fallback, group);
+        }
+        if (fd < 0) {
+            if (first_errno == 0) {
+                first_errno = errno;
+            }
+            failed += failed.empty() ? spec.name : std::string(", ") + spec.name;
+            continue;
+        }
+        if (leader_ < 0) {
+            leader_ = static_cast<int>(k);
+        }
+        fds_[k] = fd;
+        slots_[k] = members++;
+    }
+    if (failed.empty()) {
+        status_ = "ok";
+    } else {
+        status_ = (available() ? "partial, missing " : "unavailable, missing ") + failed + ": " +
+                  std::strerror(first_errno);
+        if (first_errno == EACCES || first_errno == EPERM) {
+            status_ += " (check /proc/sys/kernel/perf_event_paranoid)";
+        }
+    }
+#else
+    status_ = "unavailable: perf_event_open requires Linux";
+#endif
+}
+
+PerfCounters::~PerfCounters() {
+#if QANNEAL_HAVE_PERF_EVENT
+    for (int fd : fds_) {
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+#endif
+}
+
+bool PerfCounters::available() const {
+    return leader_ >= 0;
+}
+
+PerfCounts PerfCounters::read() const {
+    std::array<std::int64_t, kEvents> values;
+    values.fill(-1);
+#if QANNEAL_HAVE_PERF_EVENT
+    if (leader_ >= 0) {
+        // Members, time enabled, time running, then one value per member
+        // in the order they joined.
+        std::uint64_t data[3 + kEvents] = {};
+        const ssize_t got = ::read(fds_[static_cast<std::size_t>(leader_)], data, sizeof(data));
+        if (got >= static_cast<ssize_t>(3 * sizeof(std::uint64_t))) {
+            // The group is scheduled as a whole, so one ratio scales all.
+            double scale = 1.0;
+            if (data[2] > 0 && data[2] < data[1]) {
+                scale = static_cast<double>(data[1]) / static_cast<double>(data[2]);
+            }
+            for (std::size_t k = 0; k < kEvents; ++k) {
+                const int slot = slots_[k];
+                if (slot >= 0 && static_cast<std::uint64_t>(slot) < data[0] &&
+                    got >= static_cast<ssize_t>((4 + static_cast<std::size_t>(slot)) * sizeof(std::uint64_t))) {
+                    values[k] = static_cast<std::int64_t>(static_cast<double>(data[3 + slot]) * scale);
+                }
+            }
+        }
+    }
+#endif
+    PerfCounts counts;
+    counts.cycles = values[0];
+    counts.instructions = values[1];
+    counts.llc_misses = values[2];
+    counts.branch_misses = values[3];
+    return counts;
+}
+
+PerfCounts PerfCounters::difference(const PerfCounts &a, const PerfCounts &b) {
+    auto diff = [](std::int64_t x, std::int64_t y) -> std::int64_t {
+        return (x < 0 || y < 0) ? -1 : x - y;
+    };
+    PerfCounts out;
+    out.cycles = diff(a.cycles, b.cycles);
+    out.instructions = diff(a.instructions, b.instructions);
+    out.llc_misses = diff(a.llc_misses, b.llc_misses);
+    out.branch_misses = diff(a.branch_misses, b.branch_misses);
+    return out;
+}
+
+}
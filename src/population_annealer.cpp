@@ -0,0 +1,271 @@
+#include "qanneal/population_annealer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace qanneal {
+
+PopulationAnnealer::PopulationAnnealer(const Hamiltonian &hamiltonian,
+                                       AnnealSchedule schedule,
+                                       std::size_t population)
+    : backend_(make_backend(BackendKind::CPU, hamiltonian)),
+      schedule_(std::move(schedule)),
+      population_(population),
+      rng_(std::random_device{}()) {
+    schedule_.validate();
+    if (population_ == 0) {
+        throw std::invalid_argument("population must be > 0.");
+    }
+}
+
+PopulationAnnealer::PopulationAnnealer(std::shared_ptr<Backend> backend,
+                                       AnnealSchedule schedule,
+                                       std::size_t population)
+    : backend_(std::move(backend)),
+      schedule_(std::move(schedule)),
+      population_(population),
+      rng_(std::random_device{}()) {
+    if (!backend_) {
+        throw std::invalid_argument("PopulationAnnealer requires a backend.");
+    }
+    schedule_.validate();
+    if (population_ == 0) {
+        throw std::invalid_argument("population must be > 0.");
+    }
+}
+
+void PopulationAnnealer::set_seed(std::uint64_t seed) {
+    rng_.seed(seed);
+}
+
+void PopulationAnnealer::set_polish(PolishOptions options) {
+    polish_ = options;
+}
+
+void PopulationAnnealer::set_stop_criteria(StopCriteria criteria) {
+    stop_ = std::move(criteria);
+}
+
+void PopulationAnnealer::set_sample_set(std::shared_ptr<SampleSet> samples) {
+    samples_ = std::move(samples);
+}
+
+PopulationAnnealResult PopulationAnnealer::run(std::size_t sweeps_per_beta) {
+    if (sweeps_per_beta == 0) {
+        throw std::invalid_argument("sweeps_per_beta must be > 0.");
+    }
+
+    const std::size_t n = backend_->size();
+    const std::size_t R = population_;
+
+    // Each replica owns its generator so the sweeps can run on any thread
+    // without changing the random stream a replica sees.
+    std::vector<std::mt19937_64> rngs;
+    rngs.reserve(R);
+    for (std::size_t r = 0; r < R; ++r) {
+        rngs.emplace_back(rng_());
+    }
+
+    // Two population buffers: resampling copies survivors from `states` into
+    // `scratch` and swaps the vectors, so spin storage is allocated only once.
+    std::vector<State> states;
+    std::vector<State> scratch(R, State(n));
+    states.reserve(R);
+    std::vector<double> energies(R, 0.0);
+    std::vector<double> scratch_energies(R, 0.0);
+    std::vector<std::size_t> families(R);
+    std::vector<std::size_t> scratch_families(R);
+    std::vector<double> weights(R, 0.0);
+    std::vector<std::size_t> family_sizes(R, 0);
+
+    for (std::size_t r = 0; r < R; ++r) {
+        states.push_back(State::random(n, rngs[r]));
+        energies[r] = backend_->energy(states[r].spins.data(), states[r].size());
+        families[r] = r;
+    }
+
+    PopulationAnnealResult result;
+    result.best_energy = std::numeric_limits<double>::infinity();
+    result.average_energy_trace.reserve(schedule_.size());
+    result.free_energy_trace.reserve(schedule_.size());
+    result.family_count_trace.reserve(schedule_.size());
+
+    // Uniformly random spins sample beta = 0, where ln Z = n ln 2.
+    double log_z = static_cast<double>(n) * std::log(2.0);
+    double prev_beta = 0.0;
+
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    StopMonitor monitor(stop_);
+    instrumentation::reset();
+
+    // Zobrist hash per replica, kept current flip by flip while sampling and
+    // carried along by resampling.
+    SampleSet *samples = samples_.get();
+    const std::uint64_t *keys = nullptr;
+    std::vector<std::uint64_t> hashes;
+    std::vector<std::uint64_t> scratch_hashes;
+    if (samples) {
+        if (samples->num_spins() != n) {
+            throw std::invalid_argument("Sample set size does not match the problem.");
+        }
+        keys = samples->zobrist().keys();
+        hashes.resize(R);
+        scratch_hashes.resize(R);
+        for (std::size_t r = 0; r < R; ++r) {
+            hashes[r] = samples->zobrist().hash(states[r]);
+        }
+    }
+
+    for (std::size_t step = 0; step < schedule_.betas.size() && !monitor.stopped(); ++step) {
+        const double beta = schedule_.betas[step];
+        const double dbeta = beta - prev_beta;
+        const std::size_t sweeps = schedule_.sweeps_at(step, sweeps_per_beta);
+
+        if (dbeta != 0.0) {
+            // Reweight by exp(-dbeta * E), shifted by the lowest energy to
+            // keep the weights finite.
+            const double e_min = *std::min_element(energies.begin(), energies.end());
+            double weight_sum = 0.0;
+            for (std::size_t r = 0; r < R; ++r) {
+                weights[r] = std::exp(-dbeta * (energies[r] - e_min));
+                weight_sum += weights[r];
+            }
+            log_z += -dbeta * e_min + std::log(weight_sum / static_cast<double>(R));
+
+            // Systematic resampling keeps the population at exactly R, which
+            // is what lets the buffers be reused step after step.
+            const double spacing = weight_sum / static_cast<double>(R);
+            double position = uniform(rng_) * spacing;
+            double cumulative = weights[0];
+            std::size_t src = 0;
+            for (std::size_t r = 0; r < R; ++r) {
+                while (cumulative < position && src + 1 < R) {
+                    ++src;
+                    cumulative += weights[src];
+                }
+                std::copy(states[src].spins.begin(), states[src].spins.end(),
+                          scratch[r].spins.begin());
+                scratch_energies[r] = energies[src];
+                scratch_families[r] = families[src];
+                if (samples) {
+                    scratch_hashes[r] = hashes[src];
+                }
+                position += spacing;
+            }
+            std::swap(states, scratch);
+            std::swap(energies, scratch_energies);
+            std::swap(families, scratch_families);
+            std::swap(hashes, scratch_hashes);
+        }
+        prev_beta = beta;
+
+        // Started after resampling so that sweep_ns (and the hardware
+        // counts) cover the sweeps alone, as in the other engines.
+        instrumentation::PhaseTimer timer;
+        const auto replicas = static_cast<std::ptrdiff_t>(R);
+        // Each thread counts into its own StepCounters and merges them once
+        // the replicas are done.
+        StepCounters workers;
+#pragma omp parallel
+        {
+#pragma omp for schedule(static)
+            for (std::ptrdiff_t idx = 0; idx < replicas; ++idx) {
+                const auto r = static_cast<std::size_t>(idx);
+                std::uniform_real_distribution<double> local_uniform(0.0, 1.0);
+                auto &state = states[r];
+                auto &gen = rngs[r];
+                double energy = energies[r];
+                std::uint64_t hash = samples ? hashes[r] : 0;
+                std::size_t accepted = 0;
+                for (std::size_t sweep = 0; sweep < sweeps; ++sweep) {
+                    for (std::size_t i = 0; i < n; ++i) {
+                        const double delta = backend_->delta_energy(state.spins.data(), state.size(), i);
+                        if (delta <= 0.0 || local_uniform(gen) < std::exp(-beta * delta)) {
+                            state[i] = static_cast<int8_t>(-state[i]);
+                            energy += delta;
+                            ++accepted;
+                            if (keys) {
+                                hash ^= keys[i];
+                            }
+                        }
+                    }
+                }
+                energies[r] = energy;
+                if (samples) {
+                    hashes[r] = hash;
+                }
+                instrumentation::add(&StepCounters::attempted_flips, sweeps * n);
+                instrumentation::add(&StepCounters::accepted_flips, accepted);
+            }
+            instrumentation::merge_local(workers);
+        }
+        instrumentation::add(workers);
+        timer.end_sweeps();
+
+        double avg_energy = 0.0;
+        for (std::size_t r = 0; r < R; ++r) {
+            if (samples) {
+                samples->add(states[r].spins.data(), energies[r], hashes[r]);
+            }
+            avg_energy += energies[r];
+            if (energies[r] < result.best_energy) {
+                result.best_energy = energies[r];
+                result.best_state = states[r];
+            }
+        }
+        avg_energy /= static_cast<double>(R);
+        result.average_energy_trace.push_back(avg_energy);
+        result.free_energy_trace.push_back(beta != 0.0 ? -log_z / beta : 0.0);
+
+        std::fill(family_sizes.begin(), family_sizes.end(), 0);
+        std::size_t surviving = 0;
+        for (std::size_t r = 0; r < R; ++r) {
+            if (family_sizes[families[r]]++ == 0) {
+                ++surviving;
+            }
+        }
+        result.family_count_trace.push_back(surviving);
+        instrumentation::finish_step(result.step_counters);
+
+        // Sweeps run in parallel, so stop conditions are checked per step.
+        monitor.record(R * sweeps, result.best_energy);
+    }
+
+    double sum_sq = 0.0;
+    double entropy = 0.0;
+    for (std::size_t f = 0; f < R; ++f) {
+        if (family_sizes[f] == 0) {
+            continue;
+        }
+        const double frac = static_cast<double>(family_sizes[f]) / static_cast<double>(R);
+        sum_sq += frac * frac;
+        entropy -= frac * std::log(frac);
+    }
+
+    result.stop_reason = monitor.reason();
+    result.sweeps = monitor.sweeps();
+    result.log_partition = log_z;
+    result.surviving_families = result.family_count_trace.back();
+    result.mean_square_family_size = static_cast<double>(R) * sum_sq;
+    result.entropic_family_size = static_cast<double>(R) / std::exp(entropy);
+
+    if (polish_.mode != PolishMode::None) {
+        LocalSearch search(require_hamiltonian(*backend_).coupling_graph());
+        search.polish_all(states, energies, polish_);
+        for (std::size_t r = 0; r < R; ++r) {
+            if (energies[r] < result.best_energy) {
+                result.best_energy = energies[r];
+                result.best_state = states[r];
+            }
+        }
+    }
+
+    result.final_states = states;
+    result.final_energies = energies;
+
+    return result;
+}
+
+} // namespace qanneal
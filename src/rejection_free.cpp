@@ -0,0 +1,127 @@
+#include "qanneal/rejection_free.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace qanneal {
+
+RateTree::RateTree(std::size_t n)
+    : rates_(n, 0.0), tree_(n + 1, 0.0) {
+    top_bit_ = 1;
+    while (top_bit_ * 2 <= n) {
+        top_bit_ *= 2;
+    }
+}
+
+void RateTree::set(std::size_t idx, double rate) {
+    const double diff = rate - rates_[idx];
+    rates_[idx] = rate;
+    total_ += diff;
+    for (std::size_t k = idx + 1; k < tree_.size(); k += k & (~k + 1)) {
+        tree_[k] += diff;
+    }
+}
+
+void RateTree::rebuild() {
+    // Linear-time construction; also clears the rounding drift accumulated by
+    // incremental updates.
+    std::fill(tree_.begin(), tree_.end(), 0.0);
+    total_ = 0.0;
+    for (std::size_t k = 1; k < tree_.size(); ++k) {
+        tree_[k] += rates_[k - 1];
+        total_ += rates_[k - 1];
+        const std::size_t parent = k + (k & (~k + 1));
+        if (parent < tree_.size()) {
+            tree_[parent] += tree_[k];
+        }
+    }
+}
+
+std::size_t RateTree::sample(double u) const {
+    std::size_t pos = 0;
+    for (std::size_t bit = top_bit_; bit != 0; bit >>= 1) {
+        const std::size_t next = pos + bit;
+        if (next < tree_.size() && tree_[next] <= u) {
+            pos = next;
+            u -= tree_[next];
+        }
+    }
+    // Rounding can push u past the last non-zero rate; fall back to it.
+    std::size_t idx = std::min(pos, rates_.size() - 1);
+    while (idx > 0 && rates_[idx] == 0.0) {
+        --idx;
+    }
+    return idx;
+}
+
+RejectionFreeSampler::RejectionFreeSampler(CouplingGraph graph)
+    : graph_(std::move(graph)),
+      fields_(graph_.size(), 0.0),
+      tree_(graph_.size()) {
+    if (graph_.offsets.size() != graph_.size() + 1) {
+        throw std::invalid_argument("CouplingGraph offsets size mismatch.");
+    }
+}
+
+double RejectionFreeSampler::rate_of(std::size_t idx, int8_t spin) const {
+    const double delta = -2.0 * static_cast<double>(spin) * fields_[idx];
+    return delta <= 0.0 ? 1.0 : std::exp(-beta_ * delta);
+}
+
+void RejectionFreeSampler::reset(const State &state, double beta) {
+    const std::size_t n = size();
+    if (state.size() != n) {
+        throw std::invalid_argument("State size mismatch.");
+    }
+    beta_ = beta;
+    for (std::size_t i = 0; i < n; ++i) {
+        double field = graph_.h[i];
+        for (std::size_t e = graph_.offsets[i]; e < graph_.offsets[i + 1]; ++e) {
+            field += graph_.weights[e] * static_cast<double>(state[graph_.neighbors[e]]);
+        }
+        fields_[i] = field;
+    }
+    for (std::size_t i = 0; i < n; ++i) {
+        tree_.assign(i, rate_of(i, state[i]));
+    }
+    tree_.rebuild();
+}
+
+double RejectionFreeSampler::step(State &state,
+                                  double &energy,
+                                  double time_left,
+                                  std::mt19937_64 &rng,
+                                  std::size_t &flipped) {
+    flipped = size();
+    const double total = tree_.total();
+    if (!(total > 0.0)) {
+        return std::numeric_limits<double>::infinity();
+    }
+
+    // Time is measured in sweeps: random-site Metropolis accepts with
+    // probability total / n per attempt and spends 1 / n sweep per attempt.
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    const double wait = -std::log1p(-uniform(rng)) / total;
+    if (wait > time_left) {
+        return wait;
+    }
+
+    const std::size_t k = tree_.sample(uniform(rng) * total);
+    const int8_t old_spin = state[k];
+    energy += -2.0 * static_cast<double>(old_spin) * fields_[k];
+    state[k] = static_cast<int8_t>(-old_spin);
+    flipped = k;
+
+    const double change = -2.0 * static_cast<double>(old_spin);
+    for (std::size_t e = graph_.offsets[k]; e < graph_.offsets[k + 1]; ++e) {
+        const std::size_t j = graph_.neighbors[e];
+        fields_[j] += graph_.weights[e] * change;
+        tree_.set(j, rate_of(j, state[j]));
+    }
+    tree_.set(k, rate_of(k, state[k]));
+    return wait;
+}
+
+} // namespace qanneal
@@ -1,11 +1,19 @@
 #include "qanneal/replica_annealer.hpp"
 
+#include "qanneal/flip_journal.hpp"
+
 #include <cmath>
 #include <limits>
 #include <stdexcept>
 
 namespace qanneal {
 
+namespace {
+
+constexpr const char *kCheckpointTag = "replica_annealer";
+
+} // namespace
+
 ReplicaAnnealer::ReplicaAnnealer(const Hamiltonian &hamiltonian,
                                  AnnealSchedule schedule,
                                  std::size_t replicas)
@@ -13,9 +21,7 @@ ReplicaAnnealer::ReplicaAnnealer(const Hamiltonian &hamiltonian,
       schedule_(std::move(schedule)),
       replicas_(replicas),
       rng_(std::random_device{}()) {
-    if (schedule_.betas.empty()) {
-        throw std::invalid_argument("Schedule must contain at least one beta.");
-    }
+    schedule_.validate();
     if (replicas_ == 0) {
         throw std::invalid_argument("replicas must be > 0.");
     }
@@ -31,9 +37,7 @@ ReplicaAnnealer::ReplicaAnnealer(std::shared_ptr<Backend> backend,
     if (!backend_) {
         throw std::invalid_argument("ReplicaAnnealer requires a backend.");
     }
-    if (schedule_.betas.empty()) {
-        throw std::invalid_argument("Schedule must contain at least one beta.");
-    }
+    schedule_.validate();
     if (replicas_ == 0) {
         throw std::invalid_argument("replicas must be > 0.");
     }
@@ -43,7 +47,43 @@ void ReplicaAnnealer::set_seed(std::uint64_t seed) {
     rng_.seed(seed);
 }
 
+void ReplicaAnnealer::set_polish(PolishOptions options) {
+    polish_ = options;
+}
+
+void ReplicaAnnealer::set_stop_criteria(StopCriteria criteria) {
+    stop_ = std::move(criteria);
+}
+
+void ReplicaAnnealer::set_checkpoint(CheckpointOptions options) {
+    if (options.interval == 0) {
+        throw std::invalid_argument("checkpoint interval must be > 0.");
+    }
+    checkpoint_ = std::move(options);
+}
+
+void ReplicaAnnealer::set_sample_set(std::shared_ptr<SampleSet> samples) {
+    samples_ = std::move(samples);
+}
+
+void ReplicaAnnealer::set_migration(std::size_t interval, MigrationHook hook) {
+    if (interval == 0) {
+        throw std::invalid_argument("migration interval must be > 0.");
+    }
+    migration_interval_ = interval;
+    migration_ = std::move(hook);
+}
+
 MultiAnnealResult ReplicaAnnealer::run(std::size_t sweeps_per_beta) {
+    return run_from(sweeps_per_beta, nullptr);
+}
+
+MultiAnnealResult ReplicaAnnealer::resume(const std::string &path, std::size_t sweeps_per_beta) {
+    CheckpointReader reader(path, kCheckpointTag);
+    return run_from(sweeps_per_beta, &reader);
+}
+
+MultiAnnealResult ReplicaAnnealer::run_from(std::size_t sweeps_per_beta, CheckpointReader *reader) {
     if (sweeps_per_beta == 0) {
         throw std::invalid_argument("sweeps_per_beta must be > 0.");
     }
@@ -77,32 +117,110 @@ MultiAnnealResult ReplicaAnnealer::run(std::size_t sweeps_per_beta) {
     }
 
     std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    StopMonitor monitor(stop_);
+    std::size_t first_step = 0;
+    FlipJournal journal;
+    journal.reserve(n);
 
-    for (std::size_t step = 0; step < schedule_.betas.size(); ++step) {
-        const double beta = schedule_.betas[step];
+    if (reader) {
+        if (reader->read_size() != sweeps_per_beta || reader->read_doubles() != schedule_.betas) {
+            throw std::invalid_argument("Checkpoint was written for a different schedule.");
+        }
+        first_step = reader->read_size();
+        reader->read_rng(rng_);
+        states = reader->read_states();
+        energies = reader->read_doubles();
+        if (states.size() != replicas_ || energies.size() != replicas_) {
+            throw std::invalid_argument("Checkpoint replica count does not match.");
+        }
+        for (auto &replica : result.replicas) {
+            replica.best_state = reader->read_state();
+            replica.best_energy = reader->read_f64();
+            replica.energy_trace = reader->read_doubles();
+            replica.magnetization_trace = reader->read_doubles();
+        }
+        result.global_best_state = reader->read_state();
+        result.global_best_energy = reader->read_f64();
+        result.average_energy_trace = reader->read_doubles();
+        result.average_magnetization_trace = reader->read_doubles();
+        reader->read_monitor(monitor);
+        reader->finish();
+    }
+    instrumentation::reset();
+    instrumentation::skip_steps(result.step_counters, first_step);
 
+    // Zobrist hash per replica, kept current flip by flip while sampling.
+    SampleSet *samples = samples_.get();
+    const std::uint64_t *keys = nullptr;
+    std::vector<std::uint64_t> hashes(replicas_, 0);
+    if (samples) {
+        if (samples->num_spins() != n) {
+            throw std::invalid_argument("Sample set size does not match the problem.");
+        }
+        keys = samples->zobrist().keys();
         for (std::size_t r = 0; r < replicas_; ++r) {
+            hashes[r] = samples->zobrist().hash(states[r]);
+        }
+    }
+
+    for (std::size_t step = first_step; step < schedule_.betas.size() && !monitor.stopped(); ++step) {
+        const double beta = schedule_.betas[step];
+        const std::size_t sweeps = schedule_.sweeps_at(step, sweeps_per_beta);
+        instrumentation::PhaseTimer timer;
+        std::size_t attempted = 0;
+        std::size_t accepted = 0;
+
+        for (std::size_t r = 0; r < replicas_ && !monitor.stopped(); ++r) {
             auto &state = states[r];
             double energy = energies[r];
-            for (std::size_t sweep = 0; sweep < sweeps_per_beta; ++sweep) {
+            auto &replica = result.replicas[r];
+            std::uint64_t hash = hashes[r];
+            for (std::size_t sweep = 0; sweep < sweeps; ++sweep) {
+                bool global_improved = false;
                 for (std::size_t i = 0; i < n; ++i) {
                     const double delta = backend_->delta_energy(state.spins.data(), state.size(), i);
                     if (delta <= 0.0 || uniform(rng_) < std::exp(-beta * delta)) {
                         state[i] = static_cast<int8_t>(-state[i]);
                         energy += delta;
-                        if (energy < result.replicas[r].best_energy) {
-                            result.replicas[r].best_energy = energy;
-                            result.replicas[r].best_state = state;
+                        ++accepted;
+                        journal.record(i);
+                        if (keys) {
+                            hash ^= keys[i];
+                        }
+                        if (energy < replica.best_energy) {
+                            replica.best_energy = energy;
+                            journal.mark_best();
                         }
                         if (energy < result.global_best_energy) {
                             result.global_best_energy = energy;
-                            result.global_best_state = state;
+                            global_improved = true;
                         }
                     }
                 }
+                // A global improvement is also a replica improvement, and
+                // every later replica improvement in the sweep is global too,
+                // so both bests sit at the journal's last mark.
+                if (journal.has_best()) {
+                    journal.rebuild_best(state, replica.best_state);
+                    if (global_improved) {
+                        result.global_best_state = replica.best_state;
+                    }
+                }
+                journal.clear();
+                if (samples) {
+                    samples->add(state.spins.data(), energy, hash);
+                }
+                attempted += n;
+                if (monitor.record(1, result.global_best_energy)) {
+                    break;
+                }
             }
             energies[r] = energy;
+            hashes[r] = hash;
         }
+        instrumentation::add(&StepCounters::attempted_flips, attempted);
+        instrumentation::add(&StepCounters::accepted_flips, accepted);
+        timer.end_sweeps();
 
         double avg_energy = 0.0;
         double avg_mag = 0.0;
@@ -118,6 +236,85 @@ MultiAnnealResult ReplicaAnnealer::run(std::size_t sweeps_per_beta) {
         avg_mag /= static_cast<double>(replicas_);
         result.average_energy_trace.push_back(avg_energy);
         result.average_magnetization_trace.push_back(avg_mag);
+        instrumentation::finish_step(result.step_counters);
+
+        if (migration_ && !monitor.stopped() && step + 1 < schedule_.size() &&
+            (step + 1) % migration_interval_ == 0) {
+            migration_(step, states, energies);
+            if (states.size() != replicas_ || energies.size() != replicas_) {
+                throw std::runtime_error("Migration hook changed the replica count.");
+            }
+            for (std::size_t r = 0; r < replicas_; ++r) {
+                if (samples) {
+                    hashes[r] = samples->zobrist().hash(states[r]);
+                }
+                auto &replica = result.replicas[r];
+                if (energies[r] < replica.best_energy) {
+                    replica.best_energy = energies[r];
+                    replica.best_state = states[r];
+                }
+                if (energies[r] < result.global_best_energy) {
+                    result.global_best_energy = energies[r];
+                    result.global_best_state = states[r];
+                }
+            }
+        }
+
+        if (!checkpoint_.path.empty() && !monitor.stopped() &&
+            (step + 1) % checkpoint_.interval == 0) {
+            CheckpointWriter writer(kCheckpointTag);
+            writer.write_size(sweeps_per_beta);
+            writer.write_doubles(schedule_.betas);
+            writer.write_size(step + 1);
+            writer.write_rng(rng_);
+            writer.write_states(states);
+            writer.write_doubles(energies);
+            for (const auto &replica : result.replicas) {
+                writer.write_state(replica.best_state);
+                writer.write_f64(replica.best_energy);
+                writer.write_doubles(replica.energy_trace);
+                writer.write_doubles(replica.magnetization_trace);
+            }
+            writer.write_state(result.global_best_state);
+            writer.write_f64(result.global_best_energy);
+            writer.write_doubles(result.average_energy_trace);
+            writer.write_doubles(result.average_magnetization_trace);
+            writer.write_monitor(monitor);
+            writer.commit(checkpoint_.path);
+        }
+    }
+
+    result.stop_reason = monitor.reason();
+    result.sweeps = monitor.sweeps();
+
+    if (polish_.mode != PolishMode::None) {
+        // Polish every replica's final and best state; replica r owns
+        // candidates 2r and 2r + 1.
+        LocalSearch search(require_hamiltonian(*backend_).coupling_graph());
+        std::vector<State> candidates;
+        std::vector<double> candidate_energies;
+        candidates.reserve(2 * replicas_);
+        candidate_energies.reserve(2 * replicas_);
+        for (std::size_t r = 0; r < replicas_; ++r) {
+            candidates.push_back(std::move(states[r]));
+            candidate_energies.push_back(energies[r]);
+            candidates.push_back(result.replicas[r].best_state);
+            candidate_energies.push_back(result.replicas[r].best_energy);
+        }
+        search.polish_all(candidates, candidate_energies, polish_);
+        for (std::size_t k = 0; k < candidates.size(); ++k) {
+            auto &replica = result.replicas[k / 2];
+            if (candidate_energies[k] < replica.best_energy) {
+                replica.best_energy = candidate_energies[k];
+                replica.best_state = std::move(candidates[k]);
+            }
+        }
+        for (const auto &replica : result.replicas) {
+            if (replica.best_energy < result.global_best_energy) {
+                result.global_best_energy = replica.best_energy;
+                result.global_best_state = replica.best_state;
+            }
+        }
     }
 
     return result;
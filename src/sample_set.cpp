@@ -0,0 +1,172 @@
+#include "qanneal/sample_set.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace qanneal {
+
+namespace {
+
+std::uint64_t splitmix64(std::uint64_t &x) {
+    std::uint64_t z = (x += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+} // namespace
+
+ZobristTable::ZobristTable(std::size_t n, std::uint64_t seed)
+    : keys_(n), seed_(seed) {
+    std::uint64_t x = seed;
+    for (auto &key : keys_) {
+        key = splitmix64(x);
+    }
+}
+
+std::uint64_t ZobristTable::hash(const int8_t *spins, std::size_t n) const {
+    if (n != keys_.size()) {
+        throw std::invalid_argument("State size does not match the Zobrist table.");
+    }
+    std::uint64_t h = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        if (spins[i] < 0) {
+            h ^= keys_[i];
+        }
+    }
+    return h;
+}
+
+SampleSet::SampleSet(std::size_t n, std::size_t capacity, std::uint64_t seed)
+    : n_(n), capacity_(capacity), zobrist_(n, seed) {
+    if (n_ == 0) {
+        throw std::invalid_argument("SampleSet size must be > 0.");
+    }
+    if (capacity_ == 0) {
+        throw std::invalid_argument("SampleSet capacity must be > 0.");
+    }
+    index_.reserve(capacity_);
+}
+
+bool SampleSet::heap_less(std::size_t a, std::size_t b) const {
+    if (energies_[a] != energies_[b]) {
+        return energies_[a] < energies_[b];
+    }
+    return hashes_[a] < hashes_[b];
+}
+
+void SampleSet::add(const int8_t *spins, double energy, std::uint64_t hash, std::uint64_t count) {
+    offered_ += count;
+    auto found = index_.find(hash);
+    if (found != index_.end()) {
+        counts_[found->second] += count;
+        return;
+    }
+
+    auto less = [this](std::size_t a, std::size_t b) { return heap_less(a, b); };
+    std::size_t slot;
+    if (index_.size() < capacity_) {
+        slot = energies_.size();
+        spins_.resize(spins_.size() + n_);
+        energies_.push_back(0.0);
+        counts_.push_back(0);
+        hashes_.push_back(0);
+    } else {
+        // Ties go by hash, as in samples(), so the kept states do not depend
+        // on the order they were offered in.
+        const std::size_t worst = heap_.front();
+        if (!(energy < energies_[worst] || (energy == energies_[worst] && hash < hashes_[worst]))) {
+            return;
+        }
+        std::pop_heap(heap_.begin(), heap_.end(), less);
+        heap_.pop_back();
+        index_.erase(hashes_[worst]);
+        slot = worst;
+    }
+
+    std::memcpy(spins_.data() + slot * n_, spins, n_);
+    energies_[slot] = energy;
+    counts_[slot] = count;
+    hashes_[slot] = hash;
+    index_.emplace(hash, slot);
+    heap_.push_back(slot);
+    std::push_heap(heap_.begin(), heap_.end(), less);
+}
+
+void SampleSet::add(const State &state, double energy) {
+    add(state.spins.data(), energy, zobrist_.hash(state));
+}
+
+void SampleSet::merge(const SampleSet &other) {
+    if (other.n_ != n_ || other.zobrist_.seed() != zobrist_.seed()) {
+        throw std::invalid_argument("SampleSet merge needs the same spin count and Zobrist seed.");
+    }
+    if (&other == this) {
+        // Every kept state is already here, so this is what merging a copy
+        // does, without reading slots while they are being written.
+        for (std::size_t slot : heap_) {
+            counts_[slot] *= 2;
+        }
+        offered_ *= 2;
+        return;
+    }
+    const std::uint64_t kept = [&] {
+        std::uint64_t total = 0;
+        for (std::size_t slot : other.heap_) {
+            total += other.counts_[slot];
+        }
+        return total;
+    }();
+    for (std::size_t slot : other.heap_) {
+        add(other.spins_.data() + slot * n_, other.energies_[slot], other.hashes_[slot], other.counts_[slot]);
+    }
+    // Occurrences `other` saw but did not keep still count as offered.
+    offered_ += other.offered_ - kept;
+}
+
+void SampleSet::clear() {
+    spins_.clear();
+    energies_.clear();
+    counts_.clear();
+    hashes_.clear();
+    index_.clear();
+    heap_.clear();
+    offered_ = 0;
+}
+
+std::vector<std::size_t> SampleSet::sorted_slots() const {
+    std::vector<std::size_t> slots = heap_;
+    std::sort(slots.begin(), slots.end(), [this](std::size_t a, std::size_t b) { return heap_less(a, b); });
+    return slots;
+}
+
+std::vector<Sample> SampleSet::samples() const {
+    std::vector<Sample> out;
+    out.reserve(heap_.size());
+    for (std::size_t slot : sorted_slots()) {
+        Sample sample;
+        sample.state = State(n_);
+        std::memcpy(sample.state.spins.data(), spins_.data() + slot * n_, n_);
+        sample.energy = energies_[slot];
+        sample.count = counts_[slot];
+        out.push_back(std::move(sample));
+    }
+    return out;
+}
+
+void SampleSet::export_sorted(std::vector<int8_t> &spins,
+                              std::vector<double> &energies,
+                              std::vector<std::uint64_t> &counts) const {
+    const auto slots = sorted_slots();
+    spins.resize(slots.size() * n_);
+    energies.resize(slots.size());
+    counts.resize(slots.size());
+    for (std::size_t k = 0; k < slots.size(); ++k) {
+        std::memcpy(spins.data() + k * n_, spins_.data() + slots[k] * n_, n_);
+        energies[k] = energies_[slots[k]];
+        counts[k] = counts_[slots[k]];
+    }
+}
+
+}
@@ -0,0 +1,102 @@
+#include "qanneal/schedule.hpp"
+
+#include <limits>
+
+#include "qanneal/annealer.hpp"
+#include "qanneal/hamiltonian.hpp"
+
+namespace qanneal {
+
+BetaRange estimate_beta_range(const Hamiltonian &hamiltonian) {
+    const CouplingGraph graph = hamiltonian.coupling_graph();
+    double max_delta = 0.0;
+    double min_delta = std::numeric_limits<double>::infinity();
+    for (std::size_t i = 0; i < graph.size(); ++i) {
+        // Flipping spin i changes the energy by 2 |h_i + sum_j J_ij s_j|,
+        // which is at most 2 (|h_i| + sum_j |J_ij|).
+        double bound = std::abs(graph.h[i]);
+        if (bound > 0.0) {
+            min_delta = std::min(min_delta, 2.0 * bound);
+        }
+        for (std::size_t k = graph.offsets[i]; k < graph.offsets[i + 1]; ++k) {
+            const double weight = std::abs(graph.weights[k]);
+            bound += weight;
+            if (weight > 0.0) {
+                min_delta = std::min(min_delta, 2.0 * weight);
+            }
+        }
+        max_delta = std::max(max_delta, 2.0 * bound);
+    }
+    if (max_delta == 0.0) {
+        throw std::invalid_argument("Cannot derive a beta range for an all-zero Hamiltonian.");
+    }
+
+    BetaRange range;
+    range.beta_min = std::log(2.0) / max_delta;
+    range.beta_max = std::log(100.0) / min_delta;
+    range.beta_max = std::max(range.beta_max, range.beta_min);
+    return range;
+}
+
+AnnealSchedule auto_schedule(const Hamiltonian &hamiltonian, std::size_t steps) {
+    const BetaRange range = estimate_beta_range(hamiltonian);
+    return AnnealSchedule::geometric(range.beta_min, range.beta_max, steps);
+}
+
+AnnealSchedule adaptive_schedule(const Hamiltonian &hamiltonian,
+                                 AnnealSchedule base,
+                                 AdaptiveScheduleOptions options) {
+    base.sweep_scale.clear();
+    base.validate();
+    if (options.pilot_sweeps == 0) {
+        throw std::invalid_argument("pilot_sweeps must be > 0.");
+    }
+    if (options.min_scale < 0.0 || options.min_scale > 1.0) {
+        throw std::invalid_argument("min_scale must be in [0, 1].");
+    }
+
+    Annealer pilot(hamiltonian, base);
+    pilot.set_seed(options.seed);
+    const std::vector<double> acceptance = pilot.run(options.pilot_sweeps).acceptance_trace;
+
+    const std::size_t steps = base.size();
+    std::vector<double> change(steps, 0.0);
+    std::size_t live = 0;
+    double change_sum = 0.0;
+    for (std::size_t k = 0; k < steps; ++k) {
+        if (acceptance[k] < options.collapse_threshold) {
+            continue;
+        }
+        // Acceptance change into this step; the first step uses the next one.
+        const std::size_t other = (k > 0) ? k - 1 : std::min<std::size_t>(1, steps - 1);
+        change[k] = std::abs(acceptance[k] - acceptance[other]);
+        change_sum += change[k];
+        ++live;
+    }
+
+    base.sweep_scale.assign(steps, 0.0);
+    if (live == 0) {
+        // Frozen from the start: spend the budget on the first step alone.
+        base.sweep_scale[0] = static_cast<double>(steps);
+        return base;
+    }
+
+    const double mean_change = change_sum / static_cast<double>(live);
+    double scale_sum = 0.0;
+    for (std::size_t k = 0; k < steps; ++k) {
+        if (acceptance[k] < options.collapse_threshold) {
+            continue;
+        }
+        const double relative = (mean_change > 0.0) ? change[k] / mean_change : 1.0;
+        base.sweep_scale[k] = options.min_scale + (1.0 - options.min_scale) * relative;
+        scale_sum += base.sweep_scale[k];
+    }
+    // Keep the total number of sweeps equal to steps * sweeps_per_beta.
+    const double normalise = static_cast<double>(steps) / scale_sum;
+    for (double &scale : base.sweep_scale) {
+        scale *= normalise;
+    }
+    return base;
+}
+
+} // namespace qanneal
@@ -0,0 +1,207 @@
+#include "qanneal/solver_pool.hpp"
+
+#include <limits>
+#include <stdexcept>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "qanneal/annealer.hpp"
+#include "qanneal/parallel_tempering.hpp"
+#include "qanneal/population_annealer.hpp"
+
+namespace qanneal {
+
+namespace {
+
+struct RestartOutcome {
+    State best_state;
+    double best_energy = std::numeric_limits<double>::infinity();
+    StopReason stop_reason = StopReason::Cancelled;
+    std::size_t sweeps = 0;
+};
+
+RestartOutcome run_restart(const SolverJob &job,
+                           const std::shared_ptr<Backend> &backend,
+                           std::size_t restart) {
+    RestartOutcome outcome;
+    const std::uint64_t seed = job.seed + restart;
+    switch (job.engine) {
+    case SolverEngine::Annealer: {
+        Annealer annealer(backend, job.schedule);
+        annealer.set_seed(seed);
+        annealer.set_stop_criteria(job.stop);
+        auto result = annealer.run(job.sweeps);
+        outcome.best_state = std::move(result.best_state);
+        outcome.best_energy = result.best_energy;
+        outcome.stop_reason = result.stop_reason;
+        outcome.sweeps = result.sweeps;
+        break;
+    }
+    case SolverEngine::ParallelTempering: {
+        ParallelTemperingAnnealer annealer(backend, job.betas);
+        annealer.set_seed(seed);
+        annealer.set_stop_criteria(job.stop);
+        auto result = annealer.run(job.sweeps, job.steps);
+        outcome.best_state = std::move(result.best_state);
+        outcome.best_energy = result.best_energy;
+        outcome.stop_reason = result.stop_reason;
+        outcome.sweeps = result.sweeps;
+        break;
+    }
+    case SolverEngine::Population: {
+        PopulationAnnealer annealer(backend, job.schedule, job.population);
+        annealer.set_seed(seed);
+        annealer.set_stop_criteria(job.stop);
+        auto result = annealer.run(job.sweeps);
+        outcome.best_state = std::move(result.best_state);
+        outcome.best_energy = result.best_energy;
+        outcome.stop_reason = result.stop_reason;
+        outcome.sweeps = result.sweeps;
+        break;
+    }
+    }
+    return outcome;
+}
+
+} // namespace
+
+struct SolverPool::JobState {
+    SolverJob job;
+    std::shared_ptr<Backend> backend;
+    std::promise<SolverJobResult> promise;
+
+    std::mutex mutex;
+    std::size_t remaining = 0;
+    SolverJobResult result;
+    std::exception_ptr error;
+};
+
+bool SolverPool::PendingOrder::operator()(const PendingRun &a, const PendingRun &b) const {
+    // priority_queue pops the largest element, so "less" means "runs later".
+    if (a.priority != b.priority) {
+        return a.priority < b.priority;
+    }
+    return a.sequence > b.sequence;
+}
+
+SolverPool::SolverPool(std::size_t threads)
+    : pool_(threads) {}
+
+std::future<SolverJobResult> SolverPool::submit(SolverJob job) {
+    if (!job.hamiltonian) {
+        throw std::invalid_argument("SolverJob requires a Hamiltonian.");
+    }
+    if (job.restarts == 0) {
+        throw std::invalid_argument("restarts must be > 0.");
+    }
+    if (job.sweeps == 0) {
+        throw std::invalid_argument("sweeps must be > 0.");
+    }
+    switch (job.engine) {
+    case SolverEngine::Annealer:
+        if (job.schedule.betas.empty()) {
+            throw std::invalid_argument("Schedule must contain at least one beta.");
+        }
+        break;
+    case SolverEngine::ParallelTempering:
+        if (job.betas.size() < 2) {
+            throw std::invalid_argument("Parallel tempering requires at least two betas.");
+        }
+        if (job.steps == 0) {
+            throw std::invalid_argument("steps must be > 0.");
+        }
+        break;
+    case SolverEngine::Population:
+        if (job.schedule.betas.empty()) {
+            throw std::invalid_argument("Schedule must contain at least one beta.");
+        }
+        if (job.population == 0) {
+            throw std::invalid_argument("population must be > 0.");
+        }
+        break;
+    }
+
+    auto state = std::make_shared<JobState>();
+    state->backend = make_backend(BackendKind::CPU, job.hamiltonian);
+    state->remaining = job.restarts;
+    state->result.best_energy = std::numeric_limits<double>::infinity();
+    state->result.restart_energies.assign(job.restarts, std::numeric_limits<double>::infinity());
+    state->result.restart_stop_reasons.assign(job.restarts, StopReason::Cancelled);
+    state->job = std::move(job);
+    auto future = state->promise.get_future();
+
+    const std::size_t restarts = state->job.restarts;
+    {
+        std::lock_guard<std::mutex> lock(pending_mutex_);
+        for (std::size_t r = 0; r < restarts; ++r) {
+            pending_.push(PendingRun{state->job.priority, sequence_++, state, r});
+        }
+    }
+    // Each pool task takes whichever pending restart has the highest
+    // priority when it starts, not necessarily the one queued with it.
+    for (std::size_t r = 0; r < restarts; ++r) {
+        pool_.submit([this] { run_next(); });
+    }
+    return future;
+}
+
+void SolverPool::run_next() {
+    PendingRun run;
+    {
+        std::lock_guard<std::mutex> lock(pending_mutex_);
+        if (pending_.empty()) {
+            return;
+        }
+        run = pending_.top();
+        pending_.pop();
+    }
+    JobState &state = *run.job;
+
+#ifdef _OPENMP
+    // Restarts already run one per pool thread. An engine's own OpenMP team
+    // (PopulationAnnealer's) inside every worker would start threads x
+    // threads threads, so teams started from a worker get one thread.
+    omp_set_num_threads(1);
+#endif
+
+    RestartOutcome outcome;
+    std::exception_ptr error;
+    if (!state.job.stop.cancel.cancelled()) {
+        try {
+            outcome = run_restart(state.job, state.backend, run.restart);
+        } catch (...) {
+            error = std::current_exception();
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(state.mutex);
+    auto &result = state.result;
+    if (error && !state.error) {
+        state.error = error;
+    }
+    result.restart_energies[run.restart] = outcome.best_energy;
+    result.restart_stop_reasons[run.restart] = outcome.stop_reason;
+    result.sweeps += outcome.sweeps;
+    if (outcome.best_energy < result.best_energy) {
+        result.best_energy = outcome.best_energy;
+        result.best_state = std::move(outcome.best_state);
+    }
+    if (--state.remaining > 0) {
+        return;
+    }
+    if (state.error) {
+        state.promise.set_exception(state.error);
+        return;
+    }
+    for (StopReason reason : result.restart_stop_reasons) {
+        if (reason != StopReason::Completed) {
+            result.stop_reason = reason;
+            break;
+        }
+    }
+    state.promise.set_value(std::move(result));
+}
+
+} // namespace qanneal
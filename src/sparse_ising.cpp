@@ -70,4 +70,24 @@ double SparseIsing::delta_energy(const int8_t *spins, std::size_t n, std::size_t
     return -2.0 * s * local;
 }
 
+CouplingGraph SparseIsing::coupling_graph() const {
+    CouplingGraph graph;
+    graph.h = h_;
+    graph.offsets.reserve(n_ + 1);
+    graph.offsets.push_back(0);
+    graph.neighbors.reserve(2 * edges_.size());
+    graph.weights.reserve(2 * edges_.size());
+    for (std::size_t i = 0; i < n_; ++i) {
+        for (const auto &neighbor : adj_[i]) {
+            if (neighbor.value == 0.0) {
+                continue;
+            }
+            graph.neighbors.push_back(neighbor.idx);
+            graph.weights.push_back(neighbor.value);
+        }
+        graph.offsets.push_back(graph.neighbors.size());
+    }
+    return graph;
+}
+
 }
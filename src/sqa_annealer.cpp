@@ -7,6 +7,12 @@
 
 namespace qanneal {
 
+namespace {
+
+constexpr const char *kCheckpointTag = "sqa_annealer";
+
+} // namespace
+
 SQAAnnealer::SQAAnnealer(const Hamiltonian &hamiltonian,
                          SQASchedule schedule,
                          std::size_t trotter_slices,
@@ -60,6 +66,25 @@ void SQAAnnealer::set_seed(std::uint64_t seed) {
     rng_.seed(seed);
 }
 
+void SQAAnnealer::set_polish(PolishOptions options) {
+    polish_ = options;
+}
+
+void SQAAnnealer::set_stop_criteria(StopCriteria criteria) {
+    stop_ = std::move(criteria);
+}
+
+void SQAAnnealer::set_checkpoint(CheckpointOptions options) {
+    if (options.interval == 0) {
+        throw std::invalid_argument("checkpoint interval must be > 0.");
+    }
+    checkpoint_ = std::move(options);
+}
+
+void SQAAnnealer::set_sample_set(std::shared_ptr<SampleSet> samples) {
+    samples_ = std::move(samples);
+}
+
 double SQAAnnealer::trotter_coupling(double beta, double gamma) const {
     const double eps = 1e-12;
     const double x = std::max(beta * gamma / static_cast<double>(slices_), eps);
@@ -83,6 +108,21 @@ double SQAAnnealer::delta_trotter(const SQAState &state,
 SQAResult SQAAnnealer::run(std::size_t sweeps_per_beta,
                            std::size_t worldline_sweeps,
                            SQAObserver *observer) {
+    return run_from(sweeps_per_beta, worldline_sweeps, observer, nullptr);
+}
+
+SQAResult SQAAnnealer::resume(const std::string &path,
+                              std::size_t sweeps_per_beta,
+                              std::size_t worldline_sweeps,
+                              SQAObserver *observer) {
+    CheckpointReader reader(path, kCheckpointTag);
+    return run_from(sweeps_per_beta, worldline_sweeps, observer, &reader);
+}
+
+SQAResult SQAAnnealer::run_from(std::size_t sweeps_per_beta,
+                                std::size_t worldline_sweeps,
+                                SQAObserver *observer,
+                                CheckpointReader *reader) {
     if (sweeps_per_beta == 0) {
         throw std::invalid_argument("sweeps_per_beta must be > 0.");
     }
@@ -95,15 +135,47 @@ SQAResult SQAAnnealer::run(std::size_t sweeps_per_beta,
     result.energy_trace.reserve(schedule_.size());
 
     std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    StopMonitor monitor(stop_);
+    std::size_t first_step = 0;
 
-    for (std::size_t step = 0; step < schedule_.size(); ++step) {
+    if (reader) {
+        if (reader->read_size() != sweeps_per_beta || reader->read_size() != worldline_sweeps ||
+            reader->read_doubles() != schedule_.betas || reader->read_doubles() != schedule_.gammas) {
+            throw std::invalid_argument("Checkpoint was written for a different schedule.");
+        }
+        first_step = reader->read_size();
+        reader->read_rng(rng_);
+        state = reader->read_sqa_state();
+        if (state.replicas() != replicas_ || state.slices() != slices_ || state.spins() != n) {
+            throw std::invalid_argument("Checkpoint SQA state dimensions do not match.");
+        }
+        result.best_state = reader->read_state();
+        result.best_energy = reader->read_f64();
+        result.energy_trace = reader->read_doubles();
+        reader->read_monitor(monitor);
+        reader->finish();
+    }
+    instrumentation::reset();
+    instrumentation::skip_steps(result.step_counters, first_step);
+
+    SampleSet *samples = samples_.get();
+    if (samples && samples->num_spins() != n) {
+        throw std::invalid_argument("Sample set size does not match the problem.");
+    }
+
+    for (std::size_t step = first_step; step < schedule_.size() && !monitor.stopped(); ++step) {
         const double beta = schedule_.betas[step];
         const double gamma = schedule_.gammas[step];
         const double j_perp = trotter_coupling(beta, gamma);
 
         const double beta_scale = beta / static_cast<double>(slices_);
+        instrumentation::PhaseTimer timer;
+        std::size_t attempted = 0;
+        std::size_t accepted = 0;
+        std::size_t worldline_attempted = 0;
+        std::size_t worldline_accepted = 0;
 
-        for (std::size_t replica = 0; replica < replicas_; ++replica) {
+        for (std::size_t replica = 0; replica < replicas_ && !monitor.stopped(); ++replica) {
             for (std::size_t sweep = 0; sweep < sweeps_per_beta; ++sweep) {
                 for (std::size_t slice = 0; slice < slices_; ++slice) {
                     int8_t *slice_ptr = state.slice_ptr(replica, slice);
@@ -114,12 +186,19 @@ SQAResult SQAAnnealer::run(std::size_t sweeps_per_beta,
                                              delta_trotter(state, replica, slice, spin, j_perp);
                         if (delta <= 0.0 || uniform(rng_) < std::exp(-delta)) {
                             slice_ptr[spin] = static_cast<int8_t>(-slice_ptr[spin]);
+                            ++accepted;
                         }
                     }
                 }
+                attempted += slices_ * n;
+                // Slice energies are only evaluated once per step, so sweeps
+                // are counted here and the best energy is reported below.
+                if (monitor.record(1)) {
+                    break;
+                }
             }
 
-            for (std::size_t sweep = 0; sweep < worldline_sweeps; ++sweep) {
+            for (std::size_t sweep = 0; sweep < worldline_sweeps && !monitor.stopped(); ++sweep) {
                 for (std::size_t spin = 0; spin < n; ++spin) {
                     double delta_classical = 0.0;
                     for (std::size_t slice = 0; slice < slices_; ++slice) {
@@ -132,10 +211,17 @@ SQAResult SQAAnnealer::run(std::size_t sweeps_per_beta,
                             int8_t *slice_ptr = state.slice_ptr(replica, slice);
                             slice_ptr[spin] = static_cast<int8_t>(-slice_ptr[spin]);
                         }
+                        ++worldline_accepted;
                     }
                 }
+                worldline_attempted += n;
             }
         }
+        instrumentation::add(&StepCounters::attempted_flips, attempted);
+        instrumentation::add(&StepCounters::accepted_flips, accepted);
+        instrumentation::add(&StepCounters::worldline_attempts, worldline_attempted);
+        instrumentation::add(&StepCounters::worldline_accepts, worldline_accepted);
+        timer.end_sweeps();
 
         double avg_energy = 0.0;
         std::size_t total_states = replicas_ * slices_;
@@ -144,6 +230,11 @@ SQAResult SQAAnnealer::run(std::size_t sweeps_per_beta,
                 const int8_t *slice_ptr = state.slice_ptr(replica, slice);
                 const double e = backend_->energy(slice_ptr, n);
                 avg_energy += e;
+                // Slices change many spins per step, so they are hashed
+                // afresh; the O(n) hash is cheap next to the energy.
+                if (samples) {
+                    samples->add(slice_ptr, e, samples->zobrist().hash(slice_ptr, n));
+                }
                 if (e < result.best_energy) {
                     result.best_energy = e;
                     result.best_state = state.slice_state(replica, slice);
@@ -152,12 +243,48 @@ SQAResult SQAAnnealer::run(std::size_t sweeps_per_beta,
         }
         avg_energy /= static_cast<double>(total_states);
         result.energy_trace.push_back(avg_energy);
+        monitor.record(0, result.best_energy);
+        timer.lap(&StepCounters::energy_ns);
 
         if (observer) {
             observer->record(step, beta, gamma, avg_energy, state);
+            timer.lap(&StepCounters::observer_ns);
+        }
+        instrumentation::finish_step(result.step_counters);
+        if constexpr (instrumentation::enabled) {
+            if (observer) {
+                observer->record_counters(step, result.step_counters.back());
+            }
+        }
+
+        if (!checkpoint_.path.empty() && !monitor.stopped() &&
+            (step + 1) % checkpoint_.interval == 0) {
+            CheckpointWriter writer(kCheckpointTag);
+            writer.write_size(sweeps_per_beta);
+            writer.write_size(worldline_sweeps);
+            writer.write_doubles(schedule_.betas);
+            writer.write_doubles(schedule_.gammas);
+            writer.write_size(step + 1);
+            writer.write_rng(rng_);
+            writer.write_sqa_state(state);
+            writer.write_state(result.best_state);
+            writer.write_f64(result.best_energy);
+            writer.write_doubles(result.energy_trace);
+            writer.write_monitor(monitor);
+            writer.commit(checkpoint_.path);
         }
     }
 
+    result.stop_reason = monitor.reason();
+    result.sweeps = monitor.sweeps();
+
+    if (polish_.mode != PolishMode::None) {
+        // SQA keeps no classical final state, so only the best slice found
+        // during the run is polished.
+        LocalSearch search(require_hamiltonian(*backend_).coupling_graph());
+        result.best_energy = search.polish(result.best_state, result.best_energy, polish_);
+    }
+
     return result;
 }
 
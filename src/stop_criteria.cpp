@@ -0,0 +1,62 @@
+#include "qanneal/stop_criteria.hpp"
+
+namespace qanneal {
+
+const char *stop_reason_to_string(StopReason reason) {
+    switch (reason) {
+    case StopReason::Completed:
+        return "completed";
+    case StopReason::TimeLimit:
+        return "time_limit";
+    case StopReason::TargetEnergy:
+        return "target_energy";
+    case StopReason::Stagnation:
+        return "stagnation";
+    case StopReason::Cancelled:
+        return "cancelled";
+    }
+    return "unknown";
+}
+
+StopMonitor::StopMonitor(const StopCriteria &criteria)
+    : criteria_(criteria), start_(Clock::now()) {}
+
+double StopMonitor::elapsed() const {
+    return std::chrono::duration<double>(Clock::now() - start_).count();
+}
+
+void StopMonitor::restore(std::size_t sweeps,
+                          std::size_t last_improvement,
+                          double best_energy,
+                          double elapsed) {
+    sweeps_ = sweeps;
+    last_improvement_ = last_improvement;
+    best_energy_ = best_energy;
+    start_ = Clock::now() - std::chrono::duration_cast<Clock::duration>(
+                                std::chrono::duration<double>(elapsed));
+}
+
+bool StopMonitor::record(std::size_t sweeps, double energy) {
+    if (stopped()) {
+        return true;
+    }
+    sweeps_ += sweeps;
+    if (energy < best_energy_) {
+        best_energy_ = energy;
+        last_improvement_ = sweeps_;
+    }
+
+    if (best_energy_ <= criteria_.target_energy) {
+        reason_ = StopReason::TargetEnergy;
+    } else if (criteria_.cancel.cancelled()) {
+        reason_ = StopReason::Cancelled;
+    } else if (criteria_.stagnation_sweeps > 0 &&
+               sweeps_ - last_improvement_ >= criteria_.stagnation_sweeps) {
+        reason_ = StopReason::Stagnation;
+    } else if (criteria_.time_limit > 0.0 && elapsed() >= criteria_.time_limit) {
+        reason_ = StopReason::TimeLimit;
+    }
+    return stopped();
+}
+
+} // namespace qanneal
@@ -0,0 +1,238 @@
+#include "qanneal/telemetry_observer.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+#include "qanneal/metrics.hpp"
+#include "qanneal/sqa_state.hpp"
+#include "qanneal/state.hpp"
+
+namespace qanneal {
+
+namespace {
+
+constexpr char kMagic[8] = {'Q', 'A', 'N', 'N', 'T', 'E', 'L', 'E'};
+constexpr std::uint64_t kVersion = 1;
+
+template <class T>
+void write_pod(std::ofstream &out, const T &value) {
+    out.write(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+template <class T>
+bool read_pod(std::ifstream &in, T &value) {
+    return static_cast<bool>(in.read(reinterpret_cast<char *>(&value), sizeof(T)));
+}
+
+} // namespace
+
+TelemetryObserver::TelemetryObserver(TelemetryOptions options)
+    : options_(std::move(options)) {
+    if (options_.path.empty()) {
+        throw std::invalid_argument("TelemetryObserver requires a path.");
+    }
+    if (options_.decimation == 0) {
+        throw std::invalid_argument("telemetry decimation must be > 0.");
+    }
+    if (options_.capacity == 0) {
+        throw std::invalid_argument("telemetry capacity must be > 0.");
+    }
+    out_.open(options_.path, std::ios::binary | std::ios::trunc);
+    if (!out_) {
+        throw std::runtime_error("Cannot open telemetry file " + options_.path);
+    }
+    ring_.resize(options_.capacity);
+    writer_ = std::thread([this] { run_writer(); });
+}
+
+TelemetryObserver::~TelemetryObserver() {
+    try {
+        close();
+    } catch (...) {
+        // Destructors must not throw; call close() to see write errors.
+    }
+}
+
+void TelemetryObserver::record(std::size_t step, double beta, double energy, const State &state) {
+    if (step % options_.decimation != 0) {
+        return;
+    }
+    push(step, beta, std::numeric_limits<double>::quiet_NaN(), energy, state.spins.data(), state.size());
+}
+
+void TelemetryObserver::record(std::size_t step,
+                               double beta,
+                               double gamma,
+                               double avg_energy,
+                               const SQAState &state) {
+    if (step % options_.decimation != 0) {
+        return;
+    }
+    push(step, beta, gamma, avg_energy, state.data(), state.size());
+}
+
+void TelemetryObserver::push(std::size_t step, double beta, double gamma, double energy,
+                             const int8_t *spins, std::size_t count) {
+    if (closed_ || failed_.load(std::memory_order_relaxed)) {
+        return;
+    }
+    if (snapshot_spins_ == 0) {
+        // Allocated once, before the first slot is published, so the ring
+        // never allocates again.
+        snapshot_spins_ = count;
+        for (auto &slot : ring_) {
+            slot.spins.resize(count);
+        }
+    } else if (count != snapshot_spins_) {
+        throw std::invalid_argument("TelemetryObserver snapshot size changed between records.");
+    }
+
+    const std::size_t head = head_.load(std::memory_order_relaxed);
+    if (head - tail_.load(std::memory_order_acquire) == ring_.size()) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    Slot &slot = ring_[head % ring_.size()];
+    slot.step = step;
+    slot.beta = beta;
+    slot.gamma = gamma;
+    slot.energy = energy;
+    std::memcpy(slot.spins.data(), spins, count);
+    head_.store(head + 1, std::memory_order_release);
+    wake_.notify_one();
+}
+
+void TelemetryObserver::run_writer() {
+    bool header_written = false;
+    std::vector<uint8_t> packed;
+    auto write_header = [&](std::size_t spins) {
+        out_.write(kMagic, sizeof(kMagic));
+        write_pod(out_, kVersion);
+        write_pod(out_, static_cast<std::uint64_t>(spins));
+        write_pod(out_, static_cast<std::uint64_t>(options_.store_spins ? 1 : 0));
+        header_written = true;
+    };
+
+    try {
+        while (true) {
+            const std::size_t tail = tail_.load(std::memory_order_relaxed);
+            if (tail == head_.load(std::memory_order_acquire)) {
+                if (closing_.load(std::memory_order_acquire)) {
+                    // close() runs after the last push, so a second look at
+                    // head decides whether anything is left.
+                    if (tail == head_.load(std::memory_order_acquire)) {
+                        break;
+                    }
+                    continue;
+                }
+                // The producer notifies without the mutex, so a wakeup can
+                // be missed; the timeout bounds the delay.
+                std::unique_lock<std::mutex> lock(wake_mutex_);
+                wake_.wait_for(lock, std::chrono::milliseconds(2));
+                continue;
+            }
+
+            const Slot &slot = ring_[tail % ring_.size()];
+            const std::size_t n = slot.spins.size();
+            if (!header_written) {
+                write_header(n);
+            }
+            write_pod(out_, static_cast<std::uint64_t>(slot.step));
+            write_pod(out_, slot.beta);
+            write_pod(out_, slot.gamma);
+            write_pod(out_, slot.energy);
+            write_pod(out_, magnetization(slot.spins.data(), n));
+            if (options_.store_spins) {
+                packed.resize(packed_spin_bytes(n));
+                pack_spins(slot.spins.data(), n, packed.data());
+                out_.write(reinterpret_cast<const char *>(packed.data()),
+                           static_cast<std::streamsize>(packed.size()));
+            }
+            if (!out_) {
+                throw std::runtime_error("Failed writing telemetry file " + options_.path);
+            }
+            tail_.store(tail + 1, std::memory_order_release);
+            written_.fetch_add(1, std::memory_order_release);
+        }
+        if (!header_written) {
+            write_header(0);
+        }
+        out_.flush();
+        if (!out_) {
+            throw std::runtime_error("Failed writing telemetry file " + options_.path);
+        }
+    } catch (...) {
+        error_ = std::current_exception();
+        failed_.store(true, std::memory_order_release);
+    }
+    out_.close();
+}
+
+void TelemetryObserver::close() {
+    if (closed_) {
+        return;
+    }
+    closed_ = true;
+    closing_.store(true, std::memory_order_release);
+    wake_.notify_one();
+    if (writer_.joinable()) {
+        writer_.join();
+    }
+    if (error_) {
+        std::rethrow_exception(error_);
+    }
+}
+
+TelemetryTrace read_telemetry(const std::string &path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("Cannot open telemetry file " + path);
+    }
+    char magic[sizeof(kMagic)];
+    std::uint64_t version = 0;
+    std::uint64_t spins = 0;
+    std::uint64_t flags = 0;
+    if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, kMagic, sizeof(kMagic)) != 0) {
+        throw std::runtime_error("Not a qanneal telemetry file: " + path);
+    }
+    if (!read_pod(in, version) || version != kVersion || !read_pod(in, spins) || !read_pod(in, flags)) {
+        throw std::runtime_error("Unsupported telemetry header in " + path);
+    }
+
+    TelemetryTrace trace;
+    trace.snapshot_spins = static_cast<std::size_t>(spins);
+    trace.has_spins = (flags & 1U) != 0;
+    std::vector<uint8_t> packed(packed_spin_bytes(trace.snapshot_spins));
+    while (true) {
+        std::uint64_t step = 0;
+        if (!read_pod(in, step)) {
+            break;
+        }
+        double beta = 0.0;
+        double gamma = 0.0;
+        double energy = 0.0;
+        double mag = 0.0;
+        if (!read_pod(in, beta) || !read_pod(in, gamma) || !read_pod(in, energy) || !read_pod(in, mag)) {
+            throw std::runtime_error("Truncated telemetry record in " + path);
+        }
+        if (trace.has_spins) {
+            if (!in.read(reinterpret_cast<char *>(packed.data()), static_cast<std::streamsize>(packed.size()))) {
+                throw std::runtime_error("Truncated telemetry record in " + path);
+            }
+            const std::size_t offset = trace.spins.size();
+            trace.spins.resize(offset + trace.snapshot_spins);
+            unpack_spins(packed.data(), trace.snapshot_spins, trace.spins.data() + offset);
+        }
+        trace.steps.push_back(static_cast<std::size_t>(step));
+        trace.betas.push_back(beta);
+        trace.gammas.push_back(gamma);
+        trace.energies.push_back(energy);
+        trace.magnetizations.push_back(mag);
+    }
+    return trace;
+}
+
+}
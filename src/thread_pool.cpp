@@ -0,0 +1,178 @@
+#include "qanneal/thread_pool.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <stdexcept>
+
+namespace qanneal {
+
+namespace {
+
+thread_local const ThreadPool *tls_pool = nullptr;
+thread_local std::size_t tls_index = 0;
+
+} // namespace
+
+ThreadPool::ThreadPool(std::size_t threads) {
+    if (threads == 0) {
+        threads = std::max<std::size_t>(1, std::thread::hardware_concurrency());
+    }
+    queues_.reserve(threads);
+    for (std::size_t t = 0; t < threads; ++t) {
+        queues_.push_back(std::make_unique<Queue>());
+    }
+    threads_.reserve(threads);
+    for (std::size_t t = 0; t < threads; ++t) {
+        threads_.emplace_back([this, t] { worker_loop(t); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    for (auto &thread : threads_) {
+        thread.join();
+    }
+}
+
+std::size_t ThreadPool::worker_index() const {
+    return tls_pool == this ? tls_index : size();
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+    std::size_t target = worker_index();
+    if (target == size()) {
+        target = next_queue_.fetch_add(1, std::memory_order_relaxed) % size();
+    }
+    // Count the task before it becomes visible so a worker that pops it can
+    // never drive the counter below zero.
+    pending_.fetch_add(1, std::memory_order_release);
+    {
+        std::lock_guard<std::mutex> lock(queues_[target]->mutex);
+        queues_[target]->tasks.push_back(std::move(task));
+    }
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex_);
+    }
+    wake_.notify_one();
+}
+
+bool ThreadPool::try_pop(std::size_t self, std::function<void()> &task) {
+    const std::size_t count = queues_.size();
+    if (self < count) {
+        auto &own = *queues_[self];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            pending_.fetch_sub(1, std::memory_order_acq_rel);
+            return true;
+        }
+    }
+    const std::size_t start = (self < count) ? self + 1 : 0;
+    for (std::size_t k = 0; k < count; ++k) {
+        auto &victim = *queues_[(start + k) % count];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            pending_.fetch_sub(1, std::memory_order_acq_rel);
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::worker_loop(std::size_t self) {
+    tls_pool = this;
+    tls_index = self;
+    std::function<void()> task;
+    while (true) {
+        if (try_pop(self, task)) {
+            try {
+                task();
+            } catch (...) {
+            }
+            task = nullptr;
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(sleep_mutex_);
+        wake_.wait(lock, [this] {
+            return stopping_ || pending_.load(std::memory_order_acquire) > 0;
+        });
+        if (stopping_ && pending_.load(std::memory_order_acquire) == 0) {
+            return;
+        }
+    }
+}
+
+void ThreadPool::parallel_for(std::size_t count,
+                              std::size_t grain,
+                              const std::function<void(std::size_t)> &fn) {
+    if (grain == 0) {
+        throw std::invalid_argument("grain must be > 0.");
+    }
+    if (count == 0) {
+        return;
+    }
+
+    std::mutex done_mutex;
+    std::condition_variable done;
+    std::size_t remaining = (count + grain - 1) / grain;
+    std::exception_ptr error;
+
+    for (std::size_t begin = 0; begin < count; begin += grain) {
+        const std::size_t end = std::min(count, begin + grain);
+        submit([&, begin, end] {
+            std::exception_ptr local;
+            try {
+                for (std::size_t i = begin; i < end; ++i) {
+                    fn(i);
+                }
+            } catch (...) {
+                local = std::current_exception();
+            }
+            // The caller may return as soon as it sees remaining == 0 under
+            // the lock, so nothing here touches its stack after unlocking.
+            std::lock_guard<std::mutex> lock(done_mutex);
+            if (local && !error) {
+                error = local;
+            }
+            if (--remaining == 0) {
+                done.notify_all();
+            }
+        });
+    }
+
+    const std::size_t self = worker_index();
+    std::function<void()> task;
+    while (true) {
+        {
+            std::lock_guard<std::mutex> lock(done_mutex);
+            if (remaining == 0) {
+                break;
+            }
+        }
+        if (try_pop(self, task)) {
+            try {
+                task();
+            } catch (...) {
+            }
+            task = nullptr;
+            continue;
+        }
+        // Nothing left to steal: the remaining chunks are running elsewhere.
+        std::unique_lock<std::mutex> lock(done_mutex);
+        done.wait_for(lock, std::chrono::milliseconds(1), [&] { return remaining == 0; });
+    }
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+} // namespace qanneal
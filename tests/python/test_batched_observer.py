@@ -0,0 +1,109 @@
+import signal
+import sys
+import threading
+from concurrent.futures import ThreadPoolExecutor
+
+import numpy as np
+
+import qanneal
+
+n = 24
+rng = np.random.default_rng(9)
+J = np.triu(rng.normal(size=(n, n)), 1)
+J = J + J.T
+h = rng.normal(size=n)
+ham = qanneal.DenseIsingView(h, J)
+steps = 30
+schedule = qanneal.AnnealSchedule.linear(0.1, 3.0, steps)
+
+
+def solve(seed, interval=7):
+    batches = []
+
+    def callback(step, betas, gammas, energies, mags):
+        assert np.isnan(gammas).all()
+        batches.append((step, energies))
+
+    obs = qanneal.BatchedObserver(callback, interval)
+    annealer = qanneal.Annealer(ham, schedule)
+    annealer.set_seed(seed)
+    result = annealer.run(3, obs)
+    assert obs.pending == 0
+    return result, batches
+
+
+def test_batches_cover_run():
+    result, batches = solve(1)
+    assert [len(s) for s, _ in batches] == [7, 7, 7, 7, 2]
+    all_steps = np.concatenate([s for s, _ in batches])
+    assert list(all_steps) == list(range(steps))
+    energies = np.concatenate([e for _, e in batches])
+    assert np.array_equal(energies, result.energy_trace)
+
+
+def test_thread_pool():
+    serial = {seed: solve(seed)[0].best_energy for seed in range(1, 7)}
+    with ThreadPoolExecutor(max_workers=4) as pool:
+        results = dict(zip(range(1, 7), pool.map(solve, range(1, 7))))
+    for seed, (result, batches) in results.items():
+        assert result.best_energy == serial[seed]
+        assert sum(len(s) for s, _ in batches) == steps
+
+
+def test_gil_released_during_run():
+    # The main thread keeps running Python while a long solve holds no GIL.
+    big = qanneal.Annealer(ham, qanneal.AnnealSchedule.linear(0.1, 3.0, 400))
+    big.set_seed(1)
+    done = threading.Event()
+    ticks = 0
+
+    def run():
+        big.run(200)
+        done.set()
+
+    worker = threading.Thread(target=run)
+    worker.start()
+    while not done.is_set():
+        ticks += 1
+    worker.join()
+    assert ticks > 1
+
+
+def expect_escape(raise_in_callback, exc_type):
+    calls = []
+
+    def callback(*arrays):
+        calls.append(len(arrays[0]))
+        raise_in_callback()
+
+    obs = qanneal.BatchedObserver(callback, 5)
+    annealer = qanneal.Annealer(ham, schedule)
+    try:
+        annealer.run(2, obs)
+    except exc_type:
+        pass
+    else:
+        raise AssertionError(f"{exc_type.__name__} did not escape the run")
+    # The run stopped at the first batch.
+    assert calls == [5]
+
+
+def test_exceptions_escape():
+    def fail():
+        raise RuntimeError("stop")
+
+    expect_escape(fail, RuntimeError)
+    # Ctrl-C: SIGINT delivered while the engine is running.
+    expect_escape(lambda: signal.raise_signal(signal.SIGINT), KeyboardInterrupt)
+
+
+def main():
+    test_batches_cover_run()
+    test_thread_pool()
+    test_gil_released_during_run()
+    test_exceptions_escape()
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,52 @@
+import sys
+import threading
+
+import numpy as np
+
+import qanneal
+
+
+def submit_and_drop(futures):
+    n = 32
+    rng = np.random.default_rng(3)
+    J = np.triu(rng.normal(size=(n, n)), 1)
+    J = J + J.T
+    ham = qanneal.DenseIsingView(rng.normal(size=n), J)
+    pool = qanneal.SolverPool(2)
+    for seed in range(4):
+        job = qanneal.SolverJob()
+        job.hamiltonian = ham
+        job.schedule = qanneal.AnnealSchedule.linear(0.1, 3.0, 200)
+        job.sweeps = 4
+        job.restarts = 2
+        job.seed = seed + 1
+        futures.append(pool.submit(job))
+        del job
+    # The jobs now hold the only references to the view, so a worker drops
+    # the last one while the pool is being destroyed.
+    del ham, J
+    del pool
+
+
+def test_pool_destruction_releases_gil():
+    futures = []
+    worker = threading.Thread(target=submit_and_drop, args=(futures,), daemon=True)
+    worker.start()
+    # Without the GIL released in the destructor, the pool's workers and this
+    # thread wait on each other for good.
+    worker.join(60)
+    assert not worker.is_alive(), "destroying the SolverPool did not return"
+    assert len(futures) == 4
+    for future in futures:
+        assert future.done()
+        result = future.result()
+        assert np.isfinite(result.best_energy)
+
+
+def main():
+    test_pool_destruction_releases_gil()
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,151 @@
+import os
+import sys
+import tempfile
+
+import numpy as np
+
+import qanneal
+
+
+def brute_energy(h, J, spins, c=0.0):
+    s = spins.astype(float)
+    return c + float(h @ s) + 0.5 * float(s @ J @ s)
+
+
+def random_model(n, seed):
+    rng = np.random.default_rng(seed)
+    J = np.triu(rng.normal(size=(n, n)), 1)
+    J = J + J.T
+    h = rng.normal(size=n)
+    return h, J
+
+
+def test_dense_view_reads_in_place():
+    h, J = random_model(6, 1)
+    ham = qanneal.DenseIsingView(h, J, 0.5)
+    spins = np.array([1, -1, 1, 1, -1, -1], dtype=np.int8)
+    assert np.isclose(ham.energy(spins), brute_energy(h, J, spins, 0.5))
+
+    # No copy was taken: edits to the caller's arrays show through.
+    h[0] += 1.0
+    assert np.isclose(ham.energy(spins), brute_energy(h, J, spins, 0.5))
+
+    # The view keeps its buffers alive after the caller drops them.
+    expected = ham.energy(spins)
+    del h, J
+    assert ham.energy(spins) == expected
+
+
+def test_csr_views():
+    n = 5
+    h, J = random_model(n, 2)
+    J[np.abs(J) < 0.5] = 0.0
+    rows, cols = np.nonzero(J)
+    indptr = np.searchsorted(rows, np.arange(n + 1)).astype(np.int32)
+    indices = cols.astype(np.int32)
+    data = J[rows, cols].copy()
+    spins = np.array([1, 1, -1, 1, -1], dtype=np.int8)
+
+    narrow = qanneal.csr_ising(h, indptr, indices, data)
+    assert isinstance(narrow, qanneal.CsrIsingView32)
+    wide = qanneal.csr_ising(h, indptr.astype(np.int64), indices.astype(np.int64), data)
+    assert isinstance(wide, qanneal.CsrIsingView64)
+    for ham in (narrow, wide):
+        assert np.isclose(ham.energy(spins), brute_energy(h, J, spins))
+
+    data[:] = 0.0
+    assert np.isclose(narrow.energy(spins), float(h @ spins))
+
+    try:
+        qanneal.csr_ising(h, indptr[:-1], indices, data)
+    except ValueError:
+        pass
+    else:
+        raise AssertionError("short indptr accepted")
+
+
+def test_from_scipy():
+    try:
+        import scipy.sparse
+    except ImportError:
+        print("scipy not installed; skipping from_scipy")
+        return
+    n = 8
+    h, J = random_model(n, 3)
+    matrix = scipy.sparse.csr_matrix(J)
+    ham = qanneal.from_scipy(matrix, h)
+    spins = np.where(np.arange(n) % 3 == 0, 1, -1).astype(np.int8)
+    assert np.isclose(ham.energy(spins), brute_energy(h, J, spins))
+    matrix.data *= 2.0
+    assert np.isclose(ham.energy(spins), brute_energy(h, 2.0 * J, spins))
+
+
+def test_state_spins():
+    state = qanneal.State(4)
+    view = state.spins
+    state.spins = np.array([1, -1, -1, 1], dtype=np.int8)
+    assert list(view) == [1, -1, -1, 1]
+    view[0] = -1
+    assert state.spins[0] == -1
+
+    for bad in (np.ones(3, dtype=np.int8), np.ones(5, dtype=np.int8)):
+        try:
+            state.spins = bad
+        except ValueError:
+            pass
+        else:
+            raise AssertionError("spins of the wrong length accepted")
+    assert list(view) == [-1, -1, -1, 1]
+
+
+def expect_read_only(arr):
+    assert not arr.flags.writeable
+    try:
+        arr[...] = 0
+    except ValueError:
+        pass
+    else:
+        raise AssertionError("result view is writable")
+
+
+def test_read_only_traces():
+    h, J = random_model(6, 4)
+    ham = qanneal.DenseIsing(h, J)
+    schedule = qanneal.AnnealSchedule.linear(0.1, 2.0, 12)
+    annealer = qanneal.Annealer(ham, schedule)
+    annealer.set_seed(5)
+    result = annealer.run(2)
+    trace = result.energy_trace
+    assert len(trace) == 12
+    expect_read_only(trace)
+    # The view outlives the result object it came from.
+    first = float(trace[0])
+    del result
+    assert float(trace[0]) == first
+
+    with tempfile.TemporaryDirectory() as tmp:
+        options = qanneal.TelemetryOptions()
+        options.path = os.path.join(tmp, "trace.bin")
+        options.store_spins = True
+        with qanneal.TelemetryObserver(options) as obs:
+            annealer.run(2, obs)
+        telemetry = qanneal.read_telemetry(options.path)
+    assert len(telemetry) == 12
+    for arr in (telemetry.steps, telemetry.betas, telemetry.energies,
+                telemetry.magnetizations, telemetry.spins):
+        expect_read_only(arr)
+    assert telemetry.spins.shape == (12, 6)
+    assert set(np.unique(telemetry.spins)) <= {-1, 1}
+
+
+def main():
+    test_dense_view_reads_in_place()
+    test_csr_views()
+    test_from_scipy()
+    test_state_spins()
+    test_read_only_traces()
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
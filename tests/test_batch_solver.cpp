@@ -0,0 +1,130 @@
+#include <atomic>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <stdexcept>
+
+#include "qanneal/batch_solver.hpp"
+#include "qanneal/dense_ising.hpp"
+#include "qanneal/schedule.hpp"
+#include "qanneal/sparse_ising.hpp"
+#include "qanneal/thread_pool.hpp"
+
+namespace {
+
+double brute_force_ground(const qanneal::DenseIsing &ham) {
+    const std::size_t n = ham.size();
+    double best = std::numeric_limits<double>::infinity();
+    qanneal::State state(n);
+    for (std::size_t mask = 0; mask < (std::size_t{1} << n); ++mask) {
+        for (std::size_t i = 0; i < n; ++i) {
+            state[i] = ((mask >> i) & 1U) ? 1 : -1;
+        }
+        best = std::min(best, ham.energy(state));
+    }
+    return best;
+}
+
+} // namespace
+
+int main() {
+    // Work-stealing pool: every index runs exactly once and exceptions reach
+    // the caller.
+    {
+        qanneal::ThreadPool pool(4);
+        std::vector<std::atomic<int>> hits(1000);
+        pool.parallel_for(hits.size(), 7, [&](std::size_t i) { hits[i].fetch_add(1); });
+        for (const auto &hit : hits) {
+            assert(hit.load() == 1);
+        }
+
+        bool threw = false;
+        try {
+            pool.parallel_for(10, 1, [](std::size_t i) {
+                if (i == 3) {
+                    throw std::runtime_error("boom");
+                }
+            });
+        } catch (const std::runtime_error &) {
+            threw = true;
+        }
+        assert(threw);
+    }
+
+    std::mt19937_64 gen(11);
+    std::normal_distribution<double> normal(0.0, 1.0);
+    std::vector<qanneal::DenseIsing> problems;
+    for (std::size_t k = 0; k < 24; ++k) {
+        const std::size_t n = 4 + k % 7;
+        std::vector<double> h(n);
+        std::vector<double> J(n * n, 0.0);
+        for (std::size_t i = 0; i < n; ++i) {
+            h[i] = 0.3 * normal(gen);
+            for (std::size_t j = i + 1; j < n; ++j) {
+                J[i * n + j] = J[j * n + i] = normal(gen);
+            }
+        }
+        problems.emplace_back(h, J, n, 0.5);
+    }
+
+    qanneal::IsingBatch batch(problems);
+    assert(batch.size() == problems.size());
+
+    auto schedule = qanneal::AnnealSchedule::linear(0.1, 4.0, 40);
+    qanneal::BatchAnnealer annealer(schedule);
+    annealer.set_seed(5);
+    annealer.set_threads(4);
+    auto result = annealer.run(batch, 20);
+    assert(result.size() == problems.size());
+    for (std::size_t k = 0; k < problems.size(); ++k) {
+        const auto state = result.best_state(k);
+        assert(std::abs(problems[k].energy(state) - result.best_energies[k]) < 1e-9);
+        assert(std::abs(result.best_energies[k] - brute_force_ground(problems[k])) < 1e-9);
+    }
+
+    // The thread count does not change the answer.
+    qanneal::BatchAnnealer serial(schedule);
+    serial.set_seed(5);
+    serial.set_threads(1);
+    auto serial_result = serial.run(batch, 20);
+    assert(serial_result.best_energies == result.best_energies);
+    assert(serial_result.best_spins == result.best_spins);
+
+    // Contiguous buffers and sparse models pack into the same arena layout.
+    std::vector<std::size_t> sizes;
+    std::vector<double> h_buffer;
+    std::vector<double> J_buffer;
+    std::vector<double> constants;
+    for (const auto &problem : problems) {
+        sizes.push_back(problem.size());
+        h_buffer.insert(h_buffer.end(), problem.h().begin(), problem.h().end());
+        J_buffer.insert(J_buffer.end(), problem.J().begin(), problem.J().end());
+        constants.push_back(problem.constant());
+    }
+    qanneal::IsingBatch packed(sizes, h_buffer, J_buffer, constants);
+    qanneal::BatchAnnealer packed_annealer(schedule);
+    packed_annealer.set_seed(5);
+    assert(packed_annealer.run(packed, 20).best_energies == result.best_energies);
+
+    std::vector<qanneal::SparseEdge> edges = {{0, 1, 1.0}, {1, 2, -0.5}, {0, 2, 0.25}};
+    qanneal::SparseIsing sparse({0.1, 0.0, -0.2}, edges, 3, 1.0);
+    qanneal::IsingBatch mixed;
+    mixed.add(static_cast<const qanneal::Hamiltonian &>(sparse));
+    qanneal::State probe(3);
+    probe[1] = -1;
+    assert(std::abs(mixed.energy(0, probe.spins.data()) - sparse.energy(probe)) < 1e-12);
+
+    // A coupling given twice counts twice, in either orientation.
+    std::vector<qanneal::SparseEdge> repeated = {{0, 1, 1.0}, {1, 2, -0.5}, {0, 1, 0.75}, {2, 1, 0.3}};
+    qanneal::SparseIsing duplicated({0.1, 0.0, -0.2}, repeated, 3, 1.0);
+    mixed.add(static_cast<const qanneal::Hamiltonian &>(duplicated));
+    for (std::size_t mask = 0; mask < 8; ++mask) {
+        for (std::size_t i = 0; i < 3; ++i) {
+            probe[i] = (mask >> i) & 1u ? 1 : -1;
+        }
+        assert(std::abs(mixed.energy(1, probe.spins.data()) - duplicated.energy(probe)) < 1e-12);
+    }
+
+    return 0;
+}
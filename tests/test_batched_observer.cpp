@@ -0,0 +1,96 @@
+#include <cassert>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "qanneal/annealer.hpp"
+#include "qanneal/batched_observer.hpp"
+#include "qanneal/dense_ising.hpp"
+#include "qanneal/metrics_observer.hpp"
+#include "qanneal/sqa_annealer.hpp"
+#include "qanneal/sqa_schedule.hpp"
+
+int main() {
+    const std::size_t n = 10;
+    std::mt19937_64 rng(3);
+    std::normal_distribution<double> normal(0.0, 1.0);
+    std::vector<double> h(n);
+    std::vector<double> J(n * n, 0.0);
+    for (std::size_t i = 0; i < n; ++i) {
+        h[i] = normal(rng);
+        for (std::size_t j = i + 1; j < n; ++j) {
+            J[i * n + j] = J[j * n + i] = normal(rng);
+        }
+    }
+    qanneal::DenseIsing ham(h, J, n);
+
+    // Batches arrive every `interval` steps and, after flush(), cover every
+    // step exactly as a MetricsObserver sees them.
+    {
+        auto schedule = qanneal::AnnealSchedule::linear(0.1, 3.0, 23);
+        std::vector<qanneal::ObserverBatch> batches;
+        qanneal::BatchedObserver batched([&](qanneal::ObserverBatch batch) { batches.push_back(std::move(batch)); }, 5);
+        qanneal::MetricsObserver metrics;
+
+        qanneal::Annealer a(ham, schedule);
+        a.set_seed(11);
+        a.run(4, &batched);
+        assert(batches.size() == 4 && batched.pending() == 3);
+        batched.flush();
+        assert(batches.size() == 5 && batched.pending() == 0);
+        batched.flush();
+        assert(batches.size() == 5);
+
+        qanneal::Annealer b(ham, schedule);
+        b.set_seed(11);
+        b.run(4, &metrics);
+
+        std::size_t k = 0;
+        for (const auto &batch : batches) {
+            assert(batch.size() <= 5);
+            for (std::size_t i = 0; i < batch.size(); ++i, ++k) {
+                assert(batch.steps[i] == k);
+                assert(batch.betas[i] == schedule.betas[k]);
+                assert(std::isnan(batch.gammas[i]));
+                assert(batch.energies[i] == metrics.energy_trace[k]);
+                assert(batch.magnetizations[i] == metrics.magnetization_trace[k]);
+            }
+        }
+        assert(k == schedule.size());
+    }
+
+    // SQA runs fill in gamma and the average energy.
+    {
+        auto schedule = qanneal::SQASchedule::from_vectors({0.2, 0.5, 1.0, 2.0}, {2.0, 1.0, 0.5, 0.1});
+        std::vector<qanneal::ObserverBatch> batches;
+        qanneal::BatchedObserver batched([&](qanneal::ObserverBatch batch) { batches.push_back(std::move(batch)); }, 3);
+        qanneal::SQAMetricsObserver metrics;
+
+        qanneal::SQAAnnealer a(ham, schedule, 4, 2);
+        a.set_seed(5);
+        const auto result = a.run(2, 1, &batched);
+        batched.flush();
+        qanneal::SQAAnnealer b(ham, schedule, 4, 2);
+        b.set_seed(5);
+        b.run(2, 1, &metrics);
+
+        assert(batches.size() == 2 && batches[0].size() == 3 && batches[1].size() == 1);
+        for (std::size_t k = 0; k < 4; ++k) {
+            const auto &batch = batches[k / 3];
+            assert(batch.gammas[k % 3] == schedule.gammas[k]);
+            assert(batch.energies[k % 3] == result.energy_trace[k]);
+            assert(std::abs(batch.magnetizations[k % 3] - metrics.magnetization_trace[k]) < 1e-12);
+        }
+    }
+
+    bool threw = false;
+    try {
+        qanneal::BatchedObserver bad([](qanneal::ObserverBatch) {}, 0);
+    } catch (const std::invalid_argument &) {
+        threw = true;
+    }
+    assert(threw);
+
+    return 0;
+}
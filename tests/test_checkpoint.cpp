@@ -0,0 +1,165 @@
+#include <cassert>
+#include <cstdio>
+#include <random>
+#include <stdexcept>
+#include <string>
+
+#include "qanneal/annealer.hpp"
+#include "qanneal/checkpoint.hpp"
+#include "qanneal/dense_ising.hpp"
+#include "qanneal/parallel_tempering.hpp"
+#include "qanneal/replica_annealer.hpp"
+#include "qanneal/schedule.hpp"
+#include "qanneal/sqa_annealer.hpp"
+
+int main() {
+    const std::size_t n = 12;
+    std::mt19937_64 gen(3);
+    std::normal_distribution<double> normal(0.0, 1.0);
+    std::vector<double> h(n, 0.0);
+    std::vector<double> J(n * n, 0.0);
+    for (std::size_t i = 0; i < n; ++i) {
+        h[i] = 0.1 * normal(gen);
+        for (std::size_t j = i + 1; j < n; ++j) {
+            J[i * n + j] = J[j * n + i] = normal(gen);
+        }
+    }
+    qanneal::DenseIsing ham(h, J, n);
+
+    const std::string path = "qanneal_test_checkpoint.bin";
+
+    // Round trip of the primitive encodings, including the generator state.
+    {
+        std::mt19937_64 rng(42);
+        rng.discard(1000);
+        qanneal::State state = qanneal::State::random(13, rng);
+        qanneal::CheckpointWriter writer("unit");
+        writer.write_f64(-1.25);
+        writer.write_state(state);
+        writer.write_rng(rng);
+        writer.commit(path);
+
+        qanneal::CheckpointReader reader(path, "unit");
+        const double value = reader.read_f64();
+        const qanneal::State read_back = reader.read_state();
+        assert(value == -1.25);
+        assert(read_back.spins == state.spins);
+        std::mt19937_64 restored;
+        reader.read_rng(restored);
+        reader.finish();
+        assert(restored() == rng());
+
+        bool threw = false;
+        try {
+            qanneal::CheckpointReader wrong(path, "other");
+        } catch (const std::runtime_error &) {
+            threw = true;
+        }
+        assert(threw);
+
+        // A corrupt length reads as truncated instead of being allocated.
+        qanneal::CheckpointWriter corrupt("unit");
+        corrupt.write_size(std::size_t{1} << 60);
+        corrupt.commit(path);
+        threw = false;
+        try {
+            qanneal::CheckpointReader huge(path, "unit");
+            huge.read_doubles();
+        } catch (const std::runtime_error &) {
+            threw = true;
+        }
+        assert(threw);
+    }
+
+    // Each engine checkpoints every 30 of 50 steps, so the file left behind
+    // holds step 30. Resuming from it must reproduce the uninterrupted run.
+    qanneal::CheckpointOptions options;
+    options.path = path;
+    options.interval = 30;
+    auto schedule = qanneal::AnnealSchedule::linear(0.1, 3.0, 50);
+
+    {
+        qanneal::Annealer annealer(ham, schedule);
+        annealer.set_seed(7);
+        annealer.set_update_mode(qanneal::UpdateMode::Adaptive, 0.2);
+        annealer.set_checkpoint(options);
+        auto full = annealer.run(5);
+
+        qanneal::Annealer resumed_annealer(ham, schedule);
+        resumed_annealer.set_update_mode(qanneal::UpdateMode::Adaptive, 0.2);
+        auto resumed = resumed_annealer.resume(path, 5);
+        assert(resumed.best_energy == full.best_energy);
+        assert(resumed.best_state.spins == full.best_state.spins);
+        assert(resumed.energy_trace == full.energy_trace);
+        assert(resumed.acceptance_trace == full.acceptance_trace);
+        assert(resumed.rejection_free_step == full.rejection_free_step);
+        assert(resumed.sweeps == full.sweeps);
+
+        bool threw = false;
+        try {
+            resumed_annealer.resume(path, 6);
+        } catch (const std::invalid_argument &) {
+            threw = true;
+        }
+        assert(threw);
+    }
+
+    {
+        qanneal::ReplicaAnnealer annealer(ham, schedule, 3);
+        annealer.set_seed(7);
+        annealer.set_checkpoint(options);
+        auto full = annealer.run(5);
+
+        qanneal::ReplicaAnnealer resumed_annealer(ham, schedule, 3);
+        auto resumed = resumed_annealer.resume(path, 5);
+        assert(resumed.global_best_energy == full.global_best_energy);
+        assert(resumed.global_best_state.spins == full.global_best_state.spins);
+        assert(resumed.average_energy_trace == full.average_energy_trace);
+        for (std::size_t r = 0; r < 3; ++r) {
+            assert(resumed.replicas[r].energy_trace == full.replicas[r].energy_trace);
+        }
+    }
+
+    {
+        std::vector<double> betas = {0.2, 0.5, 1.0, 2.0};
+        qanneal::ClusterMoveOptions clusters;
+        clusters.houdayer = true;
+        clusters.update = qanneal::ClusterUpdate::Wolff;
+        qanneal::ParallelTemperingAnnealer annealer(ham, betas);
+        annealer.set_seed(7);
+        annealer.set_cluster_moves(clusters);
+        annealer.set_checkpoint(options);
+        auto full = annealer.run(2, 50);
+
+        qanneal::ParallelTemperingAnnealer resumed_annealer(ham, betas);
+        resumed_annealer.set_cluster_moves(clusters);
+        auto resumed = resumed_annealer.resume(path, 2, 50);
+        assert(resumed.best_energy == full.best_energy);
+        assert(resumed.final_energies == full.final_energies);
+        assert(resumed.swap_acceptance_trace == full.swap_acceptance_trace);
+        assert(resumed.cluster_size_trace == full.cluster_size_trace);
+    }
+
+    {
+        std::vector<double> betas(50);
+        std::vector<double> gammas(50);
+        for (std::size_t k = 0; k < 50; ++k) {
+            betas[k] = 0.5 + 0.05 * static_cast<double>(k);
+            gammas[k] = 3.0 - 0.06 * static_cast<double>(k);
+        }
+        auto sqa_schedule = qanneal::SQASchedule::from_vectors(betas, gammas);
+        qanneal::SQAAnnealer annealer(ham, sqa_schedule, 4, 2);
+        annealer.set_seed(7);
+        annealer.set_checkpoint(options);
+        auto full = annealer.run(2, 1);
+
+        qanneal::SQAAnnealer resumed_annealer(ham, sqa_schedule, 4, 2);
+        auto resumed = resumed_annealer.resume(path, 2, 1);
+        assert(resumed.best_energy == full.best_energy);
+        assert(resumed.best_state.spins == full.best_state.spins);
+        assert(resumed.energy_trace == full.energy_trace);
+    }
+
+    std::remove(path.c_str());
+    return 0;
+}
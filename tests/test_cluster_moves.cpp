@@ -0,0 +1,99 @@
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "qanneal/cluster_moves.hpp"
+#include "qanneal/parallel_tempering.hpp"
+#include "qanneal/sparse_ising.hpp"
+
+namespace {
+
+qanneal::SparseIsing periodic_lattice(std::size_t L, bool glass, std::mt19937_64 &rng) {
+    std::uniform_int_distribution<int> coin(0, 1);
+    std::vector<qanneal::SparseEdge> edges;
+    for (std::size_t y = 0; y < L; ++y) {
+        for (std::size_t x = 0; x < L; ++x) {
+            const std::size_t i = y * L + x;
+            const std::size_t right = y * L + (x + 1) % L;
+            const std::size_t down = ((y + 1) % L) * L + x;
+            const double a = glass && coin(rng) ? 1.0 : -1.0;
+            const double b = glass && coin(rng) ? 1.0 : -1.0;
+            edges.push_back({i, right, a});
+            edges.push_back({i, down, b});
+        }
+    }
+    return qanneal::SparseIsing(std::vector<double>(L * L, 0.0), std::move(edges), L * L);
+}
+
+} // namespace
+
+int main() {
+    std::mt19937_64 rng(5);
+    const std::size_t L = 6;
+
+    // Wolff and Swendsen-Wang must keep the tracked energy exact.
+    auto ferro = periodic_lattice(L, false, rng);
+    qanneal::ClusterWorkspace workspace(ferro.coupling_graph());
+    auto state = qanneal::State::random(L * L, rng);
+    double energy = ferro.energy(state);
+    for (int k = 0; k < 20; ++k) {
+        workspace.wolff_update(state, 0.4, energy, rng);
+        workspace.swendsen_wang_update(state, 0.4, energy, rng);
+        assert(std::abs(ferro.energy(state) - energy) < 1e-9);
+    }
+
+    qanneal::ParallelTemperingAnnealer pt_ferro(ferro, {0.2, 0.4, 0.8});
+    pt_ferro.set_seed(3);
+    qanneal::ClusterMoveOptions wolff;
+    wolff.update = qanneal::ClusterUpdate::Wolff;
+    pt_ferro.set_cluster_moves(wolff);
+    auto ferro_result = pt_ferro.run(1, 50);
+    assert(ferro_result.cluster_size_trace.size() == 50);
+    assert(std::abs(ferro_result.best_energy + 2.0 * L * L) < 1e-9);
+
+    // Houdayer moves run on two copies and are isoenergetic.
+    auto glass = periodic_lattice(L, true, rng);
+    qanneal::ParallelTemperingAnnealer pt_glass(glass, {0.3, 0.6, 1.0, 1.5});
+    pt_glass.set_seed(9);
+    qanneal::ClusterMoveOptions houdayer;
+    houdayer.houdayer = true;
+    pt_glass.set_cluster_moves(houdayer);
+    auto glass_result = pt_glass.run(2, 30);
+    assert(glass_result.final_states.size() == 8);
+    for (std::size_t r = 0; r < glass_result.final_states.size(); ++r) {
+        const double e = glass.energy(glass_result.final_states[r]);
+        assert(std::abs(e - glass_result.final_energies[r]) < 1e-9);
+    }
+    assert(std::abs(glass.energy(glass_result.best_state) - glass_result.best_energy) < 1e-9);
+
+    // houdayer_beta_min keeps the moves on the cold side. One step without a
+    // swap: the hot pairs end exactly as with no Houdayer moves at all, while
+    // the cold pairs are rearranged.
+    const std::vector<double> betas = {0.3, 0.6, 1.0, 1.5};
+    auto run_gated = [&](double beta_min) {
+        qanneal::ParallelTemperingAnnealer pt(glass, betas);
+        pt.set_seed(21);
+        qanneal::ClusterMoveOptions options;
+        options.houdayer = true;
+        options.houdayer_beta_min = beta_min;
+        pt.set_cluster_moves(options);
+        return pt.run(2, 1, 2);
+    };
+    const auto none = run_gated(std::numeric_limits<double>::infinity());
+    const auto cold = run_gated(1.0);
+    assert(none.cluster_size_trace[0] == 0.0);
+    assert(cold.cluster_size_trace[0] > 0.0);
+    bool cold_moved = false;
+    for (std::size_t r = 0; r < none.final_states.size(); ++r) {
+        const bool same = none.final_states[r].spins == cold.final_states[r].spins;
+        if (betas[r % betas.size()] < 1.0) {
+            assert(same);
+        } else {
+            cold_moved = cold_moved || !same;
+        }
+    }
+    assert(cold_moved);
+
+    return 0;
+}
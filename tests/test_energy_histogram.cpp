@@ -0,0 +1,91 @@
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include "qanneal/energy_histogram.hpp"
+#include "qanneal/sample_set.hpp"
+
+int main() {
+    // Bins are half-open; out-of-range energies are still counted.
+    {
+        qanneal::EnergyHistogram hist(-10.0, 0.0, 5, -7.0);
+        assert(hist.bins() == 5 && hist.bin_width() == 2.0);
+        hist.add(-10.0);
+        hist.add(-7.5, 3);
+        hist.add(-0.1);
+        hist.add(0.0);
+        hist.add(-12.0);
+        assert(hist.counts == std::vector<std::uint64_t>({1, 3, 0, 0, 1}));
+        assert(hist.underflow == 1 && hist.overflow == 1);
+        assert(hist.total() == 7);
+        assert(hist.hits == 5);
+        assert(std::abs(hist.success_probability() - 5.0 / 7.0) < 1e-12);
+        assert(hist.min_energy == -12.0 && hist.max_energy == 0.0);
+
+        qanneal::EnergyHistogram other(-10.0, 0.0, 5, -7.0);
+        other.add(-3.0, 2);
+        hist.merge(other);
+        assert(hist.counts[3] == 2 && hist.total() == 9 && hist.hits == 5);
+
+        bool threw = false;
+        try {
+            hist.merge(qanneal::EnergyHistogram(-10.0, 0.0, 4, -7.0));
+        } catch (const std::invalid_argument &) {
+            threw = true;
+        }
+        assert(threw);
+
+        // A NaN would fall through both range checks into the bin cast.
+        const double inf = std::numeric_limits<double>::infinity();
+        for (double bad : {std::nan(""), inf, -inf}) {
+            threw = false;
+            try {
+                hist.add(bad);
+            } catch (const std::invalid_argument &) {
+                threw = true;
+            }
+            assert(threw);
+        }
+        assert(hist.total() == 9 && hist.min_energy == -12.0);
+    }
+
+    // A full sample set breaks energy ties by hash, so merging in either
+    // order keeps the same states; add_offered keeps a rebuilt set exact.
+    {
+        const std::size_t n = 6;
+        std::vector<qanneal::State> states;
+        for (std::size_t k = 0; k < n; ++k) {
+            qanneal::State state(n);
+            state.spins[k] = -1;
+            states.push_back(state);
+        }
+        qanneal::SampleSet a(n, 2);
+        qanneal::SampleSet b(n, 2);
+        for (std::size_t k = 0; k < 3; ++k) {
+            a.add(states[k], 1.0);
+            b.add(states[k + 3], 1.0);
+        }
+        qanneal::SampleSet ab = a;
+        ab.merge(b);
+        qanneal::SampleSet ba = b;
+        ba.merge(a);
+        assert(ab.offered() == 6 && ba.offered() == 6);
+        const auto x = ab.samples();
+        const auto y = ba.samples();
+        assert(x.size() == 2 && y.size() == 2);
+        for (std::size_t k = 0; k < 2; ++k) {
+            assert(x[k].state.spins == y[k].state.spins);
+        }
+
+        qanneal::SampleSet rebuilt(n, 2);
+        for (const auto &sample : x) {
+            rebuilt.add(sample.state.spins.data(), sample.energy, rebuilt.zobrist().hash(sample.state), sample.count);
+        }
+        rebuilt.add_offered(ab.offered() - 2);
+        assert(rebuilt.offered() == ab.offered());
+    }
+
+    return 0;
+}
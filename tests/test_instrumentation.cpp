@@ -0,0 +1,134 @@
+#include <cassert>
+#include <cmath>
+#include <vector>
+
+#include "qanneal/annealer.hpp"
+#include "qanneal/dense_ising.hpp"
+#include "qanneal/instrumentation.hpp"
+#include "qanneal/metrics_observer.hpp"
+#include "qanneal/parallel_tempering.hpp"
+#include "qanneal/perf_counters.hpp"
+#include "qanneal/population_annealer.hpp"
+#include "qanneal/replica_annealer.hpp"
+#include "qanneal/schedule.hpp"
+#include "qanneal/sqa_annealer.hpp"
+
+namespace {
+
+class CountingObserver : public qanneal::Observer {
+public:
+    std::size_t records = 0;
+    std::vector<qanneal::StepCounters> counters;
+
+    void record(std::size_t, double, double, const qanneal::State &) override { ++records; }
+    void record_counters(std::size_t step, const qanneal::StepCounters &step_counters) override {
+        assert(step == counters.size());
+        counters.push_back(step_counters);
+    }
+};
+
+} // namespace
+
+int main() {
+    if constexpr (!qanneal::instrumentation::enabled) {
+        return 0;
+    }
+
+    const std::size_t n = 6;
+    std::vector<double> h = {0.1, -0.2, 0.3, 0.0, -0.1, 0.2};
+    std::vector<double> J(n * n, 0.0);
+    for (std::size_t i = 0; i + 1 < n; ++i) {
+        J[i * n + i + 1] = J[(i + 1) * n + i] = (i % 2 == 0) ? 0.5 : -0.7;
+    }
+    qanneal::DenseIsing ham(h, J, n);
+    auto schedule = qanneal::AnnealSchedule::linear(0.1, 2.0, 8);
+
+    // Per-step counters agree with the acceptance trace, and observers see
+    // the same counters the result carries.
+    qanneal::Annealer annealer(ham, schedule);
+    annealer.set_seed(3);
+    CountingObserver observer;
+    auto result = annealer.run(5, &observer);
+    assert(result.step_counters.size() == schedule.size());
+    assert(observer.counters.size() == schedule.size());
+    for (std::size_t step = 0; step < schedule.size(); ++step) {
+        const auto &c = result.step_counters[step];
+        assert(c.attempted_flips == 5 * n);
+        assert(std::abs(static_cast<double>(c.accepted_flips) / static_cast<double>(c.attempted_flips) -
+                        result.acceptance_trace[step]) < 1e-12);
+        assert(observer.counters[step].accepted_flips == c.accepted_flips);
+        assert(c.sweep_ns > 0);
+        assert(c.energy_ns == 0);  // SQA only
+        assert(c.swap_attempts == 0);
+    }
+    const auto total = qanneal::sum_counters(result.step_counters);
+    assert(total.attempted_flips == 5 * n * schedule.size());
+
+    qanneal::ReplicaAnnealer replicas(ham, schedule, 3);
+    replicas.set_seed(4);
+    auto multi = replicas.run(2);
+    assert(multi.step_counters.size() == schedule.size());
+    assert(multi.step_counters.front().attempted_flips == 3 * 2 * n);
+
+    const std::vector<double> betas = {0.2, 0.6, 1.5};
+    qanneal::ParallelTemperingAnnealer pt(ham, betas);
+    pt.set_seed(5);
+    auto tempering = pt.run(2, 10, 2);
+    assert(tempering.step_counters.size() == 10);
+    for (std::size_t step = 0; step < 10; ++step) {
+        const auto &c = tempering.step_counters[step];
+        assert(c.attempted_flips == betas.size() * 2 * n);
+        assert(c.swap_attempts == ((step % 2 == 1) ? betas.size() - 1 : 0));
+        assert(c.swap_accepts <= c.swap_attempts);
+    }
+
+    // Replicas sweep on worker threads; their counts are merged per step.
+    qanneal::PopulationAnnealer population(ham, schedule, 64);
+    population.set_seed(6);
+    auto pop = population.run(3);
+    assert(pop.step_counters.size() == schedule.size());
+    for (const auto &c : pop.step_counters) {
+        assert(c.attempted_flips == 64 * 3 * n);
+        assert(c.accepted_flips <= c.attempted_flips);
+        assert(c.sweep_ns > 0);
+    }
+
+    const std::size_t steps = 6;
+    auto sqa_schedule = qanneal::SQASchedule::from_vectors(std::vector<double>(steps, 2.0),
+                                                           std::vector<double>(steps, 0.5));
+    qanneal::SQAAnnealer sqa(ham, sqa_schedule, 4, 2);
+    sqa.set_seed(7);
+    qanneal::SQAMetricsObserver metrics;
+    auto quantum = sqa.run(2, 1, &metrics);
+    assert(quantum.step_counters.size() == steps);
+    assert(metrics.counter_trace.size() == steps);
+    assert(metrics.counter_trace.back().worldline_accepts == quantum.step_counters.back().worldline_accepts);
+    for (const auto &c : quantum.step_counters) {
+        assert(c.attempted_flips == 2 * 2 * 4 * n);
+        assert(c.worldline_attempts == 2 * n);
+        assert(c.worldline_accepts <= c.worldline_attempts);
+        assert(c.energy_ns > 0);
+    }
+
+    // Hardware counters are optional: when the kernel refuses them the run
+    // still succeeds and the hardware fields stay zero.
+    qanneal::PerfCounters perf;
+    assert(!perf.status().empty());
+    const auto first = perf.read();
+    if (!perf.available()) {
+        assert(first.cycles == -1 && first.instructions == -1);
+    }
+    qanneal::instrumentation::set_hardware_counters(true);
+    const bool permitted = qanneal::instrumentation::thread_perf_counters() != nullptr;
+    assert(permitted == perf.available());
+    auto counted = annealer.run(5);
+    qanneal::instrumentation::set_hardware_counters(false);
+    const auto hardware = qanneal::sum_counters(counted.step_counters);
+    if (!permitted) {
+        assert(hardware.cycles == 0 && hardware.instructions == 0);
+    } else if (first.instructions >= 0) {
+        assert(hardware.instructions > 0);
+    }
+
+    return 0;
+}
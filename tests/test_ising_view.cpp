@@ -0,0 +1,104 @@
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "qanneal/annealer.hpp"
+#include "qanneal/dense_ising.hpp"
+#include "qanneal/ising_view.hpp"
+#include "qanneal/sparse_ising.hpp"
+#include "qanneal/state.hpp"
+
+int main() {
+    const std::size_t n = 12;
+    std::mt19937_64 rng(9);
+    std::normal_distribution<double> normal(0.0, 1.0);
+    std::bernoulli_distribution keep(0.4);
+
+    std::vector<double> h(n);
+    std::vector<double> J(n * n, 0.0);
+    std::vector<qanneal::SparseEdge> edges;
+    for (std::size_t i = 0; i < n; ++i) {
+        h[i] = normal(rng);
+        for (std::size_t j = i + 1; j < n; ++j) {
+            if (keep(rng)) {
+                const double value = normal(rng);
+                J[i * n + j] = value;
+                J[j * n + i] = value;
+                edges.push_back({i, j, value});
+            }
+        }
+    }
+
+    // The same couplings in scipy CSR layout, with a stray diagonal entry
+    // that must be ignored.
+    std::vector<std::int32_t> indptr{0};
+    std::vector<std::int32_t> indices;
+    std::vector<double> data;
+    for (std::size_t i = 0; i < n; ++i) {
+        if (i == 3) {
+            indices.push_back(3);
+            data.push_back(7.0);
+        }
+        for (std::size_t j = 0; j < n; ++j) {
+            if (j != i && J[i * n + j] != 0.0) {
+                indices.push_back(static_cast<std::int32_t>(j));
+                data.push_back(J[i * n + j]);
+            }
+        }
+        indptr.push_back(static_cast<std::int32_t>(indices.size()));
+    }
+    std::vector<std::int64_t> indptr64(indptr.begin(), indptr.end());
+    std::vector<std::int64_t> indices64(indices.begin(), indices.end());
+
+    qanneal::DenseIsing dense(h, J, n, 0.5);
+    qanneal::SparseIsing sparse(h, edges, n, 0.5);
+    qanneal::DenseIsingView dense_view(h.data(), J.data(), n, 0.5);
+    qanneal::CsrIsingView<std::int32_t> csr(h.data(), indptr.data(), indices.data(), data.data(), n, 0.5);
+    qanneal::CsrIsingView<std::int64_t> csr64(h.data(), indptr64.data(), indices64.data(), data.data(), n, 0.5);
+
+    for (int trial = 0; trial < 20; ++trial) {
+        auto s = qanneal::State::random(n, rng);
+        const double e = dense.energy(s);
+        assert(std::abs(sparse.energy(s) - e) < 1e-9);
+        assert(std::abs(dense_view.energy(s) - e) < 1e-9);
+        assert(std::abs(csr.energy(s) - e) < 1e-9);
+        assert(std::abs(csr64.energy(s) - e) < 1e-9);
+        for (std::size_t k = 0; k < n; ++k) {
+            const double d = dense.delta_energy(s, k);
+            assert(std::abs(dense_view.delta_energy(s, k) - d) < 1e-9);
+            assert(std::abs(csr.delta_energy(s, k) - d) < 1e-9);
+            assert(std::abs(csr64.delta_energy(s, k) - d) < 1e-9);
+        }
+    }
+
+    const auto graph = csr.coupling_graph();
+    const auto reference = dense.coupling_graph();
+    assert(graph.offsets == reference.offsets);
+    assert(graph.neighbors == reference.neighbors);
+    assert(dense_view.coupling_graph().weights == reference.weights);
+
+    // A run over a view matches a run over the owning Hamiltonian.
+    auto schedule = qanneal::AnnealSchedule::linear(0.1, 3.0, 20);
+    qanneal::Annealer owned(dense, schedule);
+    owned.set_seed(5);
+    qanneal::Annealer viewed(csr, schedule);
+    viewed.set_seed(5);
+    const auto a = owned.run(5);
+    const auto b = viewed.run(5);
+    assert(a.best_state.spins == b.best_state.spins);
+    assert(std::abs(a.best_energy - b.best_energy) < 1e-9);
+
+    bool threw = false;
+    indices[0] = static_cast<std::int32_t>(n);
+    try {
+        qanneal::CsrIsingView<std::int32_t> bad(h.data(), indptr.data(), indices.data(), data.data(), n);
+    } catch (const std::invalid_argument &) {
+        threw = true;
+    }
+    assert(threw);
+
+    return 0;
+}
@@ -0,0 +1,85 @@
+#include <cassert>
+#include <cmath>
+#include <random>
+
+#include "qanneal/annealer.hpp"
+#include "qanneal/dense_ising.hpp"
+#include "qanneal/local_search.hpp"
+#include "qanneal/parallel_tempering.hpp"
+#include "qanneal/replica_annealer.hpp"
+#include "qanneal/schedule.hpp"
+
+int main() {
+    const std::size_t n = 10;
+    std::mt19937_64 rng(21);
+    std::uniform_real_distribution<double> coupling(-1.0, 1.0);
+    std::vector<double> h(n, 0.0);
+    std::vector<double> J(n * n, 0.0);
+    for (std::size_t i = 0; i < n; ++i) {
+        h[i] = 0.2 * coupling(rng);
+        for (std::size_t j = i + 1; j < n; ++j) {
+            J[i * n + j] = J[j * n + i] = coupling(rng);
+        }
+    }
+    qanneal::DenseIsing ham(h, J, n);
+
+    double ground = 1e300;
+    qanneal::State s(n);
+    for (std::size_t mask = 0; mask < (1u << n); ++mask) {
+        for (std::size_t i = 0; i < n; ++i) {
+            s[i] = (mask >> i) & 1u ? 1 : -1;
+        }
+        ground = std::min(ground, ham.energy(s));
+    }
+
+    qanneal::LocalSearch search(ham.coupling_graph());
+
+    // Steepest descent ends in a local minimum with a consistent energy.
+    auto state = qanneal::State::random(n, rng);
+    double energy = search.steepest_descent(state, ham.energy(state));
+    assert(std::abs(ham.energy(state) - energy) < 1e-9);
+    for (std::size_t i = 0; i < n; ++i) {
+        assert(ham.delta_energy(state, i) >= -1e-12);
+    }
+
+    // Tabu search on a 10-spin instance finds the ground state.
+    state = qanneal::State::random(n, rng);
+    energy = search.tabu_search(state, ham.energy(state), 200, 5);
+    assert(std::abs(ham.energy(state) - energy) < 1e-9);
+    assert(std::abs(energy - ground) < 1e-9);
+
+    qanneal::PolishOptions polish;
+    polish.mode = qanneal::PolishMode::Tabu;
+    polish.tabu_iterations = 200;
+    polish.tabu_tenure = 5;
+    polish.parallel = true;
+
+    // A single hot step leaves the state random; polishing fixes it.
+    auto hot = qanneal::AnnealSchedule::linear(0.01, 0.01, 1);
+    qanneal::Annealer annealer(ham, hot);
+    annealer.set_seed(1);
+    annealer.set_polish(polish);
+    auto result = annealer.run(1);
+    assert(std::abs(ham.energy(result.best_state) - result.best_energy) < 1e-9);
+    assert(std::abs(result.best_energy - ground) < 1e-9);
+
+    qanneal::ReplicaAnnealer replicas(ham, hot, 4);
+    replicas.set_seed(2);
+    replicas.set_polish(polish);
+    auto multi = replicas.run(1);
+    assert(std::abs(multi.global_best_energy - ground) < 1e-9);
+    for (const auto &replica : multi.replicas) {
+        assert(std::abs(ham.energy(replica.best_state) - replica.best_energy) < 1e-9);
+    }
+
+    qanneal::ParallelTemperingAnnealer pt(ham, {0.01, 0.02});
+    pt.set_seed(3);
+    pt.set_polish(polish);
+    auto pt_result = pt.run(1, 1);
+    assert(std::abs(pt_result.best_energy - ground) < 1e-9);
+    for (std::size_t r = 0; r < pt_result.final_states.size(); ++r) {
+        assert(std::abs(ham.energy(pt_result.final_states[r]) - pt_result.final_energies[r]) < 1e-9);
+    }
+
+    return 0;
+}
@@ -0,0 +1,182 @@
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "qanneal/mpi/mpi_context.hpp"
+#include "qanneal/mpi/mpi_distributed_anneal.hpp"
+#include "qanneal/mpi/mpi_distributed_ising.hpp"
+#include "qanneal/sparse_ising.hpp"
+
+namespace {
+
+// 6 x 8 periodic lattice with random fields and couplings, plus a few long
+// range couplings so that most blocks touch more than two others.
+qanneal::SparseIsing problem() {
+    const std::size_t rows = 6;
+    const std::size_t cols = 8;
+    const std::size_t n = rows * cols;
+    std::mt19937_64 rng(11);
+    std::uniform_real_distribution<double> coeff(-1.0, 1.0);
+    std::vector<double> h(n);
+    for (double &v : h) {
+        v = coeff(rng);
+    }
+    std::vector<qanneal::SparseEdge> edges;
+    for (std::size_t r = 0; r < rows; ++r) {
+        for (std::size_t c = 0; c < cols; ++c) {
+            const std::size_t i = r * cols + c;
+            edges.push_back({i, r * cols + (c + 1) % cols, coeff(rng)});
+            edges.push_back({i, ((r + 1) % rows) * cols + c, coeff(rng)});
+        }
+    }
+    for (std::size_t i = 0; i < n; i += 7) {
+        edges.push_back({i, (i * 5 + 13) % n == i ? (i + 1) % n : (i * 5 + 13) % n, coeff(rng)});
+    }
+    return qanneal::SparseIsing(h, edges, n, 0.75);
+}
+
+void check(qanneal::mpi::DistributedSparseIsing &dist, const qanneal::SparseIsing &global) {
+    const std::size_t n = global.size();
+    const std::size_t m = dist.num_owned();
+    const int rank = dist.rank();
+    assert(dist.global_size() == n);
+
+    // Every spin is owned once, and every owned spin has exactly one color.
+    std::vector<int> held(n, 0);
+    std::vector<int> owner(n, -1);
+    std::vector<int> color(n, -1);
+    std::vector<int> boundary(n, 0);
+    std::vector<int> local_color(m, -1);
+    for (std::size_t c = 0; c < dist.num_colors(); ++c) {
+        for (bool edge : {false, true}) {
+            for (std::size_t i : edge ? dist.boundary(c) : dist.interior(c)) {
+                assert(i < m && local_color[i] == -1);
+                local_color[i] = static_cast<int>(c);
+                boundary[dist.original_id(i)] = edge ? 1 : 0;
+            }
+        }
+    }
+    for (std::size_t i = 0; i < m; ++i) {
+        assert(local_color[i] >= 0);
+        const std::size_t id = dist.original_id(i);
+        ++held[id];
+        owner[id] = rank;
+        color[id] = local_color[i];
+    }
+    MPI_Allreduce(MPI_IN_PLACE, held.data(), static_cast<int>(n), MPI_INT, MPI_SUM, dist.comm());
+    MPI_Allreduce(MPI_IN_PLACE, owner.data(), static_cast<int>(n), MPI_INT, MPI_MAX, dist.comm());
+    MPI_Allreduce(MPI_IN_PLACE, color.data(), static_cast<int>(n), MPI_INT, MPI_MAX, dist.comm());
+    MPI_Allreduce(MPI_IN_PLACE, boundary.data(), static_cast<int>(n), MPI_INT, MPI_MAX, dist.comm());
+    for (int count : held) {
+        assert(count == 1);
+    }
+
+    // Coupled spins never share a color, and a spin is on the boundary
+    // exactly when it couples to another rank.
+    std::vector<int> crosses(n, 0);
+    for (const auto &edge : global.edges()) {
+        assert(color[edge.i] != color[edge.j]);
+        if (owner[edge.i] != owner[edge.j]) {
+            crosses[edge.i] = crosses[edge.j] = 1;
+        }
+    }
+    assert(boundary == crosses);
+
+    // After a halo exchange the ghosts hold the neighbors' spins: local
+    // deltas and the summed energy match the full Hamiltonian.
+    std::mt19937_64 rng(29);
+    for (int round = 0; round < 4; ++round) {
+        qanneal::State state(n);
+        for (auto &s : state.spins) {
+            s = (rng() & 1U) ? int8_t{1} : int8_t{-1};
+        }
+        std::vector<int8_t> local(dist.local_size(), 0);
+        for (std::size_t i = 0; i < m; ++i) {
+            local[i] = state.spins[dist.original_id(i)];
+        }
+        dist.exchange_all(local.data());
+        for (std::size_t i = 0; i < m; ++i) {
+            assert(std::abs(dist.delta_energy(local.data(), i) - global.delta_energy(state, dist.original_id(i))) < 1e-9);
+        }
+        assert(std::abs(dist.energy(local.data()) - global.energy(state)) < 1e-9);
+
+        const qanneal::State gathered = dist.gather_state(local.data());
+        if (rank == 0) {
+            assert(gathered.spins == state.spins);
+        } else {
+            assert(gathered.size() == 0);
+        }
+    }
+
+    // The annealer's best state, reassembled, has the energy it reports.
+    const auto schedule = qanneal::AnnealSchedule::linear(0.1, 3.0, 20);
+    const auto summary = qanneal::mpi::run_distributed_anneal(dist, schedule, 2, 7);
+    assert(summary.energy_trace.size() == schedule.size());
+    assert(summary.best_local_spins.size() == m);
+    const qanneal::State best = dist.gather_state(summary.best_local_spins.data());
+    if (rank == 0) {
+        assert(std::abs(global.energy(best) - summary.best_energy) < 1e-9);
+    }
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    qanneal::mpi::MPIContext ctx(argc, argv);
+    const int rank = ctx.rank();
+    const int size = ctx.size();
+    const auto global = problem();
+    const std::size_t n = global.size();
+
+    // Every rank partitions its own copy.
+    qanneal::mpi::DistributedSparseIsing everywhere(global);
+    check(everywhere, global);
+
+    // One rank partitions and scatters; the pieces match.
+    for (int root : {0, size - 1}) {
+        qanneal::mpi::DistributedSparseIsing scattered(rank == root ? &global : nullptr, MPI_COMM_WORLD, root);
+        assert(scattered.num_owned() == everywhere.num_owned());
+        assert(scattered.num_ghosts() == everywhere.num_ghosts());
+        assert(scattered.num_colors() == everywhere.num_colors());
+        for (std::size_t i = 0; i < scattered.num_owned(); ++i) {
+            assert(scattered.original_id(i) == everywhere.original_id(i));
+        }
+        check(scattered, global);
+    }
+
+    // Without the Hamiltonian on the root, every rank throws.
+    {
+        bool threw = false;
+        try {
+            qanneal::mpi::DistributedSparseIsing missing(nullptr);
+        } catch (const std::exception &) {
+            threw = true;
+        }
+        assert(threw);
+    }
+
+    // Pre-partitioned: contiguous blocks in the original labels.
+    {
+        std::vector<std::size_t> offsets(static_cast<std::size_t>(size) + 1);
+        for (std::size_t p = 0; p < offsets.size(); ++p) {
+            offsets[p] = p * n / static_cast<std::size_t>(size);
+        }
+        const std::size_t first = offsets[static_cast<std::size_t>(rank)];
+        const std::size_t end = offsets[static_cast<std::size_t>(rank) + 1];
+        std::vector<double> h(global.h().begin() + static_cast<std::ptrdiff_t>(first),
+                              global.h().begin() + static_cast<std::ptrdiff_t>(end));
+        std::vector<qanneal::SparseEdge> edges;
+        for (const auto &edge : global.edges()) {
+            if ((edge.i >= first && edge.i < end) || (edge.j >= first && edge.j < end)) {
+                edges.push_back(edge);
+            }
+        }
+        qanneal::mpi::DistributedSparseIsing blocks(offsets, h, edges, MPI_COMM_WORLD, global.constant());
+        check(blocks, global);
+    }
+
+    return 0;
+}
@@ -0,0 +1,126 @@
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include "qanneal/mpi/mpi_context.hpp"
+#include "qanneal/mpi/mpi_hybrid.hpp"
+#include "qanneal/replica_annealer.hpp"
+#include "qanneal/schedule.hpp"
+#include "qanneal/sparse_ising.hpp"
+
+namespace {
+
+// Forwards to a SparseIsing, or throws when asked to, so one rank's
+// workers can fail while the others succeed.
+class Faulty final : public qanneal::Hamiltonian {
+public:
+    Faulty(const qanneal::SparseIsing &inner, bool fail) : inner_(inner), fail_(fail) {}
+
+    double energy(const int8_t *spins, std::size_t n) const override {
+        if (fail_) {
+            throw std::runtime_error("Faulty Hamiltonian.");
+        }
+        return inner_.energy(spins, n);
+    }
+    double delta_energy(const int8_t *spins, std::size_t n, std::size_t flip) const override {
+        return inner_.delta_energy(spins, n, flip);
+    }
+    std::size_t size() const override { return inner_.size(); }
+
+private:
+    const qanneal::SparseIsing &inner_;
+    bool fail_;
+};
+
+qanneal::SparseIsing ring(std::size_t n) {
+    std::vector<qanneal::SparseEdge> edges;
+    for (std::size_t i = 0; i < n; ++i) {
+        edges.push_back({i, (i + 1) % n, (i % 3 == 0) ? -1.0 : 0.5});
+        edges.push_back({i, (i + 5) % n, (i % 2 == 0) ? 0.25 : -0.75});
+    }
+    return qanneal::SparseIsing(std::vector<double>(n, 0.1), edges, n);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    qanneal::mpi::MPIContext ctx(argc, argv);
+    const int rank = ctx.rank();
+    const int size = ctx.size();
+    const auto ham = ring(24);
+    const auto schedule = qanneal::AnnealSchedule::linear(0.1, 3.0, 30);
+
+    // Layout: the rank and node split are consistent, and each worker has
+    // a core (or none, unpinned).
+    {
+        qanneal::mpi::HybridOptions options;
+        options.threads = 3;
+        const auto layout = qanneal::mpi::discover_layout(options);
+        assert(layout.rank == rank && layout.size == size);
+        assert(layout.node_rank >= 0 && layout.node_rank < layout.node_size && layout.node_size <= size);
+        assert(layout.threads == 3 && layout.cores.size() == 3);
+        for (int core : layout.cores) {
+            assert(core >= -1);
+        }
+        // Node ranks run 0..node_size-1: as many ranks lead a node as end one.
+        int ends[2] = {layout.node_rank == 0 ? 1 : 0, layout.node_rank == layout.node_size - 1 ? 1 : 0};
+        MPI_Allreduce(MPI_IN_PLACE, ends, 2, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+        assert(ends[0] >= 1 && ends[0] == ends[1]);
+
+        options.pin_threads = false;
+        options.threads = 0;
+        const auto unpinned = qanneal::mpi::discover_layout(options);
+        assert(unpinned.threads >= 1 && unpinned.cores.size() == unpinned.threads);
+        for (int core : unpinned.cores) {
+            assert(core == -1);
+        }
+    }
+
+    // Result: each rank's best is the best of its workers, run serially
+    // with the same seeds and replica split, and the global best is the
+    // lowest of them with its true energy.
+    {
+        qanneal::mpi::HybridOptions options;
+        options.threads = 2;
+        const std::size_t replicas = 5;
+        const std::uint64_t seed = 17;
+        const auto summary =
+            qanneal::mpi::run_hybrid_replica_anneal(ham, schedule, 2, replicas, seed, MPI_COMM_WORLD, options);
+        assert(summary.rank == rank && summary.size == size);
+        assert(summary.layout.threads == 2);
+
+        double expected = INFINITY;
+        for (std::size_t t = 0; t < 2; ++t) {
+            qanneal::ReplicaAnnealer annealer(ham, schedule, t == 0 ? 3 : 2);
+            annealer.set_seed(seed + 2 * static_cast<std::uint64_t>(rank) + t);
+            expected = std::min(expected, annealer.run(2).global_best_energy);
+        }
+        assert(summary.local_best_energy == expected);
+        assert(std::abs(summary.local_best_energy - ham.energy(summary.local_best_state)) < 1e-9);
+
+        double lowest = summary.local_best_energy;
+        MPI_Allreduce(MPI_IN_PLACE, &lowest, 1, MPI_DOUBLE, MPI_MIN, MPI_COMM_WORLD);
+        assert(summary.global_best_energy == lowest);
+        assert(std::abs(summary.global_best_energy - ham.energy(summary.global_best_state)) < 1e-9);
+    }
+
+    // A worker failing on one rank fails every rank instead of leaving the
+    // others waiting in the reduction.
+    {
+        const Faulty faulty(ham, rank == size - 1);
+        qanneal::mpi::HybridOptions options;
+        options.threads = 2;
+        bool threw = false;
+        try {
+            qanneal::mpi::run_hybrid_replica_anneal(faulty, schedule, 1, 4, 3, MPI_COMM_WORLD, options);
+        } catch (const std::runtime_error &) {
+            threw = true;
+        }
+        assert(threw);
+    }
+
+    return 0;
+}
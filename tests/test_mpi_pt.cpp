@@ -0,0 +1,79 @@
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "qanneal/mpi/mpi_context.hpp"
+#include "qanneal/mpi/mpi_parallel_tempering.hpp"
+#include "qanneal/sparse_ising.hpp"
+
+namespace {
+
+// 6 x 6 periodic +-J glass; integer couplings keep energies exact.
+qanneal::SparseIsing lattice() {
+    const std::size_t side = 6;
+    const std::size_t n = side * side;
+    std::vector<qanneal::SparseEdge> edges;
+    for (std::size_t r = 0; r < side; ++r) {
+        for (std::size_t c = 0; c < side; ++c) {
+            const std::size_t i = r * side + c;
+            edges.push_back({i, r * side + (c + 1) % side, ((i * 7) % 5 < 2) ? 1.0 : -1.0});
+            edges.push_back({i, ((r + 1) % side) * side + c, ((i * 11) % 7 < 3) ? 1.0 : -1.0});
+        }
+    }
+    return qanneal::SparseIsing(std::vector<double>(n, 0.0), edges, n);
+}
+
+void check(const qanneal::SparseIsing &ham, std::size_t T, std::size_t steps, std::size_t interval) {
+    std::vector<double> betas(T);
+    for (std::size_t t = 0; t < T; ++t) {
+        betas[t] = 0.2 * std::pow(10.0, static_cast<double>(t) / static_cast<double>(T - 1));
+    }
+    const auto summary = qanneal::mpi::run_parallel_tempering(ham, betas, 2, steps, interval, 42);
+
+    // Every temperature is held by exactly one replica somewhere.
+    std::vector<int> held(T, 0);
+    assert(summary.local_temperatures.size() == summary.local_energies.size());
+    for (std::size_t k = 0; k < summary.local_temperatures.size(); ++k) {
+        const std::size_t t = summary.local_temperatures[k];
+        assert(t < T);
+        ++held[t];
+        assert(summary.temperature_energies[t] == summary.local_energies[k]);
+    }
+    MPI_Allreduce(MPI_IN_PLACE, held.data(), static_cast<int>(T), MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+    for (int count : held) {
+        assert(count == 1);
+    }
+
+    // Round k pairs (l, l + 1) for l of parity k % 2.
+    const std::size_t rounds = steps / interval;
+    assert(summary.swap_attempts.size() == T - 1 && summary.swap_accepts.size() == T - 1);
+    for (std::size_t l = 0; l + 1 < T; ++l) {
+        const std::size_t expected = (l % 2 == 0) ? (rounds + 1) / 2 : rounds / 2;
+        assert(summary.swap_attempts[l] == expected);
+        assert(summary.swap_accepts[l] <= summary.swap_attempts[l]);
+    }
+
+    assert(summary.global_best_state.size() == ham.size());
+    assert(summary.global_best_energy == ham.energy(summary.global_best_state));
+
+    // A fixed seed repeats the whole run.
+    const auto again = qanneal::mpi::run_parallel_tempering(ham, betas, 2, steps, interval, 42);
+    assert(again.local_temperatures == summary.local_temperatures);
+    assert(again.temperature_energies == summary.temperature_energies);
+    assert(again.swap_accepts == summary.swap_accepts);
+    assert(again.global_best_energy == summary.global_best_energy);
+    assert(again.global_best_state.spins == summary.global_best_state.spins);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    qanneal::mpi::MPIContext ctx(argc, argv);
+    const auto ham = lattice();
+
+    check(ham, 8, 60, 1);
+    // Uneven blocks, and swap steps between plain ones.
+    check(ham, 7, 61, 3);
+    return 0;
+}
@@ -0,0 +1,85 @@
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "qanneal/mpi/mpi_context.hpp"
+#include "qanneal/mpi/mpi_replica.hpp"
+#include "qanneal/schedule.hpp"
+#include "qanneal/sparse_ising.hpp"
+
+namespace {
+
+qanneal::SparseIsing ring(std::size_t n) {
+    std::vector<qanneal::SparseEdge> edges;
+    for (std::size_t i = 0; i < n; ++i) {
+        edges.push_back({i, (i + 1) % n, (i % 3 == 0) ? -1.0 : 0.5});
+        edges.push_back({i, (i + 7) % n, (i % 2 == 0) ? 0.25 : -0.75});
+    }
+    return qanneal::SparseIsing(std::vector<double>(n, -0.1), edges, n);
+}
+
+void check_best(const qanneal::mpi::MPIReplicaSummary &summary, const qanneal::SparseIsing &ham) {
+    assert(std::abs(summary.local_best_energy - ham.energy(summary.local_best_state)) < 1e-9);
+    double lowest = summary.local_best_energy;
+    MPI_Allreduce(MPI_IN_PLACE, &lowest, 1, MPI_DOUBLE, MPI_MIN, MPI_COMM_WORLD);
+    assert(summary.global_best_energy == lowest);
+    assert(std::abs(summary.global_best_energy - ham.energy(summary.global_best_state)) < 1e-9);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    qanneal::mpi::MPIContext ctx(argc, argv);
+    const int rank = ctx.rank();
+    const int size = ctx.size();
+    const auto ham = ring(32);
+    const std::size_t steps = 40;
+    const auto schedule = qanneal::AnnealSchedule::linear(0.1, 3.0, steps);
+    const std::size_t replicas = 6;
+
+    // Isolated ranks exchange nothing.
+    {
+        const auto summary = qanneal::mpi::run_replica_anneal(ham, schedule, 1, replicas, 5);
+        assert(summary.rank == rank && summary.size == size);
+        assert(summary.migrants_received == 0 && summary.migrants_accepted == 0);
+        check_best(summary, ham);
+    }
+
+    for (auto topology : {qanneal::mpi::IslandTopology::Ring, qanneal::mpi::IslandTopology::Random}) {
+        for (std::size_t interval : {1, 3, 8}) {
+            qanneal::mpi::IslandOptions island;
+            island.interval = interval;
+            island.migrants = 2;
+            island.topology = topology;
+            const auto summary = qanneal::mpi::run_replica_anneal(ham, schedule, 1, replicas, 9, MPI_COMM_WORLD, island);
+
+            // The hook runs after every step but the last, and a migration
+            // sent after step s is received after step s + 1.
+            const std::size_t migrations = size > 1 ? (steps - 2) / interval : 0;
+            assert(summary.migrants_received == island.migrants * migrations);
+            assert(summary.migrants_accepted <= summary.migrants_received);
+            check_best(summary, ham);
+
+            // A fixed seed repeats the run, random neighbors included.
+            const auto again = qanneal::mpi::run_replica_anneal(ham, schedule, 1, replicas, 9, MPI_COMM_WORLD, island);
+            assert(again.migrants_accepted == summary.migrants_accepted);
+            assert(again.local_best_energy == summary.local_best_energy);
+            assert(again.global_best_state.spins == summary.global_best_state.spins);
+        }
+    }
+
+    // More migrants than replicas sends every replica.
+    {
+        qanneal::mpi::IslandOptions island;
+        island.interval = 4;
+        island.migrants = 10;
+        const auto summary = qanneal::mpi::run_replica_anneal(ham, schedule, 1, 3, 2, MPI_COMM_WORLD, island);
+        const std::size_t migrations = size > 1 ? (steps - 2) / island.interval : 0;
+        assert(summary.migrants_received == 3 * migrations);
+        assert(summary.migrants_accepted <= summary.migrants_received);
+        check_best(summary, ham);
+    }
+
+    return 0;
+}
@@ -0,0 +1,110 @@
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+#include "qanneal/annealer.hpp"
+#include "qanneal/mpi/mpi_context.hpp"
+#include "qanneal/mpi/mpi_restart_scheduler.hpp"
+#include "qanneal/schedule.hpp"
+#include "qanneal/sparse_ising.hpp"
+
+namespace {
+
+// Forwards to a SparseIsing, or throws when asked to, so the restarts of
+// one rank can fail while the others succeed.
+class Faulty final : public qanneal::Hamiltonian {
+public:
+    Faulty(const qanneal::SparseIsing &inner, bool fail) : inner_(inner), fail_(fail) {}
+
+    double energy(const int8_t *spins, std::size_t n) const override {
+        if (fail_) {
+            throw std::runtime_error("Faulty Hamiltonian.");
+        }
+        return inner_.energy(spins, n);
+    }
+    double delta_energy(const int8_t *spins, std::size_t n, std::size_t flip) const override {
+        return inner_.delta_energy(spins, n, flip);
+    }
+    std::size_t size() const override { return inner_.size(); }
+
+private:
+    const qanneal::SparseIsing &inner_;
+    bool fail_;
+};
+
+qanneal::SparseIsing ring(std::size_t n) {
+    std::vector<qanneal::SparseEdge> edges;
+    for (std::size_t i = 0; i < n; ++i) {
+        edges.push_back({i, (i + 1) % n, (i % 3 == 0) ? -1.0 : 0.5});
+        edges.push_back({i, (i + 4) % n, (i % 2 == 0) ? 0.25 : -0.75});
+    }
+    return qanneal::SparseIsing(std::vector<double>(n, 0.05), edges, n);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    qanneal::mpi::MPIContext ctx(argc, argv);
+    const int rank = ctx.rank();
+    const int size = ctx.size();
+    const auto ham = ring(20);
+    const auto schedule = qanneal::AnnealSchedule::linear(0.1, 3.0, 25);
+
+    // Every restart runs once, wherever it lands, and the best is the
+    // one a serial run of the same seeds finds.
+    for (std::size_t batch : {1, 3}) {
+        qanneal::mpi::RestartSchedulerOptions options;
+        options.restarts = 10;
+        options.batch = batch;
+        options.seed = 100;
+        const auto summary = qanneal::mpi::run_scheduled_restarts(ham, schedule, 2, options);
+        assert(summary.rank == rank && summary.size == size);
+        assert(summary.stop_reason == qanneal::StopReason::Completed);
+        assert(summary.restarts_completed == options.restarts);
+        assert(summary.restarts_per_rank.size() == static_cast<std::size_t>(size));
+        assert(summary.busy_seconds_per_rank.size() == static_cast<std::size_t>(size));
+        assert(std::accumulate(summary.restarts_per_rank.begin(), summary.restarts_per_rank.end(),
+                               std::size_t{0}) == options.restarts);
+        assert(summary.restarts_per_rank[static_cast<std::size_t>(rank)] == summary.local_restarts);
+
+        double lowest = INFINITY;
+        for (std::size_t r = 0; r < options.restarts; ++r) {
+            qanneal::Annealer annealer(ham, schedule);
+            annealer.set_seed(options.seed + r);
+            lowest = std::min(lowest, annealer.run(2).best_energy);
+        }
+        assert(summary.global_best_energy == lowest);
+
+        assert(summary.best_restart < options.restarts);
+        qanneal::Annealer annealer(ham, schedule);
+        annealer.set_seed(options.seed + summary.best_restart);
+        const auto again = annealer.run(2);
+        assert(again.best_energy == summary.global_best_energy);
+        assert(again.best_state.spins == summary.global_best_state.spins);
+        assert(std::abs(ham.energy(summary.global_best_state) - summary.global_best_energy) < 1e-9);
+    }
+
+    // A Hamiltonian that throws on one rank, worker or scheduler, makes
+    // every rank throw.
+    for (int failing : {size - 1, 0}) {
+        const Faulty faulty(ham, rank == failing);
+        qanneal::mpi::RestartSchedulerOptions options;
+        // Enough restarts that every rank gets some before the failure
+        // stops the handout.
+        options.restarts = 200;
+        options.seed = 7;
+        bool threw = false;
+        try {
+            qanneal::mpi::run_scheduled_restarts(faulty, schedule, 1, options);
+        } catch (const std::runtime_error &) {
+            threw = true;
+        }
+        assert(threw);
+    }
+
+    return 0;
+}
@@ -0,0 +1,155 @@
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "qanneal/dense_ising.hpp"
+#include "qanneal/mpi/mpi_context.hpp"
+#include "qanneal/mpi/mpi_shared_hamiltonian.hpp"
+#include "qanneal/sparse_ising.hpp"
+
+namespace {
+
+constexpr std::size_t kSpins = 14;
+
+bool node_leader() {
+    int rank = 0;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm node;
+    MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, rank, MPI_INFO_NULL, &node);
+    int node_rank = 0;
+    MPI_Comm_rank(node, &node_rank);
+    MPI_Comm_free(&node);
+    return node_rank == 0;
+}
+
+qanneal::DenseIsing dense_problem() {
+    std::mt19937_64 rng(5);
+    std::uniform_real_distribution<double> coeff(-1.0, 1.0);
+    std::vector<double> h(kSpins);
+    for (double &v : h) {
+        v = coeff(rng);
+    }
+    std::vector<double> J(kSpins * kSpins, 0.0);
+    for (std::size_t i = 0; i < kSpins; ++i) {
+        for (std::size_t j = i + 1; j < kSpins; ++j) {
+            // Some zero couplings, which the graph leaves out.
+            const double value = (i + j) % 4 == 0 ? 0.0 : coeff(rng);
+            J[i * kSpins + j] = J[j * kSpins + i] = value;
+        }
+    }
+    return qanneal::DenseIsing(h, J, kSpins, 0.5);
+}
+
+qanneal::SparseIsing sparse_problem() {
+    std::mt19937_64 rng(6);
+    std::uniform_real_distribution<double> coeff(-1.0, 1.0);
+    std::vector<double> h(kSpins);
+    for (double &v : h) {
+        v = coeff(rng);
+    }
+    std::vector<qanneal::SparseEdge> edges;
+    for (std::size_t i = 0; i < kSpins; ++i) {
+        edges.push_back({i, (i + 1) % kSpins, coeff(rng)});
+        edges.push_back({i, (i + 5) % kSpins, i % 3 == 0 ? 0.0 : coeff(rng)});
+    }
+    return qanneal::SparseIsing(h, edges, kSpins, -1.25);
+}
+
+// Each row's (neighbor, weight) pairs, sorted: the shared graph may list
+// a row in another order than the source.
+std::vector<std::vector<std::pair<std::size_t, double>>> rows(const qanneal::CouplingGraph &graph) {
+    std::vector<std::vector<std::pair<std::size_t, double>>> out(graph.size());
+    for (std::size_t i = 0; i < graph.size(); ++i) {
+        for (std::size_t k = graph.offsets[i]; k < graph.offsets[i + 1]; ++k) {
+            out[i].emplace_back(graph.neighbors[k], graph.weights[k]);
+        }
+        std::sort(out[i].begin(), out[i].end());
+    }
+    return out;
+}
+
+void check_same(const qanneal::Hamiltonian &shared, const qanneal::Hamiltonian &source) {
+    assert(shared.size() == source.size());
+    std::mt19937_64 rng(31);
+    for (int round = 0; round < 20; ++round) {
+        qanneal::State state(kSpins);
+        for (auto &s : state.spins) {
+            s = (rng() & 1U) ? int8_t{1} : int8_t{-1};
+        }
+        assert(std::abs(shared.energy(state) - source.energy(state)) < 1e-12);
+        for (std::size_t i = 0; i < kSpins; ++i) {
+            assert(std::abs(shared.delta_energy(state, i) - source.delta_energy(state, i)) < 1e-12);
+        }
+    }
+    const auto graph = shared.coupling_graph();
+    const auto expected = source.coupling_graph();
+    assert(graph.h == expected.h);
+    assert(graph.offsets == expected.offsets);
+    assert(rows(graph) == rows(expected));
+}
+
+template <typename F>
+bool throws(F &&f) {
+    try {
+        f();
+    } catch (const std::exception &) {
+        return true;
+    }
+    return false;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    qanneal::mpi::MPIContext ctx(argc, argv);
+    const bool leader = node_leader();
+    const auto dense = dense_problem();
+    const auto sparse = sparse_problem();
+
+    // Copies, read on the node leaders only.
+    {
+        qanneal::mpi::SharedDenseIsing shared(leader ? &dense : nullptr);
+        assert(shared.constant() == dense.constant());
+        check_same(shared, dense);
+    }
+    {
+        qanneal::mpi::SharedSparseIsing shared(leader ? &sparse : nullptr);
+        assert(shared.constant() == sparse.constant());
+        check_same(shared, sparse);
+    }
+
+    // Filled in place by a callback.
+    {
+        qanneal::mpi::SharedDenseIsing shared(
+            kSpins,
+            [&](double *h, double *J) {
+                std::copy(dense.h().begin(), dense.h().end(), h);
+                std::copy(dense.J().begin(), dense.J().end(), J);
+            },
+            dense.constant());
+        check_same(shared, dense);
+    }
+
+    // Failures on the leaders reach every rank instead of leaving the
+    // others waiting on the window.
+    assert(throws([&] {
+        qanneal::mpi::SharedDenseIsing shared(kSpins, [](double *, double *) {
+            throw std::runtime_error("fill failed");
+        });
+    }));
+    assert(throws([] { qanneal::mpi::SharedDenseIsing shared(nullptr); }));
+    assert(throws([] { qanneal::mpi::SharedSparseIsing shared(nullptr); }));
+
+    // Still usable afterwards: no rank was left inside a collective.
+    {
+        qanneal::mpi::SharedSparseIsing shared(&sparse);
+        check_same(shared, sparse);
+    }
+
+    return 0;
+}
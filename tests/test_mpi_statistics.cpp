@@ -0,0 +1,151 @@
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "qanneal/energy_histogram.hpp"
+#include "qanneal/mpi/mpi_context.hpp"
+#include "qanneal/mpi/mpi_statistics.hpp"
+#include "qanneal/sample_set.hpp"
+#include "qanneal/state.hpp"
+
+namespace {
+
+constexpr std::size_t kSpins = 5;
+
+// What rank `r` contributes; every rank can rebuild any rank's share, so
+// each checks the reduction against a serial merge of all of them.
+std::vector<std::vector<double>> traces_of(int r) {
+    std::mt19937_64 rng(100 + static_cast<std::uint64_t>(r));
+    std::normal_distribution<double> normal(-50.0, 3.0);
+    std::vector<std::vector<double>> traces(static_cast<std::size_t>(r % 3 + 1));
+    for (std::size_t k = 0; k < traces.size(); ++k) {
+        traces[k].resize(4 + (static_cast<std::size_t>(r) + k) % 5);
+        for (double &e : traces[k]) {
+            e = normal(rng);
+        }
+    }
+    return traces;
+}
+
+qanneal::EnergyHistogram histogram_of(int r) {
+    qanneal::EnergyHistogram hist(-56.0, -44.0, 6, -52.0);
+    for (const auto &trace : traces_of(r)) {
+        for (double e : trace) {
+            hist.add(e);
+        }
+    }
+    return hist;
+}
+
+qanneal::SampleSet samples_of(int r, std::size_t capacity) {
+    qanneal::SampleSet set(kSpins, capacity);
+    std::mt19937_64 rng(200 + static_cast<std::uint64_t>(r));
+    std::uniform_int_distribution<int> pick(0, (1 << kSpins) - 1);
+    for (int k = 0; k < 12; ++k) {
+        const int bits = pick(rng);
+        qanneal::State state(kSpins);
+        double energy = 0.0;
+        for (std::size_t i = 0; i < kSpins; ++i) {
+            state.spins[i] = (bits >> i) & 1 ? 1 : -1;
+            energy += static_cast<double>(state.spins[i]) * static_cast<double>(i + 1);
+        }
+        set.add(state, energy);
+    }
+    return set;
+}
+
+void check_sample_sets(int size, std::size_t capacity) {
+    qanneal::SampleSet expected = samples_of(0, capacity);
+    for (int r = 1; r < size; ++r) {
+        expected.merge(samples_of(r, capacity));
+    }
+    int rank = 0;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    qanneal::SampleSet merged = samples_of(rank, capacity);
+    qanneal::mpi::allreduce_sample_set(merged);
+
+    assert(merged.offered() == expected.offered());
+    const auto got = merged.samples();
+    const auto want = expected.samples();
+    assert(got.size() == want.size());
+    // Which states survive does not depend on the merge order; their counts
+    // only do when some were evicted along the way.
+    const bool evicted = want.size() == capacity;
+    for (std::size_t k = 0; k < got.size(); ++k) {
+        assert(got[k].state.spins == want[k].state.spins);
+        assert(got[k].energy == want[k].energy);
+        assert(evicted || got[k].count == want[k].count);
+    }
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    qanneal::mpi::MPIContext ctx(argc, argv);
+    const int rank = ctx.rank();
+    const int size = ctx.size();
+
+    // Histograms add bin by bin.
+    {
+        qanneal::EnergyHistogram expected = histogram_of(0);
+        for (int r = 1; r < size; ++r) {
+            expected.merge(histogram_of(r));
+        }
+        qanneal::EnergyHistogram merged = histogram_of(rank);
+        qanneal::mpi::allreduce_histogram(merged);
+        assert(merged.counts == expected.counts);
+        assert(merged.underflow == expected.underflow && merged.overflow == expected.overflow);
+        assert(merged.hits == expected.hits);
+        assert(merged.min_energy == expected.min_energy && merged.max_energy == expected.max_energy);
+    }
+
+    // Per-step statistics over traces of different lengths on every rank,
+    // against a direct two-pass computation.
+    {
+        std::vector<std::vector<double>> all;
+        for (int r = 0; r < size; ++r) {
+            for (auto &trace : traces_of(r)) {
+                all.push_back(std::move(trace));
+            }
+        }
+        const auto stats = qanneal::mpi::allreduce_traces(traces_of(rank));
+        std::size_t steps = 0;
+        for (const auto &trace : all) {
+            steps = std::max(steps, trace.size());
+        }
+        assert(stats.counts.size() == steps);
+        for (std::size_t t = 0; t < steps; ++t) {
+            std::vector<double> column;
+            for (const auto &trace : all) {
+                if (t < trace.size()) {
+                    column.push_back(trace[t]);
+                }
+            }
+            double mean = 0.0;
+            for (double e : column) {
+                mean += e;
+            }
+            mean /= static_cast<double>(column.size());
+            double m2 = 0.0;
+            for (double e : column) {
+                m2 += (e - mean) * (e - mean);
+            }
+            const double stddev = std::sqrt(m2 / static_cast<double>(column.size()));
+            assert(stats.counts[t] == column.size());
+            assert(std::abs(stats.mean[t] - mean) < 1e-9);
+            assert(std::abs(stats.stddev[t] - stddev) < 1e-9);
+            assert(stats.min[t] == *std::min_element(column.begin(), column.end()));
+            assert(stats.max[t] == *std::max_element(column.begin(), column.end()));
+        }
+    }
+
+    // Sample sets: room for every distinct state, then a capacity that
+    // forces evictions during the reduction.
+    check_sample_sets(size, 2 << kSpins);
+    check_sample_sets(size, 3);
+
+    return 0;
+}
@@ -0,0 +1,52 @@
+#include <cassert>
+#include <cmath>
+
+#include "qanneal/dense_ising.hpp"
+#include "qanneal/population_annealer.hpp"
+#include "qanneal/schedule.hpp"
+
+int main() {
+    const std::size_t n = 3;
+    std::vector<double> h = {0.1, -0.1, 0.2};
+    std::vector<double> J = {
+        0.0, 0.4, 0.0,
+        0.4, 0.0, -0.2,
+        0.0, -0.2, 0.0
+    };
+
+    qanneal::DenseIsing ham(h, J, n);
+    auto schedule = qanneal::AnnealSchedule::linear(0.1, 1.0, 10);
+
+    qanneal::PopulationAnnealer annealer(ham, schedule, 2000);
+    annealer.set_seed(11);
+    auto result = annealer.run(2);
+
+    assert(result.final_states.size() == 2000);
+    assert(result.average_energy_trace.size() == schedule.size());
+    assert(result.free_energy_trace.size() == schedule.size());
+    assert(result.family_count_trace.size() == schedule.size());
+    assert(result.surviving_families > 0);
+    assert(result.surviving_families <= 2000);
+
+    const double e = ham.energy(result.best_state);
+    assert(std::abs(e - result.best_energy) < 1e-12);
+    for (std::size_t r = 0; r < result.final_states.size(); ++r) {
+        const double er = ham.energy(result.final_states[r]);
+        assert(std::abs(er - result.final_energies[r]) < 1e-9);
+    }
+
+    // Exact ln Z at the final beta by enumeration.
+    const double beta = schedule.betas.back();
+    double z = 0.0;
+    qanneal::State s(n);
+    for (std::size_t mask = 0; mask < (1u << n); ++mask) {
+        for (std::size_t i = 0; i < n; ++i) {
+            s[i] = (mask >> i) & 1u ? 1 : -1;
+        }
+        z += std::exp(-beta * ham.energy(s));
+    }
+    assert(std::abs(result.log_partition - std::log(z)) < 0.05);
+    assert(std::abs(result.free_energy_trace.back() + std::log(z) / beta) < 0.05);
+
+    return 0;
+}
@@ -0,0 +1,74 @@
+#include <cassert>
+#include <cmath>
+
+#include "qanneal/annealer.hpp"
+#include "qanneal/dense_ising.hpp"
+#include "qanneal/metrics_observer.hpp"
+#include "qanneal/rejection_free.hpp"
+#include "qanneal/schedule.hpp"
+
+int main() {
+    qanneal::RateTree tree(5);
+    const double rates[] = {0.5, 0.0, 1.0, 0.25, 0.25};
+    for (std::size_t i = 0; i < 5; ++i) {
+        tree.set(i, rates[i]);
+    }
+    assert(std::abs(tree.total() - 2.0) < 1e-12);
+    assert(tree.sample(0.0) == 0);
+    assert(tree.sample(0.49) == 0);
+    assert(tree.sample(0.5) == 2);
+    assert(tree.sample(1.6) == 3);
+    assert(tree.sample(1.99) == 4);
+    tree.set(2, 0.0);
+    tree.rebuild();
+    assert(std::abs(tree.total() - 1.0) < 1e-12);
+    assert(tree.sample(0.6) == 3);
+
+    const std::size_t n = 6;
+    std::vector<double> h = {0.1, -0.2, 0.0, 0.3, -0.1, 0.2};
+    std::vector<double> J(n * n, 0.0);
+    for (std::size_t i = 0; i < n; ++i) {
+        for (std::size_t j = i + 1; j < n; ++j) {
+            const double v = ((i + 2 * j) % 3 == 0) ? 0.5 : -0.3;
+            J[i * n + j] = v;
+            J[j * n + i] = v;
+        }
+    }
+    qanneal::DenseIsing ham(h, J, n);
+
+    std::mt19937_64 rng(17);
+    qanneal::RejectionFreeSampler sampler(ham.coupling_graph());
+    auto state = qanneal::State::random(n, rng);
+    double energy = ham.energy(state);
+    sampler.reset(state, 2.0);
+    std::size_t flipped = n;
+    for (int k = 0; k < 200; ++k) {
+        sampler.step(state, energy, 1e9, rng, flipped);
+        assert(flipped < n);
+        assert(std::abs(ham.energy(state) - energy) < 1e-9);
+    }
+
+    double ground = 1e300;
+    qanneal::State s(n);
+    for (std::size_t mask = 0; mask < (1u << n); ++mask) {
+        for (std::size_t i = 0; i < n; ++i) {
+            s[i] = (mask >> i) & 1u ? 1 : -1;
+        }
+        ground = std::min(ground, ham.energy(s));
+    }
+
+    auto schedule = qanneal::AnnealSchedule::linear(0.1, 5.0, 30);
+    qanneal::Annealer annealer(ham, schedule);
+    annealer.set_seed(4);
+    annealer.set_update_mode(qanneal::UpdateMode::Adaptive, 0.2);
+    qanneal::MetricsObserver observer;
+    auto result = annealer.run(10, &observer);
+
+    assert(result.acceptance_trace.size() == schedule.size());
+    assert(result.rejection_free_step < schedule.size());
+    assert(std::abs(ham.energy(result.best_state) - result.best_energy) < 1e-9);
+    assert(std::abs(result.best_energy - ground) < 1e-9);
+    assert(std::abs(observer.energy_trace.back() - result.energy_trace.back()) < 1e-12);
+
+    return 0;
+}
@@ -1,4 +1,6 @@
 #include <cassert>
+#include <cmath>
+#include <vector>
 
 #include "qanneal/dense_ising.hpp"
 #include "qanneal/replica_annealer.hpp"
@@ -24,5 +26,42 @@ int main() {
     assert(result.average_energy_trace.size() == schedule.size());
     assert(result.average_magnetization_trace.size() == schedule.size());
 
+    // Best states are rebuilt from the flip journal; they must match the
+    // recorded energies.
+    for (const auto &replica : result.replicas) {
+        assert(std::abs(ham.energy(replica.best_state) - replica.best_energy) < 1e-12);
+        assert(replica.best_energy >= result.global_best_energy);
+    }
+    assert(std::abs(ham.energy(result.global_best_state) - result.global_best_energy) < 1e-12);
+
+    // A migration hook runs between steps and its states count toward the
+    // bests: plant the ground state in replica 0.
+    qanneal::State ground(n);
+    double ground_energy = ham.energy(ground);
+    for (unsigned mask = 1; mask < (1u << n); ++mask) {
+        qanneal::State candidate(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            candidate.spins[i] = (mask >> i) & 1u ? -1 : 1;
+        }
+        if (ham.energy(candidate) < ground_energy) {
+            ground = candidate;
+            ground_energy = ham.energy(candidate);
+        }
+    }
+    std::vector<std::size_t> calls;
+    qanneal::ReplicaAnnealer migrating(ham, qanneal::AnnealSchedule::linear(0.01, 0.02, 6), 3);
+    migrating.set_seed(7);
+    migrating.set_migration(2, [&](std::size_t step, std::vector<qanneal::State> &states,
+                                   std::vector<double> &energies) {
+        calls.push_back(step);
+        assert(states.size() == 3 && energies.size() == 3);
+        states[0] = ground;
+        energies[0] = ground_energy;
+    });
+    auto migrated = migrating.run(1);
+    assert((calls == std::vector<std::size_t>{1, 3}));
+    assert(std::abs(migrated.global_best_energy - ground_energy) < 1e-12);
+    assert(std::abs(migrated.replicas[0].best_energy - ground_energy) < 1e-12);
+
     return 0;
 }
@@ -0,0 +1,226 @@
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "qanneal/annealer.hpp"
+#include "qanneal/dense_ising.hpp"
+#include "qanneal/parallel_tempering.hpp"
+#include "qanneal/population_annealer.hpp"
+#include "qanneal/replica_annealer.hpp"
+#include "qanneal/sample_set.hpp"
+#include "qanneal/schedule.hpp"
+#include "qanneal/sqa_annealer.hpp"
+
+namespace {
+
+std::uint64_t total_count(const qanneal::SampleSet &set) {
+    std::uint64_t total = 0;
+    for (const auto &sample : set.samples()) {
+        total += sample.count;
+    }
+    return total;
+}
+
+// Every kept sample carries its true energy, in increasing order.
+void check_samples(const qanneal::SampleSet &set, const qanneal::DenseIsing &ham) {
+    double last = -INFINITY;
+    for (const auto &sample : set.samples()) {
+        assert(std::abs(ham.energy(sample.state) - sample.energy) < 1e-9);
+        assert(sample.energy >= last);
+        last = sample.energy;
+    }
+}
+
+} // namespace
+
+int main() {
+    const std::size_t n = 8;
+
+    // Flipping a spin changes the hash by exactly its key, both ways.
+    {
+        qanneal::ZobristTable table(n, 7);
+        qanneal::State state(n);
+        std::uint64_t hash = table.hash(state);
+        assert(hash == 0);
+        for (std::size_t i : {3, 5, 3, 0}) {
+            state.spins[i] = static_cast<int8_t>(-state.spins[i]);
+            hash ^= table.key(i);
+            assert(hash == table.hash(state));
+        }
+        assert(qanneal::ZobristTable(n, 7).key(2) == table.key(2));
+        assert(qanneal::ZobristTable(n, 8).key(2) != table.key(2));
+    }
+
+    // Repeats are counted, not stored; a full set keeps the lowest energies.
+    {
+        qanneal::SampleSet set(n, 3);
+        std::vector<qanneal::State> states;
+        for (std::size_t k = 0; k < 5; ++k) {
+            qanneal::State state(n);
+            state.spins[k] = -1;
+            states.push_back(state);
+        }
+        set.add(states[0], 4.0);
+        set.add(states[0], 4.0);
+        set.add(states[1], 3.0);
+        set.add(states[2], 5.0);
+        assert(set.size() == 3);
+        assert(set.offered() == 4);
+        set.add(states[3], 6.0);  // worse than everything kept
+        assert(set.size() == 3);
+        set.add(states[4], 1.0);  // evicts the 5.0 state
+        assert(set.size() == 3);
+        assert(set.offered() == 6);
+
+        const auto samples = set.samples();
+        assert(samples[0].energy == 1.0 && samples[0].count == 1);
+        assert(samples[1].energy == 3.0);
+        assert(samples[2].energy == 4.0 && samples[2].count == 2);
+        assert(samples[2].state.spins == states[0].spins);
+
+        std::vector<int8_t> spins;
+        std::vector<double> energies;
+        std::vector<std::uint64_t> counts;
+        set.export_sorted(spins, energies, counts);
+        assert(spins.size() == 3 * n);
+        assert(energies == std::vector<double>({1.0, 3.0, 4.0}));
+        assert(counts == std::vector<std::uint64_t>({1, 1, 2}));
+        assert(spins[4] == -1);
+
+        // Merging sums counts of shared states and keeps offered() exact.
+        qanneal::SampleSet other(n, 3);
+        other.add(states[1], 3.0);
+        other.add(states[3], 0.5);  // evicts the 4.0 state
+        set.merge(other);
+        assert(set.offered() == 8);
+        const auto merged = set.samples();
+        assert(merged.size() == 3);
+        assert(merged[0].energy == 0.5);
+        assert(merged[2].energy == 3.0 && merged[2].count == 2);
+
+        bool threw = false;
+        try {
+            set.merge(qanneal::SampleSet(n, 3, 99));
+        } catch (const std::invalid_argument &) {
+            threw = true;
+        }
+        assert(threw);
+
+        // Merging a set into itself matches merging a copy of it.
+        qanneal::SampleSet copy = set;
+        copy.merge(qanneal::SampleSet(set));
+        set.merge(set);
+        assert(set.offered() == 16 && set.offered() == copy.offered());
+        const auto doubled = set.samples();
+        const auto expected = copy.samples();
+        assert(doubled.size() == expected.size());
+        for (std::size_t k = 0; k < doubled.size(); ++k) {
+            assert(doubled[k].count == expected[k].count && doubled[k].count == 2 * merged[k].count);
+            assert(doubled[k].state.spins == expected[k].state.spins);
+        }
+
+        set.clear();
+        assert(set.size() == 0 && set.offered() == 0);
+        set.add(states[1], 2.0);
+        assert(set.samples()[0].state.spins == states[1].spins);
+    }
+
+    // Engines offer every state they visit; with room for all of them no
+    // occurrence is lost and the energies match the Hamiltonian.
+    std::vector<double> h(n, 0.1);
+    std::vector<double> J(n * n, 0.0);
+    for (std::size_t i = 0; i < n; ++i) {
+        const std::size_t j = (i + 1) % n;
+        J[i * n + j] = J[j * n + i] = (i % 2 == 0) ? 0.7 : -0.5;
+    }
+    qanneal::DenseIsing ham(h, J, n);
+    const std::size_t steps = 12;
+    auto schedule = qanneal::AnnealSchedule::linear(0.2, 3.0, steps);
+    const std::size_t roomy = 1u << n;
+
+    std::vector<qanneal::Sample> annealer_samples;
+    {
+        auto set = std::make_shared<qanneal::SampleSet>(n, roomy);
+        qanneal::Annealer annealer(ham, schedule);
+        annealer.set_seed(3);
+        annealer.set_sample_set(set);
+        auto result = annealer.run(2);
+        assert(set->offered() == steps * 2);
+        assert(total_count(*set) == set->offered());
+        check_samples(*set, ham);
+        assert(set->samples()[0].energy >= result.best_energy);
+        annealer_samples = set->samples();
+    }
+    {
+        auto set = std::make_shared<qanneal::SampleSet>(n, roomy);
+        qanneal::ReplicaAnnealer annealer(ham, schedule, 3);
+        annealer.set_seed(4);
+        annealer.set_sample_set(set);
+        annealer.run(1);
+        assert(set->offered() == steps * 3);
+        assert(total_count(*set) == set->offered());
+        check_samples(*set, ham);
+    }
+    {
+        auto set = std::make_shared<qanneal::SampleSet>(n, roomy);
+        qanneal::ParallelTemperingAnnealer annealer(ham, {0.3, 1.0, 2.5});
+        annealer.set_seed(5);
+        annealer.set_sample_set(set);
+        annealer.run(1, 10);
+        assert(set->offered() == 3 * 10);
+        assert(total_count(*set) == set->offered());
+        check_samples(*set, ham);
+    }
+    {
+        auto set = std::make_shared<qanneal::SampleSet>(n, roomy);
+        qanneal::PopulationAnnealer annealer(ham, schedule, 6);
+        annealer.set_seed(6);
+        annealer.set_sample_set(set);
+        annealer.run(1);
+        assert(set->offered() == steps * 6);
+        assert(total_count(*set) == set->offered());
+        check_samples(*set, ham);
+    }
+    {
+        auto set = std::make_shared<qanneal::SampleSet>(n, roomy);
+        auto sqa_schedule = qanneal::SQASchedule::from_vectors(std::vector<double>(steps, 2.0),
+                                                               std::vector<double>(steps, 0.5));
+        qanneal::SQAAnnealer annealer(ham, sqa_schedule, 4, 2);
+        annealer.set_seed(7);
+        annealer.set_sample_set(set);
+        annealer.run(1, 1);
+        assert(set->offered() == steps * 4 * 2);
+        assert(total_count(*set) == set->offered());
+        check_samples(*set, ham);
+    }
+    {
+        // The same run into a small set keeps exactly its lowest states.
+        auto set = std::make_shared<qanneal::SampleSet>(n, 4);
+        qanneal::Annealer annealer(ham, schedule);
+        annealer.set_seed(3);
+        annealer.set_sample_set(set);
+        annealer.run(2);
+        assert(set->offered() == steps * 2);
+        const auto kept = set->samples();
+        assert(kept.size() == std::min<std::size_t>(4, annealer_samples.size()));
+        for (std::size_t k = 0; k < kept.size(); ++k) {
+            assert(kept[k].energy == annealer_samples[k].energy);
+            assert(kept[k].state.spins == annealer_samples[k].state.spins);
+        }
+
+        bool threw = false;
+        try {
+            annealer.set_sample_set(std::make_shared<qanneal::SampleSet>(n + 1, 4));
+            annealer.run(1);
+        } catch (const std::invalid_argument &) {
+            threw = true;
+        }
+        assert(threw);
+    }
+
+    return 0;
+}
@@ -0,0 +1,81 @@
+#include <cassert>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+
+#include "qanneal/annealer.hpp"
+#include "qanneal/dense_ising.hpp"
+#include "qanneal/schedule.hpp"
+
+int main() {
+    auto geometric = qanneal::AnnealSchedule::geometric(0.1, 10.0, 5);
+    assert(geometric.size() == 5);
+    assert(std::abs(geometric.betas[0] - 0.1) < 1e-12);
+    assert(std::abs(geometric.betas[2] - 1.0) < 1e-12);
+    assert(geometric.betas[4] == 10.0);
+
+    // h = {0.5, 0}, J_01 = 2: the largest flip cost is 2 (0.5 + 2) = 5 and the
+    // smallest non-zero one 2 * 0.5 = 1.
+    qanneal::DenseIsing pair({0.5, 0.0}, {0.0, 2.0, 2.0, 0.0}, 2);
+    const auto range = qanneal::estimate_beta_range(pair);
+    assert(std::abs(range.beta_min - std::log(2.0) / 5.0) < 1e-12);
+    assert(std::abs(range.beta_max - std::log(100.0)) < 1e-12);
+    const auto automatic = qanneal::auto_schedule(pair, 8);
+    assert(automatic.size() == 8);
+    assert(std::abs(automatic.betas.front() - range.beta_min) < 1e-12);
+    assert(automatic.betas.back() == range.beta_max);
+
+    // Step scaling: 0 skips, anything positive runs at least one sweep.
+    qanneal::AnnealSchedule scaled = qanneal::AnnealSchedule::linear(0.1, 1.0, 3);
+    scaled.sweep_scale = {0.0, 0.01, 2.0};
+    assert(scaled.sweeps_at(0, 10) == 0);
+    assert(scaled.sweeps_at(1, 10) == 1);
+    assert(scaled.sweeps_at(2, 10) == 20);
+    scaled.sweep_scale = {1.0};
+    bool threw = false;
+    try {
+        qanneal::DenseIsing tiny({0.1}, {0.0}, 1);
+        qanneal::Annealer bad(tiny, scaled);
+    } catch (const std::invalid_argument &) {
+        threw = true;
+    }
+    assert(threw);
+
+    const std::size_t n = 16;
+    std::mt19937_64 gen(4);
+    std::normal_distribution<double> normal(0.0, 1.0);
+    std::vector<double> h(n, 0.0);
+    std::vector<double> J(n * n, 0.0);
+    for (std::size_t i = 0; i < n; ++i) {
+        for (std::size_t j = i + 1; j < n; ++j) {
+            J[i * n + j] = J[j * n + i] = normal(gen);
+        }
+    }
+    qanneal::DenseIsing glass(h, J, n);
+
+    // The adaptive schedule keeps the sweep budget, skips the frozen tail and
+    // still anneals to low energy.
+    auto base = qanneal::AnnealSchedule::geometric(0.05, 20.0, 40);
+    qanneal::AdaptiveScheduleOptions options;
+    options.pilot_sweeps = 4;
+    options.seed = 9;
+    auto adaptive = qanneal::adaptive_schedule(glass, base, options);
+    assert(adaptive.betas == base.betas);
+    assert(adaptive.sweep_scale.size() == base.size());
+    double total = 0.0;
+    for (double scale : adaptive.sweep_scale) {
+        assert(scale >= 0.0);
+        total += scale;
+    }
+    assert(std::abs(total - static_cast<double>(base.size())) < 1e-9);
+    assert(adaptive.sweep_scale.back() == 0.0);
+
+    qanneal::Annealer annealer(glass, adaptive);
+    annealer.set_seed(2);
+    auto result = annealer.run(10);
+    assert(result.energy_trace.size() == adaptive.size());
+    assert(std::abs(glass.energy(result.best_state) - result.best_energy) < 1e-9);
+    assert(result.sweeps < base.size() * 10 + base.size());
+
+    return 0;
+}
@@ -0,0 +1,157 @@
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <random>
+
+#ifdef _OPENMP
+#include <atomic>
+#include <omp.h>
+#endif
+
+#include "qanneal/annealer.hpp"
+#include "qanneal/dense_ising.hpp"
+#include "qanneal/schedule.hpp"
+#include "qanneal/solver_pool.hpp"
+
+namespace {
+
+std::shared_ptr<qanneal::DenseIsing> random_problem(std::size_t n, std::uint64_t seed) {
+    std::mt19937_64 gen(seed);
+    std::normal_distribution<double> normal(0.0, 1.0);
+    std::vector<double> h(n, 0.0);
+    std::vector<double> J(n * n, 0.0);
+    for (std::size_t i = 0; i < n; ++i) {
+        for (std::size_t j = i + 1; j < n; ++j) {
+            J[i * n + j] = J[j * n + i] = normal(gen);
+        }
+    }
+    return std::make_shared<qanneal::DenseIsing>(h, J, n);
+}
+
+#ifdef _OPENMP
+// Records the largest OpenMP team that evaluated a flip.
+class TeamProbe final : public qanneal::Hamiltonian {
+public:
+    explicit TeamProbe(std::shared_ptr<qanneal::DenseIsing> inner) : inner_(std::move(inner)) {}
+
+    using Hamiltonian::energy;
+    using Hamiltonian::delta_energy;
+
+    std::size_t size() const override { return inner_->size(); }
+    double energy(const int8_t *spins, std::size_t n) const override { return inner_->energy(spins, n); }
+    double delta_energy(const int8_t *spins, std::size_t n, std::size_t flip) const override {
+        int team = omp_get_num_threads();
+        int seen = largest_team.load();
+        while (team > seen && !largest_team.compare_exchange_weak(seen, team)) {
+        }
+        return inner_->delta_energy(spins, n, flip);
+    }
+    qanneal::CouplingGraph coupling_graph() const override { return inner_->coupling_graph(); }
+
+    mutable std::atomic<int> largest_team{0};
+
+private:
+    std::shared_ptr<qanneal::DenseIsing> inner_;
+};
+#endif
+
+} // namespace
+
+int main() {
+    auto ham = random_problem(10, 1);
+    auto schedule = qanneal::AnnealSchedule::linear(0.1, 3.0, 30);
+
+    // Each restart reproduces a standalone run seeded with seed + r.
+    {
+        qanneal::SolverPool pool(4);
+        qanneal::SolverJob job;
+        job.hamiltonian = ham;
+        job.schedule = schedule;
+        job.sweeps = 5;
+        job.restarts = 6;
+        job.seed = 100;
+        auto result = pool.submit(job).get();
+        assert(result.stop_reason == qanneal::StopReason::Completed);
+        assert(result.restart_energies.size() == 6);
+        double best = std::numeric_limits<double>::infinity();
+        for (std::size_t r = 0; r < 6; ++r) {
+            qanneal::Annealer annealer(*ham, schedule);
+            annealer.set_seed(100 + r);
+            const double energy = annealer.run(5).best_energy;
+            assert(result.restart_energies[r] == energy);
+            best = std::min(best, energy);
+        }
+        assert(result.best_energy == best);
+        assert(std::abs(ham->energy(result.best_state) - best) < 1e-9);
+
+        qanneal::SolverJob pt;
+        pt.hamiltonian = ham;
+        pt.engine = qanneal::SolverEngine::ParallelTempering;
+        pt.betas = {0.2, 0.6, 1.5, 3.0};
+        pt.steps = 20;
+        pt.restarts = 2;
+        qanneal::SolverJob population;
+        population.hamiltonian = ham;
+        population.engine = qanneal::SolverEngine::Population;
+        population.schedule = schedule;
+        population.population = 16;
+        auto pt_future = pool.submit(pt);
+        auto population_future = pool.submit(population);
+        assert(pt_future.get().restart_energies.size() == 2);
+        assert(std::isfinite(population_future.get().best_energy));
+    }
+
+#ifdef _OPENMP
+    // Population restarts in the pool keep their OpenMP team to one thread
+    // instead of oversubscribing the pool (ctest runs this with
+    // OMP_NUM_THREADS=4, so an unrestricted team would have four).
+    {
+        auto probe = std::make_shared<TeamProbe>(ham);
+        qanneal::SolverPool pool(2);
+        qanneal::SolverJob population;
+        population.hamiltonian = probe;
+        population.engine = qanneal::SolverEngine::Population;
+        population.schedule = schedule;
+        population.population = 16;
+        population.restarts = 2;
+        pool.submit(population).get();
+        assert(probe->largest_team.load() == 1);
+    }
+#endif
+
+    // A cancelled job skips the restarts that have not started.
+    {
+        qanneal::SolverPool pool(2);
+        qanneal::SolverJob job;
+        job.hamiltonian = ham;
+        job.schedule = schedule;
+        job.restarts = 8;
+        job.stop.cancel.cancel();
+        auto result = pool.submit(job).get();
+        assert(result.stop_reason == qanneal::StopReason::Cancelled);
+        assert(std::isinf(result.best_energy));
+    }
+
+    // With one worker busy, the higher-priority job overtakes earlier work.
+    {
+        auto big = random_problem(64, 2);
+        qanneal::SolverPool pool(1);
+        qanneal::SolverJob slow;
+        slow.hamiltonian = big;
+        slow.schedule = qanneal::AnnealSchedule::linear(0.1, 3.0, 200);
+        slow.sweeps = 20;
+        auto first = pool.submit(slow);
+        auto low = pool.submit(slow);
+        qanneal::SolverJob urgent = slow;
+        urgent.priority = 10;
+        auto high = pool.submit(urgent);
+        high.get();
+        assert(low.wait_for(std::chrono::seconds(0)) != std::future_status::ready);
+        first.get();
+        low.get();
+    }
+
+    return 0;
+}
@@ -0,0 +1,88 @@
+#include <cassert>
+#include <cmath>
+
+#include "qanneal/annealer.hpp"
+#include "qanneal/dense_ising.hpp"
+#include "qanneal/parallel_tempering.hpp"
+#include "qanneal/population_annealer.hpp"
+#include "qanneal/replica_annealer.hpp"
+#include "qanneal/schedule.hpp"
+#include "qanneal/sqa_annealer.hpp"
+#include "qanneal/stop_criteria.hpp"
+
+int main() {
+    const std::size_t n = 4;
+    std::vector<double> h = {0.1, -0.2, 0.0, 0.3};
+    std::vector<double> J(n * n, 0.0);
+    J[0 * n + 1] = J[1 * n + 0] = 0.5;
+    J[2 * n + 3] = J[3 * n + 2] = -0.4;
+    qanneal::DenseIsing ham(h, J, n);
+    const double ground = -1.5;
+
+    auto schedule = qanneal::AnnealSchedule::linear(0.1, 3.0, 50);
+
+    // Target energy: the known optimum is reached long before the schedule ends.
+    qanneal::StopCriteria target;
+    target.target_energy = ground + 1e-9;
+    qanneal::Annealer annealer(ham, schedule);
+    annealer.set_seed(1);
+    annealer.set_stop_criteria(target);
+    auto result = annealer.run(100);
+    assert(result.stop_reason == qanneal::StopReason::TargetEnergy);
+    assert(std::abs(result.best_energy - ground) < 1e-9);
+    assert(result.sweeps < 50 * 100);
+    assert(result.energy_trace.size() * 100 >= result.sweeps);
+
+    // Without criteria the whole schedule runs.
+    qanneal::Annealer full(ham, schedule);
+    full.set_seed(1);
+    auto full_result = full.run(2);
+    assert(full_result.stop_reason == qanneal::StopReason::Completed);
+    assert(full_result.sweeps == 100);
+    assert(full_result.energy_trace.size() == schedule.size());
+
+    // A cancelled token stops every engine after its first sweep.
+    qanneal::StopCriteria cancelled;
+    cancelled.cancel.cancel();
+
+    qanneal::ReplicaAnnealer replicas(ham, schedule, 3);
+    replicas.set_stop_criteria(cancelled);
+    auto multi = replicas.run(10);
+    assert(multi.stop_reason == qanneal::StopReason::Cancelled);
+    assert(multi.sweeps == 1);
+    assert(multi.average_energy_trace.size() == 1);
+
+    qanneal::ParallelTemperingAnnealer pt(ham, {0.5, 1.0});
+    pt.set_stop_criteria(cancelled);
+    auto pt_result = pt.run(10, 20);
+    assert(pt_result.stop_reason == qanneal::StopReason::Cancelled);
+    assert(pt_result.sweeps == 1);
+    assert(std::abs(ham.energy(pt_result.best_state) - pt_result.best_energy) < 1e-12);
+
+    auto sqa_schedule = qanneal::SQASchedule::from_vectors({0.5, 1.0, 2.0}, {2.0, 1.0, 0.1});
+    qanneal::SQAAnnealer sqa(ham, sqa_schedule, 4);
+    sqa.set_stop_criteria(cancelled);
+    auto sqa_result = sqa.run(5, 1);
+    assert(sqa_result.stop_reason == qanneal::StopReason::Cancelled);
+    assert(sqa_result.energy_trace.size() == 1);
+
+    // Stagnation: a frozen chain stops improving.
+    qanneal::StopCriteria stagnation;
+    stagnation.stagnation_sweeps = 20;
+    qanneal::PopulationAnnealer population(ham, qanneal::AnnealSchedule::linear(5.0, 5.0, 100), 2);
+    population.set_stop_criteria(stagnation);
+    auto pop_result = population.run(5);
+    assert(pop_result.stop_reason == qanneal::StopReason::Stagnation);
+    assert(pop_result.average_energy_trace.size() < 100);
+
+    // Time budget.
+    qanneal::StopCriteria budget;
+    budget.time_limit = 1e-9;
+    qanneal::Annealer timed(ham, schedule);
+    timed.set_stop_criteria(budget);
+    auto timed_result = timed.run(100);
+    assert(timed_result.stop_reason == qanneal::StopReason::TimeLimit);
+    assert(timed_result.sweeps == 1);
+
+    return 0;
+}
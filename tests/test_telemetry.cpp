@@ -0,0 +1,94 @@
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "qanneal/annealer.hpp"
+#include "qanneal/dense_ising.hpp"
+#include "qanneal/metrics.hpp"
+#include "qanneal/schedule.hpp"
+#include "qanneal/sqa_annealer.hpp"
+#include "qanneal/telemetry_observer.hpp"
+
+int main() {
+    const std::size_t n = 10;
+    std::vector<double> h(n, 0.05);
+    std::vector<double> J(n * n, 0.0);
+    for (std::size_t i = 0; i < n; ++i) {
+        const std::size_t j = (i + 1) % n;
+        J[i * n + j] = J[j * n + i] = (i % 3 == 0) ? 0.8 : -0.6;
+    }
+    qanneal::DenseIsing ham(h, J, n);
+    const std::string path = "qanneal_test_telemetry.bin";
+
+    // Every third step is kept; with a roomy ring nothing is dropped and the
+    // records match the result's own traces.
+    auto schedule = qanneal::AnnealSchedule::linear(0.1, 3.0, 30);
+    qanneal::TelemetryOptions options;
+    options.path = path;
+    options.decimation = 3;
+    options.capacity = 16;
+    options.store_spins = true;
+    {
+        qanneal::TelemetryObserver telemetry(options);
+        qanneal::Annealer annealer(ham, schedule);
+        annealer.set_seed(5);
+        auto result = annealer.run(4, &telemetry);
+        telemetry.close();
+        assert(telemetry.written() + telemetry.dropped() == 10);
+        assert(telemetry.dropped() == 0);
+
+        const auto trace = qanneal::read_telemetry(path);
+        assert(trace.size() == 10);
+        assert(trace.snapshot_spins == n);
+        assert(trace.has_spins);
+        for (std::size_t k = 0; k < trace.size(); ++k) {
+            const std::size_t step = trace.steps[k];
+            assert(step == 3 * k);
+            assert(trace.betas[k] == schedule.betas[step]);
+            assert(std::isnan(trace.gammas[k]));
+            assert(trace.energies[k] == result.energy_trace[step]);
+            const int8_t *spins = trace.spins.data() + k * n;
+            assert(std::abs(qanneal::magnetization(spins, n) - trace.magnetizations[k]) < 1e-12);
+            assert(std::abs(ham.energy(spins, n) - trace.energies[k]) < 1e-9);
+        }
+        // Records after close() are ignored.
+        telemetry.record(99, 1.0, 0.0, result.best_state);
+        assert(telemetry.written() == 10);
+    }
+
+    // SQA snapshots cover every replica and slice; a one-slot ring may drop
+    // snapshots but never blocks the run.
+    const std::size_t steps = 12;
+    std::vector<double> betas(steps, 2.0);
+    std::vector<double> gammas(steps);
+    for (std::size_t k = 0; k < steps; ++k) {
+        gammas[k] = 2.0 - 0.15 * static_cast<double>(k);
+    }
+    auto sqa_schedule = qanneal::SQASchedule::from_vectors(betas, gammas);
+    options.decimation = 1;
+    options.capacity = 1;
+    options.store_spins = false;
+    qanneal::TelemetryObserver sqa_telemetry(options);
+    qanneal::SQAAnnealer sqa(ham, sqa_schedule, 4, 2);
+    sqa.set_seed(6);
+    auto sqa_result = sqa.run(2, 1, &sqa_telemetry);
+    sqa_telemetry.close();
+    assert(sqa_telemetry.written() + sqa_telemetry.dropped() == steps);
+    assert(sqa_telemetry.written() >= 1);
+
+    const auto sqa_trace = qanneal::read_telemetry(path);
+    assert(sqa_trace.snapshot_spins == 2 * 4 * n);
+    assert(!sqa_trace.has_spins);
+    assert(sqa_trace.size() == sqa_telemetry.written());
+    for (std::size_t k = 0; k < sqa_trace.size(); ++k) {
+        const std::size_t step = sqa_trace.steps[k];
+        assert(sqa_trace.gammas[k] == gammas[step]);
+        assert(sqa_trace.energies[k] == sqa_result.energy_trace[step]);
+        assert(std::abs(sqa_trace.magnetizations[k]) <= 1.0);
+    }
+
+    std::remove(path.c_str());
+    return 0;
+}